@@ -0,0 +1,121 @@
+#include <codeowners/codegen.hpp>
+#include <codeowners/errors.hpp>
+#include <codeowners/parser.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+namespace po = boost::program_options;
+
+constexpr const char* PROGRAM_NAME = "codeowners-codegen";
+
+struct codegen_app_options
+{
+    fs::path codeowners_file;
+    fs::path output_file;
+    co::codegen_options codegen;
+};
+
+std::ostream& print_help(std::ostream& os, const po::options_description& opts_desc)
+{
+    os << "USAGE:\n\t" << PROGRAM_NAME << " [OPTIONS] CODEOWNERS\n\n"
+       << "Write a C++ header encoding the rules of a CODEOWNERS file as constexpr tables,\n"
+       << "with a `find` function that uses matchers specialized for each rule's pattern.\n\n";
+    os << opts_desc << '\n';
+    os << "EXAMPLE:\n\t" << PROGRAM_NAME
+       << " --namespace=project::owners --output=owners.hpp .github/CODEOWNERS\n";
+    return os;
+}
+
+codegen_app_options parse(int argc, const char* argv[])
+{
+    codegen_app_options options;
+
+    po::options_description visible_desc("Options");
+    visible_desc.add_options()("help", "Print help message")(
+        "output", po::value<fs::path>(&options.output_file),
+        "Output header file (default: standard output)")(
+        "namespace",
+        po::value<std::string>(&options.codegen.namespace_name)
+            ->default_value(options.codegen.namespace_name),
+        "Namespace of the generated tables and functions");
+
+    po::options_description opts_desc;
+    opts_desc.add(visible_desc)
+        .add_options()("codeowners-file", po::value<fs::path>(&options.codeowners_file),
+                       "CODEOWNERS file");
+
+    po::positional_options_description pos_opts_desc;
+    pos_opts_desc.add("codeowners-file", 1);
+
+    auto parser = po::command_line_parser(argc, argv).options(opts_desc).positional(pos_opts_desc);
+
+    po::variables_map vm;
+    try
+    {
+        po::store(parser.run(), vm);
+        po::notify(vm);
+    }
+    catch (const po::error& err)
+    {
+        std::cerr << PROGRAM_NAME << ": " << err.what() << '\n';
+        print_help(std::cout, visible_desc) << std::flush;
+        std::exit(EXIT_FAILURE);
+    }
+
+    if (vm.count("help"))
+    {
+        print_help(std::cout, visible_desc) << std::flush;
+        std::exit(EXIT_SUCCESS);
+    }
+    if (options.codeowners_file.empty())
+    {
+        std::cerr << PROGRAM_NAME << ": a CODEOWNERS file is required\n";
+        print_help(std::cout, visible_desc) << std::flush;
+        std::exit(EXIT_FAILURE);
+    }
+
+    options.codegen.source_name = options.codeowners_file.filename().string();
+    return options;
+}
+
+int main(int argc, const char* argv[])
+{
+    const codegen_app_options options = parse(argc, argv);
+
+    try
+    {
+        const auto rules = co::parse(options.codeowners_file);
+        if (options.output_file.empty())
+        {
+            co::write_static_ruleset(std::cout, rules, options.codegen);
+            std::cout << std::flush;
+            return EXIT_SUCCESS;
+        }
+        // Write to a temporary file first, so that a failure leaves no partial header.
+        const fs::path temporary = options.output_file.string() + ".tmp";
+        {
+            std::ofstream os{temporary.string()};
+            co::write_static_ruleset(os, rules, options.codegen);
+            if (!os.flush())
+            {
+                throw co::error{"Cannot write " + temporary.string()};
+            }
+        }
+        fs::rename(temporary, options.output_file);
+    }
+    catch (const co::error& err)
+    {
+        std::cerr << PROGRAM_NAME << ": " << err.what() << '\n';
+        return EXIT_FAILURE;
+    }
+    catch (const fs::filesystem_error& err)
+    {
+        std::cerr << PROGRAM_NAME << ": " << err.what() << '\n';
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,140 @@
+#include <codeowners/errors.hpp>
+#include <codeowners/generator.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <cstdlib>
+#include <iostream>
+
+namespace po = boost::program_options;
+
+constexpr const char* PROGRAM_NAME = "generate-repo";
+
+struct generate_repo_options
+{
+    co::repository_spec repo_spec;
+    co::codeowners_spec codeowners_spec;
+    bool codeowners_only;
+    fs::path output_dir;
+};
+
+std::ostream& print_help(std::ostream& os, const po::options_description& opts_desc)
+{
+    os << "USAGE:\n\t" << PROGRAM_NAME << " [OPTIONS] DIRECTORY\n"
+       << "\t" << PROGRAM_NAME << " [OPTIONS] --codeowners-only\n\n"
+       << "Create a git repository with synthetic files and a CODEOWNERS file in DIRECTORY.\n"
+       << "Equal options, including the seed, produce identical repositories.\n\n";
+    os << opts_desc << '\n';
+    os << "EXAMPLE:\n\t" << PROGRAM_NAME << " --files 1000000 --rules 10000 /tmp/large-repo"
+       << '\n';
+    return os;
+}
+
+generate_repo_options parse(int argc, const char* argv[])
+{
+    generate_repo_options options;
+    auto& repo_spec = options.repo_spec;
+    auto& codeowners_spec = options.codeowners_spec;
+    std::uint64_t seed;
+
+    po::options_description visible_desc("Options");
+    visible_desc.add_options()("help", "Print help message")(
+        "seed", po::value<std::uint64_t>(&seed)->default_value(0), "Random seed")(
+        "files", po::value<std::size_t>(&repo_spec.file_count)->default_value(1000),
+        "Number of files")(
+        "depth", po::value<std::size_t>(&repo_spec.depth)->default_value(4),
+        "Maximum directory depth of files")(
+        "fan-out", po::value<std::size_t>(&repo_spec.fan_out)->default_value(8),
+        "Maximum number of subdirectories per directory")(
+        "submodules", po::value<std::size_t>(&repo_spec.submodule_count)->default_value(0),
+        "Number of submodules")(
+        "submodule-files",
+        po::value<std::size_t>(&repo_spec.submodule_file_count)->default_value(100),
+        "Number of files per submodule")(
+        "max-file-size", po::value<std::size_t>(&repo_spec.max_file_size)->default_value(0),
+        "Maximum file size in bytes")(
+        "rules", po::value<std::size_t>(&codeowners_spec.rule_count)->default_value(100),
+        "Number of CODEOWNERS rules")(
+        "owners", po::value<std::size_t>(&codeowners_spec.owner_count)->default_value(50),
+        "Number of distinct owners")(
+        "codeowners-only", po::bool_switch(&options.codeowners_only)->default_value(false),
+        "Print the CODEOWNERS file, without creating a repository");
+
+    po::options_description opts_desc;
+    opts_desc.add(visible_desc)
+        .add_options()("output-dir", po::value<fs::path>(&options.output_dir),
+                       "Output directory");
+
+    po::positional_options_description pos_opts_desc;
+    pos_opts_desc.add("output-dir", 1);
+
+    auto parser = po::command_line_parser(argc, argv).options(opts_desc).positional(pos_opts_desc);
+
+    po::variables_map vm;
+    try
+    {
+        po::store(parser.run(), vm);
+        po::notify(vm);
+    }
+    catch (const po::error& err)
+    {
+        std::cerr << PROGRAM_NAME << ": " << err.what() << '\n';
+        print_help(std::cout, visible_desc) << std::flush;
+        std::exit(EXIT_FAILURE);
+    }
+
+    if (vm.count("help"))
+    {
+        print_help(std::cout, visible_desc) << std::flush;
+        std::exit(EXIT_SUCCESS);
+    }
+    if (!options.codeowners_only && options.output_dir.empty())
+    {
+        std::cerr << PROGRAM_NAME << ": an output directory is required\n";
+        print_help(std::cout, visible_desc) << std::flush;
+        std::exit(EXIT_FAILURE);
+    }
+
+    repo_spec.seed = seed;
+    codeowners_spec.seed = seed;
+    return options;
+}
+
+int main(int argc, const char* argv[])
+{
+    const generate_repo_options options = parse(argc, argv);
+
+    if (options.codeowners_only)
+    {
+        co::write_codeowners(std::cout, co::generate_rules(options.codeowners_spec,
+                                                           co::generate_paths(options.repo_spec)));
+        return EXIT_SUCCESS;
+    }
+
+    try
+    {
+        if (fs::exists(options.output_dir / ".git"))
+        {
+            std::cerr << PROGRAM_NAME << ": " << options.output_dir
+                      << " already contains a repository\n";
+            return EXIT_FAILURE;
+        }
+
+        const auto generated = co::generate_repository(options.output_dir, options.repo_spec,
+                                                       options.codeowners_spec);
+        std::cout << "Generated " << generated.paths.size() << " files, "
+                  << generated.submodule_paths.size() << " submodules and "
+                  << generated.rules.size() << " rules in " << options.output_dir << '\n';
+    }
+    catch (const co::error& err)
+    {
+        std::cerr << PROGRAM_NAME << ": " << err.what() << '\n';
+        return EXIT_FAILURE;
+    }
+    catch (const fs::filesystem_error& err)
+    {
+        std::cerr << PROGRAM_NAME << ": " << err.what() << '\n';
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -1,17 +1,30 @@
 #include <codeowners/codeowners.hpp>
+#include <codeowners/errors.hpp>
 #include <codeowners/filesystem.hpp>
+#include <codeowners/instrumentation.hpp>
+#include <codeowners/list_owners.hpp>
+#include <codeowners/output.hpp>
+#include <codeowners/ownership_diff.hpp>
+#include <codeowners/ownership_index.hpp>
 #include <codeowners/parser.hpp>
-#include <codeowners/recursive_filter_iterator.hpp>
 #include <codeowners/repository.hpp>
 #include <codeowners/ruleset.hpp>
+#include <codeowners/statistics.hpp>
+#include <codeowners/trace.hpp>
 
 #include <boost/program_options.hpp>
 #include <range/v3/view/concat.hpp>
 #include <range/v3/view/single.hpp>
 
 #include <codeowners/parser.hpp>
+#include <algorithm>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <sstream>
+
+#include <unistd.h>
 
 namespace po = boost::program_options;
 
@@ -22,6 +35,19 @@ struct list_owners_options
     bool debug;
     boost::optional<fs::path> repo_dir;
     bool include_ignored;
+    std::string format_name;
+    co::output_format format;
+    bool stats;
+    bool stats_bytes;
+    bool stats_internal;
+    bool profile_rules;
+    bool shadowed_rules;
+    bool rule_coverage;
+    std::vector<std::string> owned_by;
+    boost::optional<std::string> overlapping;
+    boost::optional<std::string> changed_from;
+    boost::optional<std::string> changed_to;
+    boost::optional<fs::path> trace_file;
     std::vector<fs::path> paths;
 };
 
@@ -49,7 +75,8 @@ std::ostream& print_help(std::ostream& os, const po::options_description& opts_d
         os << " " << (opt_ptr->long_name() == "help" ? "" : arg_usage_string(*opt_ptr));
     }
     os << " [PATHS]\n\n"
-       << "If no paths are given, implicit path '.' is used.\n\n";
+       << "If no paths are given, implicit path '.' is used.  Files are listed, recursively, "
+          "but directories are not.\n\n";
     os << opts_desc << '\n';
     os << "EXAMPLE:\n\t" << PROGRAM_NAME << " --recurse include/ src/ README.md" << '\n';
     return os;
@@ -65,7 +92,35 @@ list_owners_options parse(int argc, const char* argv[])
         "Enable debug logging")("repo", po::value<boost::optional<fs::path>>(&options.repo_dir),
                                 "Repository directory (default: search from current directory)")(
         "include-ignored", po::bool_switch(&options.include_ignored)->default_value(false),
-        "Include files ignored by git");
+        "Include files ignored by git")(
+        "format", po::value<std::string>(&options.format_name)->default_value("text"),
+        "Output format: text, tsv, jsonl or nul")(
+        "stats", po::bool_switch(&options.stats)->default_value(false),
+        "Print file counts per owner, instead of listing files")(
+        "stats-bytes", po::bool_switch(&options.stats_bytes)->default_value(false),
+        "Like --stats, but also print the total size of files per owner, which needs a stat "
+        "call per file")(
+        "stats-internal", po::bool_switch(&options.stats_internal)->default_value(false),
+        "Print phase timings and internal counters to stderr on exit")(
+        "profile-rules", po::bool_switch(&options.profile_rules)->default_value(false),
+        "Print evaluation counts, win counts and matching time per rule to stderr")(
+        "shadowed-rules", po::bool_switch(&options.shadowed_rules)->default_value(false),
+        "Print rules that never apply, because a later rule overrides them, to stderr")(
+        "rule-coverage", po::bool_switch(&options.rule_coverage)->default_value(false),
+        "Print the number of files that each rule matches, and the number to which it applies, "
+        "instead of listing files")(
+        "owned-by", po::value<std::vector<std::string>>(&options.owned_by)->composing(),
+        "List only the files owned by an owner, such as @org/team; may be repeated")(
+        "overlapping", po::value<boost::optional<std::string>>(&options.overlapping),
+        "Print the rules that match some path that a pattern also matches, and their owners, "
+        "instead of listing files")(
+        "changed-from", po::value<boost::optional<std::string>>(&options.changed_from),
+        "Print the files whose owners differ between an old CODEOWNERS file, given as a path "
+        "or a revision such as HEAD~1:.github/CODEOWNERS, and the current one")(
+        "changed-to", po::value<boost::optional<std::string>>(&options.changed_to),
+        "With --changed-from, the new CODEOWNERS file, as a path or a revision")(
+        "trace", po::value<boost::optional<fs::path>>(&options.trace_file),
+        "Write a Chrome trace of phases, directories and output flushes to a file on exit");
 
     po::options_description opts_desc;
     opts_desc.add(visible_desc)
@@ -94,16 +149,113 @@ list_owners_options parse(int argc, const char* argv[])
         print_help(std::cout, visible_desc) << std::flush;
         std::exit(EXIT_SUCCESS);
     }
+    options.stats = options.stats || options.stats_bytes;
+    if (options.stats && !options.owned_by.empty())
+    {
+        std::cerr << PROGRAM_NAME << ": --stats cannot be combined with --owned-by\n";
+        print_help(std::cout, visible_desc) << std::flush;
+        std::exit(EXIT_FAILURE);
+    }
+
+    try
+    {
+        options.format = co::parse_output_format(options.format_name);
+    }
+    catch (const co::error& err)
+    {
+        std::cerr << PROGRAM_NAME << ": " << err.what() << '\n';
+        print_help(std::cout, visible_desc) << std::flush;
+        std::exit(EXIT_FAILURE);
+    }
 
     return options;
 }
 
+/// Print a warning to standard error for each rule of `rules` that is ignored, because its
+/// pattern cannot be compiled.
+void warn_skipped_rules(const co::ruleset& rules)
+{
+    for (const co::ruleset::skipped_rule& skipped : rules.skipped_rules())
+    {
+        const co::annotated_rule rule = rules.rule(skipped.id);
+        std::cerr << PROGRAM_NAME << ": " << rule.source.filename << ':' << rule.source.line
+                  << ": ignoring rule: " << skipped.reason << '\n';
+    }
+}
+
+/// Parse the CODEOWNERS file at path `spec`, or, if there is no such file, in the revision
+/// `spec` of the repository.
+std::vector<co::annotated_rule> parse_version(const co::repository& repo, const std::string& spec)
+{
+    if (fs::exists(spec))
+    {
+        return co::parse(fs::path{spec});
+    }
+    std::istringstream is{repo.read_blob(spec)};
+    return co::parse(is, spec);
+}
+
+/// Prints timings and counters on destruction, if enabled.
+struct internal_stats_reporter
+{
+    explicit internal_stats_reporter(bool enable)
+        : enabled{enable && co::instrumentation::enable()}
+    {
+        if (enable && !enabled)
+        {
+            std::cerr << PROGRAM_NAME << ": instrumentation is not compiled in\n";
+        }
+    }
+
+    ~internal_stats_reporter()
+    {
+        if (enabled)
+        {
+            co::instrumentation::report(std::cerr) << std::flush;
+        }
+    }
+
+    bool enabled;
+};
+
+/// Writes recorded trace events to a file on destruction, if enabled.
+struct trace_writer
+{
+    explicit trace_writer(boost::optional<fs::path> file) : path{std::move(file)}
+    {
+        if (path && !co::tracer::enable())
+        {
+            std::cerr << PROGRAM_NAME << ": tracing is not compiled in\n";
+            path = boost::none;
+        }
+    }
+
+    ~trace_writer()
+    {
+        if (!path)
+        {
+            return;
+        }
+        co::tracer::enable(false);
+        std::ofstream ofs{path->string()};
+        co::tracer::write_chrome_json(ofs) << std::flush;
+        if (!ofs)
+        {
+            std::cerr << PROGRAM_NAME << ": error writing trace to " << *path << '\n';
+        }
+    }
+
+    boost::optional<fs::path> path;
+};
+
 int main(int argc, const char* argv[])
 {
     fs::path current_path = fs::current_path();
     std::ostream& os = std::cout;
 
     list_owners_options options = parse(argc, argv);
+    const internal_stats_reporter stats_reporter{options.stats_internal};
+    const trace_writer trace{options.trace_file};
     fs::path discovery_start = options.repo_dir.value_or(current_path);
 
     const std::optional<co::repository> maybe_repo = co::repository::try_discover(discovery_start);
@@ -125,33 +277,178 @@ int main(int argc, const char* argv[])
     }
     assert(maybe_co_path);
 
-    const co::ruleset ruleset{co::parse(*maybe_co_path)};
-
-    // TODO: parse rules and perform matching of paths.
-
     std::vector<fs::path> paths
         = options.paths.empty() ? std::vector<fs::path>{{"."}} : options.paths;
     paths = co::distinct_prefixed_paths(std::move(paths));
     std::vector<fs::path> to_skip = nonwork_directories(repo);
 
-    for (const auto& start_path : paths)
+    if (options.changed_from)
     {
-        for (const auto& path : co::make_filtered_file_range(start_path, to_skip))
+        try
         {
-            const fs::path rel_path = fs::relative(path, work_dir);
-            os << fs::relative(path, current_path).c_str() << ":    ";
+            const co::ruleset old_rules{parse_version(repo, *options.changed_from)};
+            const co::ruleset new_rules{options.changed_to
+                                            ? parse_version(repo, *options.changed_to)
+                                            : co::parse(*maybe_co_path)};
+            warn_skipped_rules(old_rules);
+            warn_skipped_rules(new_rules);
+            co::ownership_diff diff{old_rules, new_rules};
+            std::vector<co::ownership_change> changes;
+            for (const auto& start_path : paths)
+            {
+                auto found = co::find_ownership_changes(diff, work_dir, start_path, to_skip);
+                std::move(found.begin(), found.end(), std::back_inserter(changes));
+            }
+            co::write_ownership_changes(os, diff, changes) << std::flush;
+        }
+        catch (const co::error& err)
+        {
+            std::cerr << PROGRAM_NAME << ": " << err.what() << '\n';
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    co::ruleset ruleset{co::parse(*maybe_co_path)};
+    warn_skipped_rules(ruleset);
+    if (options.profile_rules && !ruleset.enable_profiling())
+    {
+        std::cerr << PROGRAM_NAME << ": rule profiling is not compiled in\n";
+    }
+    if (options.shadowed_rules)
+    {
+        co::write_shadowed_rules(std::cerr, ruleset) << std::flush;
+    }
+    if (options.overlapping)
+    {
+        try
+        {
+            co::write_overlapping_rules(os, ruleset, co::pattern{*options.overlapping})
+                << std::flush;
+        }
+        catch (const co::error& err)
+        {
+            std::cerr << PROGRAM_NAME << ": " << err.what() << '\n';
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (options.rule_coverage)
+    {
+        // Every matching rule is found in the same pass over the rules as the owning rule.
+        co::ruleset::cursor cursor{ruleset, co::ruleset::match_mode::ALL};
+        co::rule_coverage coverage{ruleset};
+        const auto visit = [&](const fs::directory_entry&,
+                               const std::vector<co::ruleset::rule_id>& matching,
+                               std::optional<co::ruleset::rule_id> rule_id) {
+            coverage.add(matching, rule_id);
+        };
+        for (const auto& start_path : paths)
+        {
+            co::for_each_matched_file(cursor, work_dir, start_path, to_skip, visit);
+        }
+        os << coverage << std::flush;
+        return EXIT_SUCCESS;
+    }
+
+    co::output_writer writer{STDOUT_FILENO, options.format};
+    co::ownership_statistics stats{ruleset, options.stats_bytes};
+    // With `--owned-by`, only the files of rules naming a requested owner are visited, and
+    // they are indexed by rule, to be listed once all are found.  Directories owned
+    // throughout by other rules are not traversed.
+    co::ownership_index owned_files{ruleset};
+    std::vector<bool> requested_rules(ruleset.size());
+    for (co::ruleset::rule_id id = 0; id < ruleset.size(); ++id)
+    {
+        for (const std::string_view name : ruleset.owner_names(id))
+        {
+            if (std::find(options.owned_by.begin(), options.owned_by.end(), name)
+                != options.owned_by.end())
+            {
+                requested_rules[id] = true;
+            }
+        }
+    }
+    const co::rule_filter wanted = options.owned_by.empty()
+        ? co::rule_filter{}
+        : [&](std::optional<co::ruleset::rule_id> id) { return id && requested_rules[*id]; };
+    // Files are visited depth-first, so consecutive paths share most of their directories.
+    co::ruleset::cursor cursor{ruleset};
+    // Paths are written relative to the current directory.  When it is the work directory,
+    // they are those passed to the visitor; otherwise each is formed from the file's path.
+    const bool in_work_dir = fs::relative(current_path, work_dir) == ".";
+    std::optional<co::relative_path_builder> output_path;
+    const auto relative_to_current = [&](const fs::directory_entry& entry,
+                                         std::string_view relative_path) -> std::string_view {
+        return in_work_dir ? relative_path
+                           : std::string_view{(*output_path)(entry.path()).native()};
+    };
 
-            const auto matched_rule = ruleset.apply(rel_path);
-            if (matched_rule)
+    const auto visit = [&](const fs::directory_entry& entry, std::string_view relative_path,
+                           std::optional<co::ruleset::rule_id> rule_id) {
+        const fs::path& path = entry.path();
+        if (options.stats)
+        {
+            // The status held by the entry does not include the size, so finding it costs
+            // a stat call, which is only made if sizes are wanted.
+            std::uint64_t size = 0;
+            if (stats.with_bytes())
+            {
+                boost::system::error_code ec;
+                const auto file_size = fs::file_size(path, ec);
+                size = ec ? 0 : file_size;
+            }
+            stats.add(rule_id, size);
+            return;
+        }
+        if (!options.owned_by.empty())
+        {
+            owned_files.add(relative_to_current(entry, relative_path), rule_id);
+            return;
+        }
+        writer.write(relative_to_current(entry, relative_path),
+                     rule_id ? ruleset.owner_names(*rule_id) : co::array_view<std::string_view>{});
+    };
+    // Records are written as they are found, so output errors may arise during traversal.
+    try
+    {
+        for (const auto& start_path : paths)
+        {
+            if (!in_work_dir)
             {
-                os << matched_rule->rule.owners.front();
+                output_path.emplace(current_path, start_path);
             }
-            else
+            co::for_each_owned_file(cursor, work_dir, start_path, to_skip, visit, wanted);
+        }
+
+        if (options.stats)
+        {
+            os << stats << std::flush;
+        }
+        for (const std::string& owner : options.owned_by)
+        {
+            if (owned_files.files_owned_by(owner).empty())
             {
-                os << "[NO_OWNER]";
+                std::cerr << PROGRAM_NAME << ": no files owned by " << owner << '\n';
             }
-            os << '\n';
         }
+        // Each file is listed once, even if several of the requested owners own it.
+        const auto files = owned_files.files_owned_by_any(options.owned_by);
+        for (const co::ownership_index::path_id id : files)
+        {
+            writer.write(owned_files.path(id), ruleset.owner_names(*owned_files.rule(id)));
+        }
+        writer.flush();
+    }
+    catch (const co::error& err)
+    {
+        std::cerr << PROGRAM_NAME << ": " << err.what() << '\n';
+        return EXIT_FAILURE;
+    }
+    if (options.profile_rules)
+    {
+        co::write_rule_profile(std::cerr, ruleset, ruleset.profile()) << std::flush;
     }
 
     return EXIT_SUCCESS;
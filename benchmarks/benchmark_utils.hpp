@@ -0,0 +1,160 @@
+#pragma once
+
+#include "process_counters.hpp"
+
+#include <codeowners/allocation_counter.hpp>
+#include <codeowners/codeowners.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace co
+{
+
+/// Return `count` ownership rules with a mix of extension, anchored directory, trailing
+/// `**`, single-level and unanchored directory patterns, as found in large CODEOWNERS
+/// files.  Directory patterns refer to the directories produced by `make_paths`.
+inline std::vector<annotated_rule> make_rules(std::size_t count)
+{
+    std::vector<annotated_rule> rules;
+    rules.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const std::string n = std::to_string(i);
+        std::string text;
+        switch (i % 5)
+        {
+        case 0:
+            text = "*.ext" + std::to_string(i % 50);
+            break;
+        case 1:
+            text = "/d" + std::to_string(i % 10) + "/d" + std::to_string(i / 10 % 10) + "/";
+            break;
+        case 2:
+            text = "/d" + std::to_string(i % 10) + "/**";
+            break;
+        case 3:
+            text = "d" + std::to_string(i % 7) + "/*";
+            break;
+        default:
+            text = "d" + std::to_string(i % 10) + "/";
+            break;
+        }
+        rules.push_back(annotated_rule{
+            rule_source{"CODEOWNERS", static_cast<std::int32_t>(i + 1)},
+            ownership_rule{pattern{text}, {owner{"@org/team-" + std::to_string(i % 31)}}}});
+    }
+    return rules;
+}
+
+/// Return the text of a CODEOWNERS file with the given rules.
+inline std::string make_codeowners_content(const std::vector<annotated_rule>& rules)
+{
+    std::string content;
+    for (const auto& arule : rules)
+    {
+        content += arule.rule.file_pattern.value();
+        for (const auto& o : arule.rule.owners)
+        {
+            content += "    " + o.value();
+        }
+        content += '\n';
+    }
+    return content;
+}
+
+/// Return `count` relative file paths, in depth-first order, with `depth` directory
+/// components each and a fan-out of 10 directories per level.
+inline std::vector<fs::path> make_paths(std::size_t count, std::size_t depth)
+{
+    std::vector<fs::path> paths;
+    paths.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        fs::path p;
+        std::size_t n = i / 20;
+        for (std::size_t level = 0; level < depth; ++level)
+        {
+            p /= "d" + std::to_string(n % 10);
+            n /= 10;
+        }
+        p /= "file" + std::to_string(i) + ".ext" + std::to_string(i % 60);
+        paths.push_back(std::move(p));
+    }
+    return paths;
+}
+
+/// Number of paths looked up per iteration by lookup benchmarks.
+constexpr std::size_t lookup_path_count = 10000;
+
+/// Report the allocations counted by `scope` over all iterations, per item processed, as
+/// the counters `allocs_per_item` and `bytes_per_item`.  If `max_per_item` is given, the
+/// benchmark fails when there were more allocations per item, which pins the allocation
+/// count of a hot path.
+inline void report_allocations(benchmark::State& state, const allocation_scope& scope,
+                               std::size_t items_per_iteration,
+                               std::optional<double> max_per_item = std::nullopt)
+{
+    const allocation_counts counts = scope.counts();
+    const double items = static_cast<double>(state.iterations() * items_per_iteration);
+    const double allocs_per_item = items > 0 ? counts.allocations / items : 0.0;
+    state.counters["allocs_per_item"] = allocs_per_item;
+    state.counters["bytes_per_item"] = items > 0 ? counts.bytes / items : 0.0;
+    if (max_per_item && allocs_per_item > *max_per_item)
+    {
+        state.SkipWithError(("Allocations per item exceed the limit of "
+                             + std::to_string(*max_per_item))
+                                .c_str());
+    }
+}
+
+/**
+ * Counts hardware events, such as instructions and cache misses, from its construction
+ * until `report()`, if the environment variable `CODEOWNERS_PERF_COUNTERS` is set to 1.
+ * Construct it just before the benchmark loop.  Events that cannot be counted are not
+ * reported; see `hardware_counters`.
+ */
+class hardware_counter_scope
+{
+public:
+    hardware_counter_scope()
+    {
+        const char* enabled = std::getenv("CODEOWNERS_PERF_COUNTERS");
+        if (enabled && std::string{enabled} == "1")
+        {
+            m_counters = std::make_unique<hardware_counters>();
+            m_counters->start();
+        }
+    }
+
+    /// Report the counts per item processed, as counters such as `instructions_per_item`.
+    void report(benchmark::State& state, std::size_t items_per_iteration)
+    {
+        if (!m_counters)
+        {
+            return;
+        }
+        const hardware_counts counts = m_counters->stop();
+        const double items = static_cast<double>(state.iterations() * items_per_iteration);
+        for (std::size_t i = 0; i < counts.values.size(); ++i)
+        {
+            if (counts.values[i] && items > 0)
+            {
+                state.counters[std::string{to_string(static_cast<hardware_event>(i))}
+                               + "_per_item"]
+                    = static_cast<double>(*counts.values[i]) / items;
+            }
+        }
+    }
+
+private:
+    std::unique_ptr<hardware_counters> m_counters;
+};
+
+} // end namespace 'co'
@@ -0,0 +1,78 @@
+#include "benchmark_utils.hpp"
+
+#include <src/compiled_pattern.hpp>
+
+#include <string>
+
+namespace co
+{
+
+namespace
+{
+    /// Return a path of `depth` components, each consisting of `length` copies of 'a'.
+    std::string repeated_path(std::size_t depth, std::size_t length)
+    {
+        std::string result;
+        for (std::size_t i = 0; i < depth; ++i)
+        {
+            result += (i == 0 ? "" : "/") + std::string(length, 'a');
+        }
+        return result;
+    }
+} // end anonymous namespace
+
+/// Adversarial patterns, which do not match, but whose wildcards match almost all of each
+/// component:  a backtracking matcher takes time exponential in the number of `*`
+/// wildcards.  Matching time should grow linearly with the length of the component.
+void BM_compiled_pattern_many_stars(benchmark::State& state)
+{
+    const compiled_pattern pat{pattern{"*a*a*a*a*a*a*a*a*b"}};
+    const std::string path = repeated_path(1, state.range(0));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(pat.matches(path));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_compiled_pattern_many_stars)
+    ->ArgName("length")
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Complexity(benchmark::oN);
+
+/// A `**` segment followed by a many-star segment, against paths of increasing depth.
+/// Matching time should grow linearly with the depth.
+void BM_compiled_pattern_any_dirs_stars(benchmark::State& state)
+{
+    const compiled_pattern pat{pattern{"**/a*a*a*a*b"}};
+    const std::string path = repeated_path(state.range(0), 64);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(pat.matches(path));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_compiled_pattern_any_dirs_stars)
+    ->ArgName("depth")
+    ->RangeMultiplier(4)
+    ->Range(4, 1024)
+    ->Complexity(benchmark::oN);
+
+/// Many `**` segments, each of which may match any number of components.
+void BM_compiled_pattern_repeated_any_dirs(benchmark::State& state)
+{
+    const compiled_pattern pat{pattern{"**/a/**/a/**/a/**/a/**/a/**/b"}};
+    const std::string path = repeated_path(state.range(0), 1);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(pat.matches(path));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_compiled_pattern_repeated_any_dirs)
+    ->ArgName("depth")
+    ->RangeMultiplier(4)
+    ->Range(4, 1024)
+    ->Complexity(benchmark::oN);
+
+} // end namespace 'co'
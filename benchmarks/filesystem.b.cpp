@@ -0,0 +1,93 @@
+#include "benchmark_utils.hpp"
+
+#include <codeowners/filesystem.hpp>
+#include <codeowners/generator.hpp>
+#include <codeowners/index.hpp>
+#include <codeowners/recursive_filter_iterator.hpp>
+#include <codeowners/repository.hpp>
+
+#include <map>
+#include <utility>
+
+namespace co
+{
+
+namespace
+{
+    /// Return a temporary git repository holding `count` files of depth at most `depth`, which
+    /// are added to the index.  Repositories are created once per process, and reused.
+    const temporary_directory_handle& sample_repository(std::size_t count, std::size_t depth)
+    {
+        static std::map<std::pair<std::size_t, std::size_t>, temporary_directory_handle> cache;
+        auto [it, inserted] = cache.try_emplace({count, depth});
+        if (inserted)
+        {
+            repository_spec spec;
+            spec.file_count = count;
+            spec.depth = depth;
+            generate_repository(it->second, spec, codeowners_spec{});
+        }
+        return it->second;
+    }
+
+    void file_and_depth_args(benchmark::internal::Benchmark* b)
+    {
+        b->ArgNames({"files", "depth"})->ArgsProduct({{1000, 10000}, {2, 8}});
+    }
+} // end anonymous namespace
+
+void BM_distinct_prefixed_paths(benchmark::State& state)
+{
+    // Directories of the sample paths, and the paths themselves, which they contain.
+    std::vector<fs::path> paths;
+    for (const auto& p : make_paths(state.range(0), state.range(1)))
+    {
+        paths.push_back(p.parent_path());
+        paths.push_back(p);
+    }
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(distinct_prefixed_paths(paths));
+    }
+    state.SetItemsProcessed(state.iterations() * paths.size());
+}
+BENCHMARK(BM_distinct_prefixed_paths)
+    ->ArgNames({"paths", "depth"})
+    ->ArgsProduct({{100, 1000, 10000}, {2, 8}});
+
+void BM_filtered_file_range(benchmark::State& state)
+{
+    const auto& root = sample_repository(state.range(0), state.range(1));
+    const std::vector<fs::path> to_skip{root / ".git"};
+    std::size_t entries = 0;
+    for (auto _ : state)
+    {
+        for (const auto& entry : make_filtered_file_range(root, to_skip))
+        {
+            benchmark::DoNotOptimize(entry);
+            ++entries;
+        }
+    }
+    state.SetItemsProcessed(entries);
+}
+BENCHMARK(BM_filtered_file_range)->Apply(file_and_depth_args);
+
+void BM_index_iterator(benchmark::State& state)
+{
+    const auto& root = sample_repository(state.range(0), state.range(1));
+    const repository repo = repository::open(root);
+    std::size_t entries = 0;
+    for (auto _ : state)
+    {
+        index idx{repo};
+        for (auto it = idx.begin(); it != idx.end(); ++it)
+        {
+            benchmark::DoNotOptimize(*it);
+            ++entries;
+        }
+    }
+    state.SetItemsProcessed(entries);
+}
+BENCHMARK(BM_index_iterator)->Apply(file_and_depth_args);
+
+} // end namespace 'co'
@@ -0,0 +1,85 @@
+#include "benchmark_utils.hpp"
+
+#include <codeowners/generator.hpp>
+#include <codeowners/ownership_diff.hpp>
+#include <codeowners/ruleset.hpp>
+
+namespace co
+{
+
+namespace
+{
+    /// Paths and rules of a generated repository, and the rules after a typical edit:  one
+    /// rule removed, one added, and the owners of one changed.
+    struct edited_repository
+    {
+        std::vector<fs::path> paths;
+        ruleset old_rules;
+        ruleset new_rules;
+    };
+
+    edited_repository make_edited_repository(std::size_t rule_count)
+    {
+        repository_spec repo_spec;
+        repo_spec.file_count = 100000;
+        codeowners_spec co_spec;
+        co_spec.rule_count = rule_count;
+        auto paths = generate_paths(repo_spec);
+        auto rules = generate_rules(co_spec, paths);
+        auto edited = rules;
+        edited.erase(edited.begin() + rules.size() / 2);
+        edited.insert(edited.begin() + rules.size() / 4, rules[rules.size() / 3]);
+        edited[rules.size() * 3 / 4].rule.owners = {owner{"@new-team"}};
+        return {std::move(paths), ruleset{rules}, ruleset{edited}};
+    }
+} // end anonymous namespace
+
+/// Changes of owners found by matching only the paths that changed rules can match.
+void BM_ownership_diff_compare(benchmark::State& state)
+{
+    const edited_repository repo = make_edited_repository(state.range(0));
+    std::size_t changes = 0;
+    for (auto _ : state)
+    {
+        ownership_diff diff{repo.old_rules, repo.new_rules};
+        changes = diff.compare(repo.paths.begin(), repo.paths.end()).size();
+        state.counters["candidates"] = static_cast<double>(diff.counts().candidates);
+    }
+    state.SetItemsProcessed(state.iterations() * repo.paths.size());
+    state.counters["changes"] = static_cast<double>(changes);
+}
+BENCHMARK(BM_ownership_diff_compare)
+    ->ArgName("rules")
+    ->Arg(100)
+    ->Arg(1000)
+    ->Unit(benchmark::kMillisecond);
+
+/// The same comparison, by matching every path against both versions, for comparison.
+void BM_ownership_diff_full_comparison(benchmark::State& state)
+{
+    const edited_repository repo = make_edited_repository(state.range(0));
+    for (auto _ : state)
+    {
+        ruleset::cursor old_cursor{repo.old_rules};
+        ruleset::cursor new_cursor{repo.new_rules};
+        std::size_t changes = 0;
+        for (const auto& p : repo.paths)
+        {
+            const auto old_rule = old_cursor.find(p);
+            const auto new_rule = new_cursor.find(p);
+            changes += (old_rule ? repo.old_rules.owner_names(*old_rule)
+                                 : array_view<std::string_view>{})
+                != (new_rule ? repo.new_rules.owner_names(*new_rule)
+                             : array_view<std::string_view>{});
+        }
+        benchmark::DoNotOptimize(changes);
+    }
+    state.SetItemsProcessed(state.iterations() * repo.paths.size());
+}
+BENCHMARK(BM_ownership_diff_full_comparison)
+    ->ArgName("rules")
+    ->Arg(100)
+    ->Arg(1000)
+    ->Unit(benchmark::kMillisecond);
+
+} // end namespace 'co'
@@ -0,0 +1,59 @@
+#include "benchmark_utils.hpp"
+
+#include <codeowners/generator.hpp>
+#include <codeowners/ownership_index.hpp>
+#include <codeowners/ruleset.hpp>
+
+namespace co
+{
+
+/// Construction of an index of the paths of a generated repository, in a single pass.
+void BM_ownership_index_construction(benchmark::State& state)
+{
+    repository_spec repo_spec;
+    repo_spec.file_count = state.range(1);
+    codeowners_spec co_spec;
+    co_spec.rule_count = state.range(0);
+    const auto paths = generate_paths(repo_spec);
+    const ruleset rset{generate_rules(co_spec, paths)};
+    for (auto _ : state)
+    {
+        const ownership_index index{rset, paths.begin(), paths.end()};
+        benchmark::DoNotOptimize(index.size());
+    }
+    state.SetItemsProcessed(state.iterations() * paths.size());
+}
+BENCHMARK(BM_ownership_index_construction)
+    ->ArgNames({"rules", "files"})
+    ->ArgsProduct({{100, 1000}, {100000}})
+    ->Unit(benchmark::kMillisecond);
+
+/// Queries for the files of every owner, with an index built once.  Items are the files
+/// returned, summed over owners.
+void BM_ownership_index_files_owned_by(benchmark::State& state)
+{
+    repository_spec repo_spec;
+    repo_spec.file_count = state.range(1);
+    codeowners_spec co_spec;
+    co_spec.rule_count = state.range(0);
+    const auto paths = generate_paths(repo_spec);
+    const ruleset rset{generate_rules(co_spec, paths)};
+    const ownership_index index{rset, paths.begin(), paths.end()};
+    std::size_t files = 0;
+    for (auto _ : state)
+    {
+        for (ruleset::owner_id id = 0; id < rset.owners().size(); ++id)
+        {
+            const auto owned = index.files_owned_by(id);
+            files += owned.size();
+            benchmark::DoNotOptimize(owned.data());
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(files));
+    state.counters["owners"] = static_cast<double>(rset.owners().size());
+}
+BENCHMARK(BM_ownership_index_files_owned_by)
+    ->ArgNames({"rules", "files"})
+    ->ArgsProduct({{100, 1000}, {100000}});
+
+} // end namespace 'co'
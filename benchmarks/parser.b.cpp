@@ -0,0 +1,84 @@
+#include "benchmark_utils.hpp"
+
+#include <codeowners/mapped_parser.hpp>
+#include <codeowners/parser.hpp>
+
+#include <src/text_scanner.hpp>
+
+#include <sstream>
+
+namespace co
+{
+
+void BM_parse(benchmark::State& state)
+{
+    const std::string content = make_codeowners_content(make_rules(state.range(0)));
+    for (auto _ : state)
+    {
+        std::istringstream is{content};
+        benchmark::DoNotOptimize(parse(is, "CODEOWNERS"));
+    }
+    state.SetBytesProcessed(state.iterations() * content.size());
+}
+BENCHMARK(BM_parse)->ArgName("rules")->RangeMultiplier(10)->Range(10, 10000);
+
+void BM_line_range_parse_line(benchmark::State& state)
+{
+    const std::string content = make_codeowners_content(make_rules(state.range(0)));
+    for (auto _ : state)
+    {
+        std::istringstream is{content};
+        for (const auto& line : line_range(is))
+        {
+            benchmark::DoNotOptimize(parse_line(line));
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * content.size());
+}
+BENCHMARK(BM_line_range_parse_line)->ArgName("rules")->RangeMultiplier(10)->Range(10, 10000);
+
+void BM_codeowners_view(benchmark::State& state)
+{
+    const std::string content = make_codeowners_content(make_rules(state.range(0)));
+    for (auto _ : state)
+    {
+        codeowners_view view{content, "CODEOWNERS"};
+        benchmark::DoNotOptimize(view.rules().data());
+    }
+    state.SetBytesProcessed(state.iterations() * content.size());
+}
+BENCHMARK(BM_codeowners_view)->ArgName("rules")->RangeMultiplier(10)->Range(10, 10000);
+
+/// Tokenization alone, with each byte classification kernel.
+void BM_tokenize(benchmark::State& state)
+{
+    const auto kernel = static_cast<scan_kernel>(state.range(0));
+    if (!is_supported(kernel))
+    {
+        state.SkipWithError("Kernel not supported by this processor");
+        return;
+    }
+    state.SetLabel(to_string(kernel));
+
+    const std::string content = make_codeowners_content(make_rules(10000));
+    for (auto _ : state)
+    {
+        text_scanner scanner{content, kernel};
+        std::size_t tokens = 0;
+        std::size_t pos = 0;
+        while ((pos = scanner.find_non_space(pos)) < content.size())
+        {
+            pos = scanner.find_space(pos);
+            ++tokens;
+        }
+        benchmark::DoNotOptimize(tokens);
+    }
+    state.SetBytesProcessed(state.iterations() * content.size());
+}
+BENCHMARK(BM_tokenize)
+    ->ArgName("kernel")
+    ->Arg(static_cast<int>(scan_kernel::SCALAR))
+    ->Arg(static_cast<int>(scan_kernel::SSE2))
+    ->Arg(static_cast<int>(scan_kernel::AVX2));
+
+} // end namespace 'co'
@@ -0,0 +1,324 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+namespace co
+{
+
+/**
+ * Counts the system calls made by this process, using the `raw_syscalls:sys_enter`
+ * tracepoint.  Counting is unavailable where the kernel disallows tracepoint access (see
+ * `/proc/sys/kernel/perf_event_paranoid`) or does not expose tracefs, and on other systems.
+ */
+class syscall_counter
+{
+public:
+    syscall_counter()
+    {
+#ifdef __linux__
+        for (const char* dir : {"/sys/kernel/tracing", "/sys/kernel/debug/tracing"})
+        {
+            std::ifstream id_file{std::string{dir} + "/events/raw_syscalls/sys_enter/id"};
+            std::uint64_t id;
+            if (id_file >> id)
+            {
+                ::perf_event_attr attr{};
+                attr.type = PERF_TYPE_TRACEPOINT;
+                attr.size = sizeof(attr);
+                attr.config = id;
+                attr.inherit = 1;
+                m_fd = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+                break;
+            }
+        }
+#endif
+    }
+
+    syscall_counter(const syscall_counter&) = delete;
+    syscall_counter& operator=(const syscall_counter&) = delete;
+
+    ~syscall_counter()
+    {
+        if (m_fd >= 0)
+        {
+            ::close(m_fd);
+        }
+    }
+
+    /// Return the number of system calls made since construction, if available.
+    std::optional<std::uint64_t> read() const
+    {
+        std::uint64_t count;
+        if (m_fd >= 0 && ::read(m_fd, &count, sizeof(count)) == sizeof(count))
+        {
+            return count;
+        }
+        return std::nullopt;
+    }
+
+private:
+    int m_fd = -1;
+};
+
+/// Hardware events counted by `hardware_counters`.
+enum class hardware_event
+{
+    INSTRUCTIONS,
+    CYCLES,
+    L1D_MISSES,   /// Level 1 data cache read misses.
+    LLC_MISSES,   /// Last-level cache misses.
+    BRANCH_MISSES /// Mispredicted branches.
+};
+
+inline const char* to_string(hardware_event e)
+{
+    switch (e)
+    {
+    case hardware_event::INSTRUCTIONS:
+        return "instructions";
+    case hardware_event::CYCLES:
+        return "cycles";
+    case hardware_event::L1D_MISSES:
+        return "l1d_misses";
+    case hardware_event::LLC_MISSES:
+        return "llc_misses";
+    case hardware_event::BRANCH_MISSES:
+        return "branch_misses";
+    }
+    return "unknown";
+}
+
+/// Counts of hardware events over a measured region; events that could not be counted are
+/// empty.
+struct hardware_counts
+{
+    static constexpr std::size_t event_count
+        = static_cast<std::size_t>(hardware_event::BRANCH_MISSES) + 1;
+
+    std::array<std::optional<std::uint64_t>, event_count> values;
+
+    const std::optional<std::uint64_t>& operator[](hardware_event e) const
+    {
+        return values[static_cast<std::size_t>(e)];
+    }
+};
+
+/**
+ * Counts hardware events in user space for the calling thread, using `perf_event_open`.
+ * Each event is opened separately, so that events the processor or kernel does not support
+ * are unavailable while the others are still counted.  Counting is unavailable where the
+ * kernel disallows it (see `/proc/sys/kernel/perf_event_paranoid`), in many virtual
+ * machines, and on other systems.  Counts are scaled if the kernel multiplexed counters.
+ */
+class hardware_counters
+{
+public:
+    hardware_counters()
+    {
+        m_fds.fill(-1);
+#ifdef __linux__
+        const auto cache_event = [](std::uint64_t cache, std::uint64_t result) {
+            return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (result << 16);
+        };
+        const std::array<std::pair<std::uint32_t, std::uint64_t>, hardware_counts::event_count>
+            events{{{PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+                    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+                    {PERF_TYPE_HW_CACHE,
+                     cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+                    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+                    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}}};
+        for (std::size_t i = 0; i < events.size(); ++i)
+        {
+            ::perf_event_attr attr{};
+            attr.type = events[i].first;
+            attr.size = sizeof(attr);
+            attr.config = events[i].second;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            m_fds[i] = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+#endif
+    }
+
+    hardware_counters(const hardware_counters&) = delete;
+    hardware_counters& operator=(const hardware_counters&) = delete;
+
+    ~hardware_counters()
+    {
+        for (int fd : m_fds)
+        {
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+        }
+    }
+
+    /// Return whether any event can be counted.
+    bool available() const
+    {
+        for (int fd : m_fds)
+        {
+            if (fd >= 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Reset the counters and start counting.
+    void start()
+    {
+#ifdef __linux__
+        for (int fd : m_fds)
+        {
+            if (fd >= 0)
+            {
+                ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    /// Stop counting, and return the counts since `start()`.
+    hardware_counts stop()
+    {
+        hardware_counts counts;
+#ifdef __linux__
+        for (int fd : m_fds)
+        {
+            if (fd >= 0)
+            {
+                ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+        for (std::size_t i = 0; i < m_fds.size(); ++i)
+        {
+            // Value, time enabled and time running.
+            std::uint64_t data[3];
+            if (m_fds[i] >= 0 && ::read(m_fds[i], data, sizeof(data)) == sizeof(data)
+                && data[2] > 0)
+            {
+                counts.values[i] = data[2] == data[1]
+                    ? data[0]
+                    : static_cast<std::uint64_t>(static_cast<double>(data[0]) * data[1] / data[2]);
+            }
+        }
+#endif
+        return counts;
+    }
+
+private:
+    std::array<int, hardware_counts::event_count> m_fds;
+};
+
+/// Resource usage of this process at one point in time.
+struct process_snapshot
+{
+    std::chrono::steady_clock::time_point time;
+    std::optional<std::uint64_t> syscalls;
+    /// Read-like and write-like system calls, from `/proc/self/io`.
+    std::optional<std::uint64_t> read_syscalls;
+    std::optional<std::uint64_t> write_syscalls;
+    std::uint64_t major_faults;
+    std::uint64_t minor_faults;
+    std::uint64_t block_inputs;
+
+    static process_snapshot take(const syscall_counter& counter)
+    {
+        process_snapshot s;
+        s.syscalls = counter.read();
+#ifdef __linux__
+        std::ifstream io{"/proc/self/io"};
+        std::string key;
+        std::uint64_t value;
+        while (io >> key >> value)
+        {
+            if (key == "syscr:")
+            {
+                s.read_syscalls = value;
+            }
+            else if (key == "syscw:")
+            {
+                s.write_syscalls = value;
+            }
+        }
+#endif
+        ::rusage usage{};
+        ::getrusage(RUSAGE_SELF, &usage);
+        s.major_faults = usage.ru_majflt;
+        s.minor_faults = usage.ru_minflt;
+        s.block_inputs = usage.ru_inblock;
+        // Taken last, so that the cost of taking the snapshot is mostly excluded.
+        s.time = std::chrono::steady_clock::now();
+        return s;
+    }
+};
+
+/// Reset the peak resident set size reported by `peak_rss_kib`, if supported.
+inline bool reset_peak_rss()
+{
+#ifdef __linux__
+    std::ofstream clear_refs{"/proc/self/clear_refs"};
+    return static_cast<bool>(clear_refs << "5" << std::flush);
+#else
+    return false;
+#endif
+}
+
+/// Return the peak resident set size of this process in KiB, since the last successful call
+/// of `reset_peak_rss`.
+inline std::uint64_t peak_rss_kib()
+{
+#ifdef __linux__
+    std::ifstream status{"/proc/self/status"};
+    std::string key;
+    while (status >> key)
+    {
+        std::uint64_t value;
+        if (key == "VmHWM:" && status >> value)
+        {
+            return value;
+        }
+    }
+#endif
+    ::rusage usage{};
+    ::getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024; // Bytes on macOS.
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+/// Drop the kernel's page, dentry and inode caches.  This requires root privileges.
+inline bool drop_page_cache()
+{
+#ifdef __linux__
+    ::sync();
+    std::ofstream drop_caches{"/proc/sys/vm/drop_caches"};
+    return static_cast<bool>(drop_caches << "3" << std::flush);
+#else
+    return false;
+#endif
+}
+
+} // end namespace 'co'
@@ -0,0 +1,232 @@
+#include "benchmark_utils.hpp"
+
+#include <codeowners/generator.hpp>
+#include <codeowners/ruleset.hpp>
+
+#include <src/pattern_map.hpp>
+
+#include <algorithm>
+#include <memory>
+
+namespace co
+{
+
+namespace
+{
+    /// Arguments:  number of rules, and path depth.
+    void rule_and_depth_args(benchmark::internal::Benchmark* b)
+    {
+        b->ArgNames({"rules", "depth"})->ArgsProduct({{10, 100, 1000, 10000}, {2, 8}});
+    }
+
+    /// Limit on allocations per file looked up with a cursor.  Only constructing a cursor
+    /// allocates memory; lookups reuse its buffers.
+    constexpr double max_cursor_allocations_per_file = 0.01;
+} // end anonymous namespace
+
+void BM_ruleset_construction(benchmark::State& state)
+{
+    const auto rules = make_rules(state.range(0));
+    for (auto _ : state)
+    {
+        ruleset rset{rules};
+        benchmark::DoNotOptimize(rset.size());
+    }
+    state.SetItemsProcessed(state.iterations() * rules.size());
+}
+BENCHMARK(BM_ruleset_construction)->ArgName("rules")->RangeMultiplier(10)->Range(10, 10000);
+
+/// Construction of large generated rulesets, compiled on increasing numbers of threads.
+void BM_ruleset_compile_scaling(benchmark::State& state)
+{
+    repository_spec repo_spec;
+    repo_spec.file_count = 100000;
+    codeowners_spec co_spec;
+    co_spec.rule_count = state.range(0);
+    const auto rules = generate_rules(co_spec, generate_paths(repo_spec));
+    const auto threads = static_cast<std::size_t>(state.range(1));
+    for (auto _ : state)
+    {
+        ruleset rset{rules, threads};
+        benchmark::DoNotOptimize(rset.size());
+    }
+    state.SetItemsProcessed(state.iterations() * rules.size());
+}
+BENCHMARK(BM_ruleset_compile_scaling)
+    ->ArgNames({"rules", "threads"})
+    ->ArgsProduct({{10000, 50000}, {1, 2, 4, 8}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+/// Queries for the rules overlapping a proposed pattern, in generated rulesets.  The cost
+/// depends on the number of rules, but not on the number of files.
+void BM_ruleset_overlapping_rules(benchmark::State& state)
+{
+    repository_spec repo_spec;
+    repo_spec.file_count = 100000;
+    codeowners_spec co_spec;
+    co_spec.rule_count = state.range(0);
+    const ruleset rset{generate_rules(co_spec, generate_paths(repo_spec))};
+    const pattern proposed{"/api/*/util/**"};
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(rset.overlapping_rules(proposed));
+    }
+    state.SetItemsProcessed(state.iterations() * rset.size());
+}
+BENCHMARK(BM_ruleset_overlapping_rules)
+    ->ArgName("rules")
+    ->RangeMultiplier(10)
+    ->Range(100, 10000)
+    ->Unit(benchmark::kMicrosecond);
+
+/// Lookups with a long-lived ruleset, whose caches are warm after the first iteration.
+void BM_ruleset_apply_hot(benchmark::State& state)
+{
+    const ruleset rset{make_rules(state.range(0))};
+    const auto paths = make_paths(lookup_path_count, state.range(1));
+    hardware_counter_scope hardware;
+    const allocation_scope allocations;
+    for (auto _ : state)
+    {
+        for (const auto& p : paths)
+        {
+            benchmark::DoNotOptimize(rset.apply(p));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * paths.size());
+    hardware.report(state, paths.size());
+    report_allocations(state, allocations, paths.size());
+}
+BENCHMARK(BM_ruleset_apply_hot)->Apply(rule_and_depth_args);
+
+/// Lookups with a newly constructed ruleset, whose caches are empty.  Construction is not
+/// timed.
+void BM_ruleset_apply_cold(benchmark::State& state)
+{
+    const auto rules = make_rules(state.range(0));
+    const auto paths = make_paths(lookup_path_count, state.range(1));
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto rset = std::make_unique<ruleset>(rules);
+        state.ResumeTiming();
+        for (const auto& p : paths)
+        {
+            benchmark::DoNotOptimize(rset->apply(p));
+        }
+        state.PauseTiming();
+        rset.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * paths.size());
+}
+BENCHMARK(BM_ruleset_apply_cold)->Apply(rule_and_depth_args);
+
+void BM_ruleset_cursor(benchmark::State& state)
+{
+    const ruleset rset{make_rules(state.range(0))};
+    const auto paths = make_paths(lookup_path_count, state.range(1));
+    hardware_counter_scope hardware;
+    const allocation_scope allocations;
+    for (auto _ : state)
+    {
+        ruleset::cursor cursor{rset};
+        for (const auto& p : paths)
+        {
+            benchmark::DoNotOptimize(cursor.find(p));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * paths.size());
+    hardware.report(state, paths.size());
+    report_allocations(state, allocations, paths.size(), max_cursor_allocations_per_file);
+}
+BENCHMARK(BM_ruleset_cursor)->Apply(rule_and_depth_args);
+
+/// Lookups of the paths of a generated repository, with its generated CODEOWNERS rules.
+void BM_ruleset_cursor_generated(benchmark::State& state)
+{
+    repository_spec repo_spec;
+    repo_spec.file_count = state.range(1);
+    codeowners_spec co_spec;
+    co_spec.rule_count = state.range(0);
+    const auto paths = generate_paths(repo_spec);
+    const ruleset rset{generate_rules(co_spec, paths)};
+    hardware_counter_scope hardware;
+    const allocation_scope allocations;
+    for (auto _ : state)
+    {
+        ruleset::cursor cursor{rset};
+        for (const auto& p : paths)
+        {
+            benchmark::DoNotOptimize(cursor.find(p));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * paths.size());
+    hardware.report(state, paths.size());
+    report_allocations(state, allocations, paths.size(), max_cursor_allocations_per_file);
+}
+BENCHMARK(BM_ruleset_cursor_generated)
+    ->ArgNames({"rules", "files"})
+    ->ArgsProduct({{100, 1000, 10000}, {100000}});
+
+/// Lookups of every matching rule, for comparison with `BM_ruleset_cursor_generated`.
+void BM_ruleset_cursor_find_all_generated(benchmark::State& state)
+{
+    repository_spec repo_spec;
+    repo_spec.file_count = state.range(1);
+    codeowners_spec co_spec;
+    co_spec.rule_count = state.range(0);
+    const auto paths = generate_paths(repo_spec);
+    const ruleset rset{generate_rules(co_spec, paths)};
+    std::vector<ruleset::rule_id> matching;
+    std::uint64_t matches = 0;
+    hardware_counter_scope hardware;
+    const allocation_scope allocations;
+    for (auto _ : state)
+    {
+        ruleset::cursor cursor{rset, ruleset::match_mode::ALL};
+        for (const auto& p : paths)
+        {
+            benchmark::DoNotOptimize(cursor.find_all(p, matching));
+            matches += matching.size();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * paths.size());
+    state.counters["matches_per_file"] = static_cast<double>(matches)
+        / static_cast<double>(state.iterations() * paths.size());
+    hardware.report(state, paths.size());
+    report_allocations(state, allocations, paths.size(), max_cursor_allocations_per_file);
+}
+BENCHMARK(BM_ruleset_cursor_find_all_generated)
+    ->ArgNames({"rules", "files"})
+    ->ArgsProduct({{100, 1000, 10000}, {100000}});
+
+void BM_pattern_map_find(benchmark::State& state)
+{
+    const auto rules = make_rules(state.range(0));
+    pattern_map<std::size_t> map;
+    for (std::size_t i = 0; i < rules.size(); ++i)
+    {
+        map.insert({rules[i].rule.file_pattern, i});
+    }
+    const auto paths = make_paths(lookup_path_count, state.range(1));
+    hardware_counter_scope hardware;
+    const allocation_scope allocations;
+    for (auto _ : state)
+    {
+        for (const auto& p : paths)
+        {
+            benchmark::DoNotOptimize(map.find(p));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * paths.size());
+    hardware.report(state, paths.size());
+    report_allocations(state, allocations, paths.size());
+    const auto cache = map.directory_cache_statistics();
+    state.counters["cache_hit_rate"]
+        = static_cast<double>(cache.hits) / std::max<std::uint64_t>(cache.hits + cache.misses, 1);
+}
+BENCHMARK(BM_pattern_map_find)->Apply(rule_and_depth_args);
+
+} // end namespace 'co'
@@ -0,0 +1,115 @@
+#include "benchmark_utils.hpp"
+
+#include <codeowners/generator.hpp>
+#include <codeowners/ruleset.hpp>
+
+// Generated at build time by `codeowners-codegen` from the CODEOWNERS file printed by
+// `generate-repo --codeowners-only`, with the specifications below.
+#include <static_rules.hpp>
+
+#include <optional>
+#include <vector>
+
+namespace co
+{
+
+namespace
+{
+    constexpr std::size_t generated_file_count = 100000;
+    constexpr std::size_t generated_rule_count = 1000;
+
+    /// Limit on allocations per file looked up in the generated ruleset, which never
+    /// allocates; the limit allows for the few allocations of the benchmark library.
+    constexpr double max_static_allocations_per_file = 0.001;
+
+    std::vector<fs::path> generated_paths()
+    {
+        repository_spec repo_spec;
+        repo_spec.file_count = generated_file_count;
+        return generate_paths(repo_spec);
+    }
+
+    std::vector<annotated_rule> generated_rules(const std::vector<fs::path>& paths)
+    {
+        codeowners_spec co_spec;
+        co_spec.rule_count = generated_rule_count;
+        return generate_rules(co_spec, paths);
+    }
+
+    /// Return whether the generated header and `rset` apply the same rules to `paths`.
+    bool agrees_with(const ruleset& rset, const std::vector<fs::path>& paths)
+    {
+        for (const auto& p : paths)
+        {
+            const std::optional<std::size_t> id = rset.find(p);
+            if (static_rules::find(p.native()) != id)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+} // end anonymous namespace
+
+/// Lookups with the generated, `constexpr` ruleset.
+void BM_static_ruleset_find(benchmark::State& state)
+{
+    const auto paths = generated_paths();
+    if (!agrees_with(ruleset{generated_rules(paths)}, paths))
+    {
+        state.SkipWithError("The generated ruleset does not match generate_rules");
+        return;
+    }
+    hardware_counter_scope hardware;
+    const allocation_scope allocations;
+    for (auto _ : state)
+    {
+        for (const auto& p : paths)
+        {
+            benchmark::DoNotOptimize(static_rules::find(p.native()));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * paths.size());
+    hardware.report(state, paths.size());
+    report_allocations(state, allocations, paths.size(), max_static_allocations_per_file);
+}
+BENCHMARK(BM_static_ruleset_find);
+
+/// Lookups of the same paths and rules with a `ruleset` built at run time, for comparison.
+void BM_static_ruleset_dynamic_find(benchmark::State& state)
+{
+    const auto paths = generated_paths();
+    const ruleset rset{generated_rules(paths)};
+    hardware_counter_scope hardware;
+    for (auto _ : state)
+    {
+        for (const auto& p : paths)
+        {
+            benchmark::DoNotOptimize(rset.find(p));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * paths.size());
+    hardware.report(state, paths.size());
+}
+BENCHMARK(BM_static_ruleset_dynamic_find);
+
+/// Lookups of the same paths and rules with a cursor, for comparison.
+void BM_static_ruleset_dynamic_cursor(benchmark::State& state)
+{
+    const auto paths = generated_paths();
+    const ruleset rset{generated_rules(paths)};
+    hardware_counter_scope hardware;
+    for (auto _ : state)
+    {
+        ruleset::cursor cursor{rset};
+        for (const auto& p : paths)
+        {
+            benchmark::DoNotOptimize(cursor.find(p));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * paths.size());
+    hardware.report(state, paths.size());
+}
+BENCHMARK(BM_static_ruleset_dynamic_cursor);
+
+} // end namespace 'co'
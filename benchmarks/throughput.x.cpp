@@ -0,0 +1,493 @@
+/*
+ * End-to-end throughput of the `ls-owners` pipeline, run in-process against generated
+ * repositories on tmpfs and on disk.
+ *
+ * Each run performs the phases of `ls-owners` in order:  repository discovery, submodule
+ * enumeration, CODEOWNERS parsing and ruleset compilation, followed by three traversals of
+ * the work tree:  traversal alone, traversal with matching, and traversal with matching and
+ * output (to /dev/null).  The cost of matching and of output is the difference between
+ * consecutive traversals.  For each phase, the driver reports wall time, files per second,
+ * system calls, allocations and allocated bytes per file, and peak resident set size.  With
+ * `--perf-counters`, it also reports hardware events per file, such as instructions and
+ * cache misses, where the kernel allows counting them.
+ *
+ * Warm-cache runs are preceded by an untimed run, and the median of several repetitions is
+ * reported.  Cold-cache runs drop the kernel's page, dentry and inode caches before every
+ * phase, which requires root privileges; they are skipped otherwise.
+ */
+#include "process_counters.hpp"
+
+#include <codeowners/allocation_counter.hpp>
+#include <codeowners/codeowners.hpp>
+#include <codeowners/errors.hpp>
+#include <codeowners/filesystem.hpp>
+#include <codeowners/generator.hpp>
+#include <codeowners/list_owners.hpp>
+#include <codeowners/output.hpp>
+#include <codeowners/parser.hpp>
+#include <codeowners/recursive_filter_iterator.hpp>
+#include <codeowners/repository.hpp>
+#include <codeowners/ruleset.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+
+#include <fcntl.h>
+#ifdef __linux__
+#include <linux/magic.h>
+#include <sys/vfs.h>
+#endif
+
+namespace po = boost::program_options;
+
+constexpr const char* PROGRAM_NAME = "ls_owners_throughput";
+
+struct throughput_options
+{
+    co::repository_spec repo_spec;
+    co::codeowners_spec codeowners_spec;
+    std::size_t repetitions;
+    fs::path tmpfs_dir;
+    fs::path disk_dir;
+    std::string json_file;
+    bool perf_counters;
+};
+
+struct phase_result
+{
+    std::string location;
+    std::string cache;
+    std::string phase;
+    double seconds;
+    std::uint64_t files;
+    std::optional<std::uint64_t> syscalls;
+    std::optional<std::uint64_t> read_syscalls;
+    std::optional<std::uint64_t> write_syscalls;
+    std::uint64_t major_faults;
+    std::uint64_t block_inputs;
+    std::uint64_t allocations;
+    std::uint64_t allocated_bytes;
+    std::uint64_t peak_rss_kib;
+    co::hardware_counts hardware;
+};
+
+/// Directory created by the driver, which is removed with its contents on destruction.
+struct scratch_directory
+{
+    explicit scratch_directory(const fs::path& parent)
+        : path{parent / fs::unique_path("codeowners-throughput-%%%%-%%%%")}
+    {
+        fs::create_directories(path);
+    }
+    ~scratch_directory()
+    {
+        boost::system::error_code ec;
+        fs::remove_all(path, ec);
+    }
+
+    fs::path path;
+};
+
+/// Runs the phases of one pipeline run, and records their costs.
+class phase_recorder
+{
+public:
+    /// Hardware events are counted if `hardware` is not null.
+    phase_recorder(const co::syscall_counter& counter, co::hardware_counters* hardware,
+                   std::string location, std::string cache, bool cold)
+        : m_counter{counter}
+        , m_hardware{hardware}
+        , m_location{std::move(location)}
+        , m_cache{std::move(cache)}
+        , m_cold{cold}
+    {
+    }
+
+    /// Run `f`, which returns a value, and record the cost of a phase that processed `files`
+    /// files (as set by `f`).
+    template <typename F>
+    auto run(const std::string& phase, std::uint64_t& files, F&& f)
+    {
+        if (m_cold)
+        {
+            co::drop_page_cache();
+        }
+        co::reset_peak_rss();
+        files = 0;
+        const auto before = co::process_snapshot::take(m_counter);
+        const co::allocation_scope allocations;
+        if (m_hardware)
+        {
+            m_hardware->start();
+        }
+        auto result = f();
+        const co::hardware_counts hardware
+            = m_hardware ? m_hardware->stop() : co::hardware_counts{};
+        const co::allocation_counts allocated = allocations.counts();
+        const auto after = co::process_snapshot::take(m_counter);
+
+        const auto difference = [](const auto& a, const auto& b) -> std::optional<std::uint64_t> {
+            if (a && b)
+            {
+                return *b - *a;
+            }
+            return std::nullopt;
+        };
+        m_results.push_back(
+            {m_location, m_cache, phase,
+             std::chrono::duration<double>(after.time - before.time).count(), files,
+             difference(before.syscalls, after.syscalls),
+             difference(before.read_syscalls, after.read_syscalls),
+             difference(before.write_syscalls, after.write_syscalls),
+             after.major_faults - before.major_faults, after.block_inputs - before.block_inputs,
+             allocated.allocations, allocated.bytes, co::peak_rss_kib(), hardware});
+        return result;
+    }
+
+    const std::vector<phase_result>& results() const { return m_results; }
+
+private:
+    const co::syscall_counter& m_counter;
+    co::hardware_counters* m_hardware;
+    std::string m_location;
+    std::string m_cache;
+    bool m_cold;
+    std::vector<phase_result> m_results;
+};
+
+/// Run the `ls-owners` pipeline for the repository at `root`.
+void run_pipeline(phase_recorder& recorder, const fs::path& root)
+{
+    std::uint64_t files;
+    const auto [repo, codeowners_file] = recorder.run("discovery", files, [&] {
+        auto repo = co::repository::discover(root);
+        auto path = co::codeowners_path(repo.work_directory());
+        if (!path)
+        {
+            throw co::error{"No CODEOWNERS file in " + root.string()};
+        }
+        return std::make_pair(std::move(repo), *path);
+    });
+    const fs::path work_dir = repo.work_directory();
+
+    const auto to_skip
+        = recorder.run("submodules", files, [&] { return co::nonwork_directories(repo); });
+    const auto rules = recorder.run("parse", files, [&] {
+        auto rules = co::parse(codeowners_file);
+        files = 1;
+        return rules;
+    });
+    const auto rset = recorder.run("compile", files, [&] { return co::ruleset{rules}; });
+
+    recorder.run("traverse", files, [&] {
+        for (const auto& entry : co::make_filtered_file_range(work_dir, to_skip))
+        {
+            files += !fs::is_directory(entry.status());
+        }
+        return files;
+    });
+    recorder.run("traverse+match", files, [&] {
+        co::ruleset::cursor cursor{rset};
+        co::for_each_owned_file(cursor, work_dir, work_dir, to_skip,
+                                [&](const fs::directory_entry&, auto, auto) { ++files; });
+        return files;
+    });
+    recorder.run("traverse+match+output", files, [&] {
+        const int fd = ::open("/dev/null", O_WRONLY);
+        {
+            co::output_writer writer{fd, co::output_format::TEXT};
+            co::ruleset::cursor cursor{rset};
+            co::for_each_owned_file(
+                cursor, work_dir, work_dir, to_skip,
+                [&](const fs::directory_entry&, std::string_view path,
+                    std::optional<co::ruleset::rule_id> id) {
+                    writer.write(path,
+                                 id ? rset.owner_names(*id) : co::array_view<std::string_view>{});
+                    ++files;
+                });
+            writer.flush();
+        }
+        ::close(fd);
+        return files;
+    });
+}
+
+/// Return the per-phase medians, by wall time, of several runs' results.
+std::vector<phase_result> median_results(const std::vector<std::vector<phase_result>>& runs)
+{
+    std::vector<phase_result> medians;
+    for (std::size_t i = 0; i < runs.front().size(); ++i)
+    {
+        std::vector<phase_result> samples;
+        for (const auto& run : runs)
+        {
+            samples.push_back(run[i]);
+        }
+        auto middle = samples.begin() + samples.size() / 2;
+        std::nth_element(samples.begin(), middle, samples.end(),
+                         [](const auto& a, const auto& b) { return a.seconds < b.seconds; });
+        medians.push_back(*middle);
+    }
+    return medians;
+}
+
+bool is_tmpfs(const fs::path& dir)
+{
+#ifdef __linux__
+    struct ::statfs info;
+    return ::statfs(dir.c_str(), &info) == 0 && info.f_type == TMPFS_MAGIC;
+#else
+    (void)dir;
+    return false;
+#endif
+}
+
+std::ostream& operator<<(std::ostream& os, const std::optional<std::uint64_t>& value)
+{
+    if (value)
+    {
+        return os << *value;
+    }
+    return os << "n/a";
+}
+
+void print_table(std::ostream& os, const std::vector<phase_result>& results)
+{
+    os << std::left << std::setw(8) << "location" << std::setw(6) << "cache" << std::setw(24)
+       << "phase" << std::right << std::setw(12) << "time (ms)" << std::setw(14) << "files/s"
+       << std::setw(12) << "syscalls" << std::setw(10) << "read" << std::setw(10) << "write"
+       << std::setw(10) << "majflt" << std::setw(10) << "blk in" << std::setw(14)
+       << "allocs/file" << std::setw(14) << "bytes/file" << std::setw(16) << "peak RSS (KiB)"
+       << '\n';
+    for (const auto& r : results)
+    {
+        // Phases that process no files, such as discovery, report total allocations.
+        const double files = static_cast<double>(std::max<std::uint64_t>(r.files, 1));
+        os << std::left << std::setw(8) << r.location << std::setw(6) << r.cache << std::setw(24)
+           << r.phase << std::right << std::fixed << std::setprecision(3) << std::setw(12)
+           << r.seconds * 1e3 << std::setprecision(0) << std::setw(14)
+           << (r.files && r.seconds > 0 ? r.files / r.seconds : 0.0) << std::setw(12)
+           << r.syscalls << std::setw(10) << r.read_syscalls << std::setw(10)
+           << r.write_syscalls << std::setw(10) << r.major_faults << std::setw(10)
+           << r.block_inputs << std::setprecision(2) << std::setw(14) << r.allocations / files
+           << std::setw(14) << r.allocated_bytes / files << std::setw(16) << r.peak_rss_kib
+           << '\n';
+    }
+}
+
+/// Print hardware event counts per file, for phases that process files.
+void print_hardware_table(std::ostream& os, const std::vector<phase_result>& results)
+{
+    os << "\nHardware events per file:\n"
+       << std::left << std::setw(8) << "location" << std::setw(6) << "cache" << std::setw(24)
+       << "phase" << std::right;
+    for (std::size_t i = 0; i < co::hardware_counts::event_count; ++i)
+    {
+        os << std::setw(16) << to_string(static_cast<co::hardware_event>(i));
+    }
+    os << '\n';
+    for (const auto& r : results)
+    {
+        if (r.files == 0)
+        {
+            continue;
+        }
+        os << std::left << std::setw(8) << r.location << std::setw(6) << r.cache << std::setw(24)
+           << r.phase << std::right << std::fixed << std::setprecision(1);
+        for (const auto& value : r.hardware.values)
+        {
+            os << std::setw(16);
+            if (value)
+            {
+                os << static_cast<double>(*value) / r.files;
+            }
+            else
+            {
+                os << "n/a";
+            }
+        }
+        os << '\n';
+    }
+}
+
+void write_json(std::ostream& os, const throughput_options& options,
+                const std::vector<phase_result>& results)
+{
+    const auto json_value = [&os](const std::optional<std::uint64_t>& value) -> std::ostream& {
+        return value ? (os << *value) : (os << "null");
+    };
+    os << "{\n  \"context\": {\"files\": " << options.repo_spec.file_count
+       << ", \"depth\": " << options.repo_spec.depth
+       << ", \"fan_out\": " << options.repo_spec.fan_out
+       << ", \"submodules\": " << options.repo_spec.submodule_count
+       << ", \"rules\": " << options.codeowners_spec.rule_count
+       << ", \"seed\": " << options.repo_spec.seed
+       << ", \"repetitions\": " << options.repetitions << "},\n  \"results\": [";
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        const auto& r = results[i];
+        os << (i ? ",\n" : "\n") << "    {\"location\": \"" << r.location << "\", \"cache\": \""
+           << r.cache << "\", \"phase\": \"" << r.phase << "\", \"seconds\": "
+           << std::setprecision(9) << r.seconds << ", \"files\": " << r.files
+           << ", \"syscalls\": ";
+        json_value(r.syscalls) << ", \"read_syscalls\": ";
+        json_value(r.read_syscalls) << ", \"write_syscalls\": ";
+        json_value(r.write_syscalls) << ", \"major_faults\": " << r.major_faults
+                                     << ", \"block_inputs\": " << r.block_inputs
+                                     << ", \"allocations\": " << r.allocations
+                                     << ", \"allocated_bytes\": " << r.allocated_bytes
+                                     << ", \"peak_rss_kib\": " << r.peak_rss_kib;
+        for (std::size_t e = 0; e < r.hardware.values.size(); ++e)
+        {
+            os << ", \"" << to_string(static_cast<co::hardware_event>(e)) << "\": ";
+            json_value(r.hardware.values[e]);
+        }
+        os << "}";
+    }
+    os << "\n  ]\n}\n";
+}
+
+throughput_options parse(int argc, const char* argv[])
+{
+    throughput_options options;
+    std::uint64_t seed;
+
+    po::options_description desc("Options");
+    desc.add_options()("help", "Print help message")(
+        "seed", po::value<std::uint64_t>(&seed)->default_value(0), "Random seed")(
+        "files", po::value<std::size_t>(&options.repo_spec.file_count)->default_value(100000),
+        "Number of files")(
+        "depth", po::value<std::size_t>(&options.repo_spec.depth)->default_value(6),
+        "Maximum directory depth of files")(
+        "fan-out", po::value<std::size_t>(&options.repo_spec.fan_out)->default_value(8),
+        "Maximum number of subdirectories per directory")(
+        "submodules", po::value<std::size_t>(&options.repo_spec.submodule_count)->default_value(2),
+        "Number of submodules")(
+        "rules", po::value<std::size_t>(&options.codeowners_spec.rule_count)->default_value(1000),
+        "Number of CODEOWNERS rules")(
+        "repetitions", po::value<std::size_t>(&options.repetitions)->default_value(5),
+        "Number of warm-cache runs")(
+        "tmpfs-dir", po::value<fs::path>(&options.tmpfs_dir)->default_value("/dev/shm"),
+        "Directory on tmpfs for generated repositories (empty to skip)")(
+        "disk-dir", po::value<fs::path>(&options.disk_dir)->default_value(fs::current_path()),
+        "Directory on disk for generated repositories (empty to skip)")(
+        "json", po::value<std::string>(&options.json_file), "Also write results as JSON to file")(
+        "perf-counters", po::bool_switch(&options.perf_counters)->default_value(false),
+        "Count hardware events, such as instructions and cache misses, per file");
+
+    po::variables_map vm;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+    }
+    catch (const po::error& err)
+    {
+        std::cerr << PROGRAM_NAME << ": " << err.what() << '\n' << desc << std::flush;
+        std::exit(EXIT_FAILURE);
+    }
+    if (vm.count("help"))
+    {
+        std::cout << "USAGE:\n\t" << PROGRAM_NAME << " [OPTIONS]\n\n" << desc << std::flush;
+        std::exit(EXIT_SUCCESS);
+    }
+
+    options.repo_spec.seed = seed;
+    options.codeowners_spec.seed = seed;
+    options.repetitions = std::max<std::size_t>(options.repetitions, 1);
+    return options;
+}
+
+int main(int argc, const char* argv[])
+{
+    const throughput_options options = parse(argc, argv);
+    const co::syscall_counter counter;
+    if (!counter.read())
+    {
+        std::cerr << "Note:  system call counts are unavailable; read and write calls are "
+                     "still counted.\n";
+    }
+    const bool can_drop_caches = co::drop_page_cache();
+    if (!can_drop_caches)
+    {
+        std::cerr << "Note:  cold-cache runs are skipped, since dropping caches requires root "
+                     "privileges.\n";
+    }
+    std::unique_ptr<co::hardware_counters> hardware;
+    if (options.perf_counters)
+    {
+        hardware = std::make_unique<co::hardware_counters>();
+        if (!hardware->available())
+        {
+            std::cerr << "Note:  hardware event counts are unavailable; see "
+                         "/proc/sys/kernel/perf_event_paranoid.\n";
+            hardware.reset();
+        }
+    }
+
+    std::vector<phase_result> results;
+    try
+    {
+        for (const auto& [location, parent] :
+             {std::make_pair("tmpfs", options.tmpfs_dir), std::make_pair("disk", options.disk_dir)})
+        {
+            if (parent.empty())
+            {
+                continue;
+            }
+            if (is_tmpfs(parent) != (location == std::string{"tmpfs"}))
+            {
+                std::cerr << "Warning:  " << parent << " is " << (is_tmpfs(parent) ? "" : "not ")
+                          << "on tmpfs\n";
+            }
+
+            const scratch_directory scratch{parent};
+            std::cerr << "Generating repository in " << scratch.path << "...\n";
+            co::generate_repository(scratch.path, options.repo_spec, options.codeowners_spec);
+
+            if (can_drop_caches)
+            {
+                phase_recorder recorder{counter, hardware.get(), location, "cold", true};
+                run_pipeline(recorder, scratch.path);
+                results.insert(results.end(), recorder.results().begin(),
+                               recorder.results().end());
+            }
+
+            std::vector<std::vector<phase_result>> warm_runs;
+            for (std::size_t i = 0; i <= options.repetitions; ++i)
+            {
+                phase_recorder recorder{counter, hardware.get(), location, "warm", false};
+                run_pipeline(recorder, scratch.path);
+                if (i > 0) // The first run warms the caches.
+                {
+                    warm_runs.push_back(recorder.results());
+                }
+            }
+            const auto medians = median_results(warm_runs);
+            results.insert(results.end(), medians.begin(), medians.end());
+        }
+    }
+    catch (const std::exception& err)
+    {
+        std::cerr << PROGRAM_NAME << ": " << err.what() << '\n';
+        return EXIT_FAILURE;
+    }
+
+    print_table(std::cout, results);
+    if (hardware)
+    {
+        print_hardware_table(std::cout, results);
+    }
+    if (!options.json_file.empty())
+    {
+        std::ofstream json{options.json_file};
+        write_json(json, options, results);
+        std::cout << "Results:  " << options.json_file << '\n';
+    }
+    return EXIT_SUCCESS;
+}
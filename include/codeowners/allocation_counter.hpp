@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+
+namespace co
+{
+
+/// Numbers of allocations and deallocations, and the total size of allocations.
+struct allocation_counts
+{
+    std::uint64_t allocations = 0;
+    std::uint64_t deallocations = 0;
+    std::uint64_t bytes = 0;
+
+    friend allocation_counts operator-(const allocation_counts& a, const allocation_counts& b)
+    {
+        return allocation_counts{a.allocations - b.allocations,
+                                 a.deallocations - b.deallocations, a.bytes - b.bytes};
+    }
+};
+
+/**
+ * The allocation_counter class reports the allocations made through the global `operator
+ * new` and `operator delete`, which are replaced by counting versions in executables that
+ * link the `codeowners_allocation_counter` library:  the test suite and the benchmarks.
+ * Allocations are counted per thread, so counts are not disturbed by other threads.
+ */
+class allocation_counter
+{
+public:
+    /// Return the allocations made by the calling thread since it started.
+    static allocation_counts thread_counts() noexcept;
+};
+
+/// An allocation_scope counts the allocations made by the calling thread since its
+/// construction.
+class allocation_scope
+{
+public:
+    allocation_scope() noexcept
+        : m_start{allocation_counter::thread_counts()}
+    {
+    }
+
+    allocation_counts counts() const noexcept
+    {
+        return allocation_counter::thread_counts() - m_start;
+    }
+
+private:
+    allocation_counts m_start;
+};
+
+} // end namespace 'co'
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "codeowners/codeowners.hpp"
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace co
+{
+
+/// Options for generating a static ruleset.
+struct codegen_options
+{
+    /// Namespace of the generated tables and functions, which may be nested (`a::b`).
+    std::string namespace_name = "codeowners_generated";
+    /// Name of the CODEOWNERS file, mentioned in the header comment.
+    std::string source_name = "CODEOWNERS";
+};
+
+/**
+ * Write a C++ header that encodes `rules` as a static ruleset, for tools whose CODEOWNERS
+ * file is fixed when they are built.  The header defines, in the given namespace:
+ *
+ *   - `owners`, the distinct owners, in order of first appearance;
+ *   - `owner_ids`, the owners of all rules, as indexes into `owners`;
+ *   - `rules`, a `co::static_rule` for each rule, in order;
+ *   - `find(path)`, which returns the index in `rules` of the rule that applies to a
+ *     normalized relative path, as `ruleset::find` does, or an empty optional.
+ *
+ * All tables are `constexpr`.  `find` tests one matcher per rule, in decreasing order of
+ * precedence, using the matchers of `static_ruleset.hpp` specialized for each pattern's
+ * kind, so that lookups are inlined and involve no parsing or compilation at run time.
+ * Rules that are shadowed by later rules (see `ruleset::shadowed_rules`) are not tested.
+ * Rules whose patterns cannot be compiled (see `ruleset::skipped_rules`) match no path, as
+ * in `ruleset`, so they are not tested either, and a comment in the header notes each.
+ *
+ * Throws `co::error` if the namespace is not valid.
+ */
+void write_static_ruleset(std::ostream& os, const std::vector<annotated_rule>& rules,
+                          const codegen_options& options = {});
+
+} // end namespace 'co'
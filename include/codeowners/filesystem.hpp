@@ -4,6 +4,7 @@
 #include <boost/process.hpp>
 
 #include <fstream>
+#include <string>
 #include <vector>
 
 namespace fs = boost::filesystem;
@@ -23,6 +24,33 @@ inline void ensure_exists(const fs::path& p) { std::ofstream ofs{p.string(), std
  */
 std::vector<fs::path> distinct_prefixed_paths(std::vector<fs::path> paths);
 
+/**
+ * The relative_path_builder class forms the paths, relative to a directory `base`, of the
+ * entries found by iterating recursively over a path `start`.
+ *
+ * The path of `start` relative to `base` is found once, by `fs::relative`, which resolves
+ * symbolic links and so makes system calls for each component.  The relative path of each
+ * entry is then formed lexically, by replacing the prefix `start` of the entry's path, in a
+ * buffer reused for every entry.
+ */
+class relative_path_builder
+{
+public:
+    relative_path_builder(const fs::path& base, const fs::path& start);
+
+    /// Return the path of `entry` relative to `base`.  `entry` must be `start`, or a path
+    /// formed by appending components to `start`, as an iterator over `start` yields.  The
+    /// returned path is valid until the next call.
+    const fs::path& operator()(const fs::path& entry);
+
+private:
+    // Relative path of `start`, or empty if it is `base` itself.
+    fs::path::string_type m_prefix;
+    fs::path::string_type::size_type m_start_size;
+    fs::path::string_type m_buffer;
+    fs::path m_path;
+};
+
 struct temporary_directory_handle : public boost::noncopyable
 {
     using path_type = fs::path;
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <codeowners/codeowners.hpp>
+#include <codeowners/filesystem.hpp>
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace co
+{
+
+/// Shape of a synthetic repository.  Equal specifications, including the seed, produce
+/// identical repositories on every platform.
+struct repository_spec
+{
+    std::uint64_t seed = 0;
+    /// Number of files in the repository, excluding submodules.
+    std::size_t file_count = 1000;
+    /// Maximum number of directory components of a file path.
+    std::size_t depth = 4;
+    /// Maximum number of subdirectories of each directory.
+    std::size_t fan_out = 8;
+    /// Number of submodules, and the number of files in each.
+    std::size_t submodule_count = 0;
+    std::size_t submodule_file_count = 100;
+    /// Files are filled with between zero and `max_file_size` bytes.
+    std::size_t max_file_size = 0;
+};
+
+/// Shape of a synthetic CODEOWNERS file.
+struct codeowners_spec
+{
+    std::uint64_t seed = 0;
+    std::size_t rule_count = 100;
+    /// Number of distinct owners, which are shared between rules.
+    std::size_t owner_count = 50;
+};
+
+/// Return the relative paths of the files of a repository with the given specification, in
+/// sorted order.  The files of submodules are not included.
+std::vector<fs::path> generate_paths(const repository_spec& spec);
+
+/// Return the relative paths of the submodules of a repository with the given specification.
+std::vector<fs::path> generate_submodule_paths(const repository_spec& spec);
+
+/// Return CODEOWNERS rules for the files at `paths`, as produced by `generate_paths`.
+///
+/// The rules are a mix of those found in large CODEOWNERS files:  a leading catch-all rule,
+/// extension rules (`*.md`, `/src/*.py`), anchored directories (`/src/api/`), single-level
+/// wildcards (`/src/*`), `**` patterns (`/src/**`, `/src/**/*.py`, `**/tests/`) and unanchored
+/// directories (`docs/`).  Directory rules often refine, or are overridden by, the rules for
+/// parent or child directories.  Rules are annotated with the source name "CODEOWNERS".
+std::vector<annotated_rule> generate_rules(const codeowners_spec& spec,
+                                           const std::vector<fs::path>& paths);
+
+/// Write `rules` to `os` in CODEOWNERS format.
+void write_codeowners(std::ostream& os, const std::vector<annotated_rule>& rules);
+
+struct generated_repository
+{
+    std::vector<fs::path> paths;
+    std::vector<fs::path> submodule_paths;
+    std::vector<annotated_rule> rules;
+};
+
+/**
+ * Create a git repository at `root` with the given specification, and a `CODEOWNERS` file
+ * at its top level.  All files are added to the index, and submodules are committed
+ * repositories within the work tree.  The directory `root` is created if necessary, and
+ * must not already contain a repository.
+ *
+ * Throws `co::error` if the `git` executable cannot be run successfully.
+ */
+generated_repository generate_repository(const fs::path& root, const repository_spec& repo_spec,
+                                         const codeowners_spec& codeowners_spec);
+
+} // end namespace 'co'
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace co
+{
+
+/// Match character `c` against the bracket expression at the start of `pat`.  Return the
+/// length of the bracket expression, or zero if `pat` does not begin with a complete
+/// bracket expression.
+constexpr std::size_t match_bracket(std::string_view pat, char c, bool& matched)
+{
+    const auto uc = static_cast<unsigned char>(c);
+
+    std::size_t i = 1;
+    bool negated = false;
+    if (i < pat.size() && (pat[i] == '!' || pat[i] == '^'))
+    {
+        negated = true;
+        ++i;
+    }
+
+    bool found = false;
+    // A closing bracket immediately after the opening bracket is a literal character.
+    for (bool first = true; i < pat.size() && (first || pat[i] != ']'); ++i, first = false)
+    {
+        if (pat[i] == '\\' && i + 1 < pat.size())
+        {
+            ++i;
+        }
+        unsigned char lo = static_cast<unsigned char>(pat[i]);
+        unsigned char hi = lo;
+        if (i + 2 < pat.size() && pat[i + 1] == '-' && pat[i + 2] != ']')
+        {
+            i += 2;
+            if (pat[i] == '\\' && i + 1 < pat.size())
+            {
+                ++i;
+            }
+            hi = static_cast<unsigned char>(pat[i]);
+        }
+        found = found || (lo <= uc && uc <= hi);
+    }
+
+    if (i >= pat.size())
+    {
+        return 0;
+    }
+    matched = (found != negated);
+    return i + 1;
+}
+
+/// Match a single path component against a glob expression, in which `*` matches any
+/// sequence of characters, `?` matches one character, `[...]` matches a character class,
+/// and `\` escapes the next character.
+///
+/// Matching is greedy, and on a mismatch only backtracks to the most recent `*`:  the
+/// later `*` can absorb anything that an earlier one could, so earlier choices never
+/// need to be revisited.  This takes O(|pat| * |str|) time in the worst case, rather
+/// than time exponential in the number of `*` wildcards, for patterns such as
+/// `a*a*a*a*b`.
+constexpr bool glob_match(std::string_view pat, std::string_view str)
+{
+    constexpr std::size_t npos = std::string_view::npos;
+    std::size_t p = 0;
+    std::size_t s = 0;
+    // Pattern position after the most recent `*`, and the string position from which
+    // the rest of the pattern is being matched.
+    std::size_t star_p = npos;
+    std::size_t star_s = 0;
+    while (s < str.size())
+    {
+        if (p < pat.size())
+        {
+            if (pat[p] == '*')
+            {
+                while (p < pat.size() && pat[p] == '*')
+                {
+                    ++p;
+                }
+                star_p = p;
+                star_s = s;
+                continue;
+            }
+            if (pat[p] == '?')
+            {
+                ++p;
+                ++s;
+                continue;
+            }
+            bool matched = false;
+            const std::size_t length
+                = pat[p] == '[' ? match_bracket(pat.substr(p), str[s], matched) : 0;
+            if (length > 0 && matched)
+            {
+                p += length;
+                ++s;
+                continue;
+            }
+            // Otherwise, the character is matched literally; this includes an
+            // incomplete bracket expression.
+            const std::size_t literal = pat[p] == '\\' && p + 1 < pat.size() ? p + 1 : p;
+            if (length == 0 && pat[literal] == str[s])
+            {
+                p = literal + 1;
+                ++s;
+                continue;
+            }
+        }
+        // Mismatch:  let the most recent `*` absorb one more character.
+        if (star_p == npos)
+        {
+            return false;
+        }
+        p = star_p;
+        s = ++star_s;
+    }
+    while (p < pat.size() && pat[p] == '*')
+    {
+        ++p;
+    }
+    return p == pat.size();
+}
+
+} // end namespace 'co'
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+
+#include <codeowners/trace.hpp>
+
+/// Instrumentation is compiled in unless `CODEOWNERS_INSTRUMENTATION` is defined as 0, in
+/// which case every timer and counter compiles to nothing.
+#ifndef CODEOWNERS_INSTRUMENTATION
+#define CODEOWNERS_INSTRUMENTATION 1
+#endif
+
+namespace co
+{
+
+/// Phases of listing owners, which are timed by `phase_timer`.
+enum class phase
+{
+    DISCOVERY,  /// Repository discovery and locating the CODEOWNERS file.
+    SUBMODULES, /// Enumerating submodules.
+    PARSE,      /// Parsing the CODEOWNERS file.
+    COMPILE,    /// Building a ruleset.
+    TRAVERSAL,  /// Traversing the work tree, excluding matching and output.
+    MATCH,      /// Finding the rules that apply to files and directories.
+    OUTPUT      /// Formatting and writing results.
+};
+
+/// Events counted in the hot paths of listing owners.
+enum class counter
+{
+    DIRECTORIES_VISITED,    /// Directories encountered during traversal.
+    FILES_VISITED,          /// Files encountered during traversal.
+    FILES_MATCHED,          /// Files whose rule was looked up individually.
+    SUBTREES_DETERMINED,    /// Directories whose files all have the same owner.
+    RULES_EVALUATED,        /// Patterns matched against a path or path component.
+    DIRECTORY_CACHE_HITS,   /// Lookups answered by the per-directory cache.
+    DIRECTORY_CACHE_MISSES, /// Lookups that evaluated the directory's patterns.
+    SKIP_CHECKS             /// Directories checked against the traversal's skip predicate.
+};
+
+const char* to_string(phase p);
+const char* to_string(counter c);
+
+/**
+ * The instrumentation class holds process-wide phase timers and event counters, which are
+ * disabled until `enable()` is called.
+ *
+ * While disabled, recording an event costs one well-predicted branch; hot loops accumulate
+ * their counts locally, and record them once per call.  Counters are updated with relaxed
+ * atomic operations, so they may be recorded from several threads.
+ */
+class instrumentation
+{
+public:
+    static bool enabled() noexcept
+    {
+#if CODEOWNERS_INSTRUMENTATION
+        return s_enabled.load(std::memory_order_relaxed);
+#else
+        return false;
+#endif
+    }
+
+    /// Enable or disable recording.  Returns false if instrumentation is not compiled in.
+    static bool enable(bool on = true) noexcept;
+
+    static void add(counter c, std::uint64_t n = 1) noexcept
+    {
+        if (enabled())
+        {
+            s_counts[static_cast<std::size_t>(c)].fetch_add(n, std::memory_order_relaxed);
+        }
+    }
+
+    static void add(phase p, std::chrono::nanoseconds elapsed) noexcept
+    {
+        if (enabled())
+        {
+            s_times[static_cast<std::size_t>(p)].fetch_add(elapsed.count(),
+                                                           std::memory_order_relaxed);
+        }
+    }
+
+    static std::uint64_t count(counter c) noexcept;
+    static std::chrono::nanoseconds time(phase p) noexcept;
+
+    /// Set all timers and counters to zero.
+    static void reset() noexcept;
+
+    /// Write all timers and counters to `os`, one per line, leaving its formatting state
+    /// unchanged.
+    static std::ostream& report(std::ostream& os);
+
+private:
+    static constexpr std::size_t phase_count = static_cast<std::size_t>(phase::OUTPUT) + 1;
+    static constexpr std::size_t counter_count
+        = static_cast<std::size_t>(counter::SKIP_CHECKS) + 1;
+
+    static std::atomic<bool> s_enabled;
+    static std::array<std::atomic<std::int64_t>, phase_count> s_times;
+    static std::array<std::atomic<std::uint64_t>, counter_count> s_counts;
+};
+
+/**
+ * A phase_timer adds the time between its construction and destruction to a phase, if
+ * instrumentation is enabled.  Time is exclusive:  while a timer is active, time spent in
+ * timers created later on the same thread is attributed to their phases only.  For example,
+ * time spent matching within a traversal is not also counted as traversal time.
+ *
+ * If tracing is enabled, timers for the discovery, submodule, parse, compile and traversal
+ * phases also record a trace span, unless nested in a timer for the same phase.  Matching
+ * and output are timed per file, which is too fine-grained to trace.
+ */
+class phase_timer
+{
+public:
+    explicit phase_timer(phase p) noexcept
+    {
+        if (instrumentation::enabled() || tracer::enabled())
+        {
+            start(p);
+        }
+    }
+
+    phase_timer(const phase_timer&) = delete;
+    phase_timer& operator=(const phase_timer&) = delete;
+
+    ~phase_timer()
+    {
+        if (m_active)
+        {
+            stop();
+        }
+    }
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    void start(phase p) noexcept;
+    void stop() noexcept;
+
+    bool m_active = false;
+    phase m_phase = phase::DISCOVERY;
+    clock::time_point m_start;
+    /// Time spent in nested timers.
+    clock::duration m_nested = clock::duration::zero();
+    phase_timer* m_parent = nullptr;
+};
+
+} // end namespace 'co'
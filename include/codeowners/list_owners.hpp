@@ -0,0 +1,127 @@
+#pragma once
+
+#include <codeowners/filesystem.hpp>
+#include <codeowners/ruleset.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace co
+{
+
+/// Function deciding whether the files to which a rule (or no rule) applies are wanted.
+using rule_filter = std::function<bool(std::optional<ruleset::rule_id>)>;
+
+/// Function called by `for_each_owned_file` with each file, its path relative to the work
+/// directory (valid only during the call), and the rule that owns it.
+using owned_file_visitor = std::function<void(const fs::directory_entry&, std::string_view,
+                                              std::optional<ruleset::rule_id>)>;
+
+/**
+ * Call `visit` for each file within the directory `start_path`, recursively, with the rule
+ * that owns the file.  Directories themselves are not visited, and those equivalent to an
+ * element of `to_skip` are not descended into.  Files are matched by their path relative
+ * to `work_dir`, using `cursor`.
+ *
+ * When every file within a directory has the same owner, the ruleset reports this up front,
+ * and the files within the directory are not matched individually.
+ *
+ * If `wanted` is given, only the files whose rule (or lack of one) it accepts are visited,
+ * and a directory in which a rule that it rejects applies to every file is not descended
+ * into at all.
+ *
+ * This is the traversal performed by `ls-owners`.
+ */
+void for_each_owned_file(ruleset::cursor& cursor, const fs::path& work_dir,
+                         const fs::path& start_path, const std::vector<fs::path>& to_skip,
+                         const owned_file_visitor& visit, const rule_filter& wanted = {});
+
+/// Function called by `for_each_matched_file` with each file, every rule that matches it in
+/// increasing order, and the rule that owns it.
+using matched_file_visitor = std::function<void(const fs::directory_entry&,
+                                                const std::vector<ruleset::rule_id>&,
+                                                std::optional<ruleset::rule_id>)>;
+
+/**
+ * Call `visit` for each file within the directory `start_path`, recursively, with every
+ * rule that matches the file, as found by `ruleset::cursor::find_all`.  Directories
+ * equivalent to an element of `to_skip` are not descended into.  Files are matched by their
+ * path relative to `work_dir`, using `cursor`, which must have been created with
+ * `ruleset::match_mode::ALL`.
+ *
+ * Unlike `for_each_owned_file`, files are matched individually even within directories
+ * whose files all have the same owner, unless no rule can match there.
+ */
+void for_each_matched_file(ruleset::cursor& cursor, const fs::path& work_dir,
+                           const fs::path& start_path, const std::vector<fs::path>& to_skip,
+                           const matched_file_visitor& visit);
+
+/// Number of files that a rule matches, and the number of those to which it applies.
+struct rule_coverage_counts
+{
+    std::uint64_t matches = 0;
+    std::uint64_t wins = 0;
+};
+
+/**
+ * The rule_coverage class accumulates the number of files that each rule of a ruleset
+ * matches, and the number to which it applies, from the rules found for each file by
+ * `ruleset::cursor::find_all`.
+ *
+ * A rule that matches no file is dead for the recorded files, and a rule that matches files
+ * but applies to none of them is overridden by later rules wherever it matches.  Shadowed
+ * rules (see `ruleset::shadowed_rules`) are counted like others, so they match files but
+ * never apply.  Counts are stored densely, indexed by `ruleset::rule_id`, so recording a
+ * file costs one addition per matching rule.
+ *
+ * Accumulators are not thread-safe.  Concurrent workers should each use their own
+ * accumulator, and combine them with `merge()` once finished.
+ */
+class rule_coverage
+{
+public:
+    explicit rule_coverage(const ruleset& rules);
+
+    /// Record a file matched by the rules `matching`, in increasing order, of which rule
+    /// `id` (if any) applies to it.
+    void add(const std::vector<ruleset::rule_id>& matching, std::optional<ruleset::rule_id> id)
+    {
+        m_files += 1;
+        for (ruleset::rule_id match : matching)
+        {
+            m_counts[match].matches += 1;
+        }
+        if (!id)
+        {
+            m_unmatched += 1;
+            return;
+        }
+        m_counts[*id].wins += 1;
+    }
+
+    /// Add the counts accumulated by `other`, which must refer to the same ruleset.
+    void merge(const rule_coverage& other);
+
+    const rule_coverage_counts& counts(ruleset::rule_id id) const { return m_counts.at(id); }
+    /// Number of recorded files to which no rule applies.
+    std::uint64_t unmatched_files() const { return m_unmatched; }
+    /// Number of recorded files.
+    std::uint64_t files() const { return m_files; }
+
+    /// Write a tab-separated table of the source line, pattern, match count and win count
+    /// of each rule, in order of identifier, followed by the unmatched and overall file
+    /// counts.
+    friend std::ostream& operator<<(std::ostream& os, const rule_coverage& coverage);
+
+private:
+    const ruleset* m_ruleset;
+    std::vector<rule_coverage_counts> m_counts;
+    std::uint64_t m_unmatched = 0;
+    std::uint64_t m_files = 0;
+};
+
+} // end namespace 'co'
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <codeowners/codeowners.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace co
+{
+
+/**
+ * The codeowners_view class parses CODEOWNERS content in place.  Patterns and owners are
+ * views into the content, and are stored in a single token buffer, so that parsing performs
+ * a few amortized allocations (as the token and rule buffers grow) rather than one or more
+ * per rule.
+ *
+ * Lines, patterns, owners and comments are recognized exactly as by `parse`, and rules are
+ * annotated with the same line numbers.
+ */
+class codeowners_view
+{
+public:
+    /// A rule whose pattern and owners are views into the parsed content.
+    class rule_view
+    {
+    public:
+        std::int32_t line() const { return m_line; }
+        std::string_view file_pattern() const { return m_tokens[0]; }
+
+        const std::string_view* owners_begin() const { return m_tokens + 1; }
+        const std::string_view* owners_end() const { return m_tokens + m_size; }
+        std::size_t owner_count() const { return m_size - 1; }
+
+        /// Return the rule as an owning `ownership_rule`.
+        ownership_rule to_rule() const;
+
+    private:
+        friend class codeowners_view;
+
+        rule_view(std::int32_t line, const std::string_view* tokens, std::size_t size)
+            : m_line{line}
+            , m_tokens{tokens}
+            , m_size{size}
+        {
+        }
+
+        std::int32_t m_line;
+        /// The pattern, followed by the owners.
+        const std::string_view* m_tokens;
+        std::size_t m_size;
+    };
+
+    /// Parse `content`, which must outlive this object.
+    explicit codeowners_view(std::string_view content, std::string source_name = "");
+
+    /// Map the file at `path` into memory and parse it.  The mapping is held by this object.
+    /// Throws `file_not_found_error` if the file does not exist, or `error` if it cannot
+    /// be mapped.
+    static codeowners_view map(const fs::path& path, const std::string& source_name = "");
+
+    codeowners_view(codeowners_view&& other) noexcept;
+    codeowners_view& operator=(codeowners_view&& other) noexcept;
+    ~codeowners_view(); /* defaulted in cpp file */
+
+    const std::string& source_name() const { return m_source_name; }
+    const std::vector<rule_view>& rules() const { return m_rules; }
+    rule_source source(const rule_view& rule) const { return {m_source_name, rule.line()}; }
+
+    /// Return the rules as owning `annotated_rule` objects, as returned by `parse`.
+    std::vector<annotated_rule> to_annotated_rules() const;
+
+private:
+    class mapping;
+
+    codeowners_view(std::unique_ptr<mapping> map, std::string source_name);
+    void tokenize(std::string_view content);
+
+    std::unique_ptr<mapping> m_mapping;
+    std::string m_source_name;
+    std::vector<std::string_view> m_tokens;
+    std::vector<rule_view> m_rules;
+};
+
+/// Alternative to `parse(const fs::path&, const std::string&)` that maps the file into
+/// memory and scans it in place.
+std::vector<annotated_rule> parse_mapped(const fs::path& path,
+                                         const std::string& source_name = "");
+
+} // end namespace 'co'
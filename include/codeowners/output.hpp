@@ -0,0 +1,84 @@
+#pragma once
+
+#include "codeowners/codeowners.hpp"
+#include "codeowners/type_utils.hpp"
+
+#include <boost/noncopyable.hpp>
+
+#include <string_view>
+#include <vector>
+
+namespace co
+{
+
+enum class output_format
+{
+    TEXT,  /// `path:    owner1 owner2`, one record per line.
+    TSV,   /// `path<TAB>owner1 owner2`, with backslash escapes for tab, newline and backslash.
+    JSONL, /// `{"path":"...","owners":["..."]}`, one JSON object per line.
+    NUL    /// `path<NUL>owner1 owner2<NUL>`, suitable for `xargs -0` and similar tools.
+};
+
+/// Return the output format with the given name ("text", "tsv", "jsonl" or "nul").  Raises
+/// `co::error` if the name is not recognized.
+output_format parse_output_format(std::string_view name);
+
+/**
+ * The output_writer class formats (path, owners) records into a fixed-size byte buffer, and
+ * writes the buffer to a file descriptor with a single `write(2)` call whenever it fills up,
+ * or when `flush()` is called.
+ *
+ * The buffer is allocated once, at construction, so writing a record performs no heap
+ * allocation.  Records larger than the buffer are written in several pieces.
+ *
+ * Paths are written as bytes, except in JSON Lines, whose strings must be UTF-8:  there,
+ * each byte that is not part of well-formed UTF-8 is written as the escape `\u0080` to
+ * `\u00ff`, so that the output remains valid JSON.
+ *
+ * The destructor flushes any buffered output, but ignores errors; call `flush()` explicitly
+ * in order to detect write failures.
+ */
+class output_writer : public boost::noncopyable
+{
+public:
+    static constexpr std::size_t default_capacity = 1 << 16;
+
+    output_writer(int fd, output_format format, std::size_t capacity = default_capacity);
+    ~output_writer();
+
+    /// Write a record for `path`.  An empty `owners` container denotes an unowned path.
+    void write(std::string_view path, const std::vector<owner>& owners);
+    void write(std::string_view path, array_view<std::string_view> owners);
+
+    /// Write all buffered output to the file descriptor.  Raises `co::error` on failure.
+    void flush();
+
+    output_format format() const { return m_format; }
+    std::size_t capacity() const { return m_buffer.size(); }
+
+private:
+    void put(char c)
+    {
+        if (m_size == m_buffer.size())
+        {
+            flush();
+        }
+        m_buffer[m_size++] = c;
+    }
+
+    void begin_record(std::string_view path, bool unowned);
+    void append_owner(std::string_view name, bool first);
+    void end_record();
+
+    void append(std::string_view s);
+    void append_escaped(std::string_view s);
+    void append_json_string(std::string_view s);
+
+private:
+    int m_fd;
+    output_format m_format;
+    std::vector<char> m_buffer;
+    std::size_t m_size;
+};
+
+} // end namespace 'co'
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "codeowners/ruleset.hpp"
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace co
+{
+
+/// The rules of two versions of a CODEOWNERS file that are not common to both, found as the
+/// complement of a longest common subsequence of rules with equal patterns and owners.
+struct rule_diff
+{
+    /// Rules of the old version, in order of identifier.
+    std::vector<ruleset::rule_id> removed;
+    /// Rules of the new version, in order of identifier.
+    std::vector<ruleset::rule_id> added;
+};
+
+/// Return the rules that differ between `old_rules` and `new_rules`.  Source lines are not
+/// compared, so moving rules by adding comments changes nothing.
+rule_diff diff_rules(const ruleset& old_rules, const ruleset& new_rules);
+
+/// A path whose owners differ between two versions of a CODEOWNERS file.
+struct ownership_change
+{
+    std::string path;
+    std::optional<ruleset::rule_id> old_rule;
+    std::optional<ruleset::rule_id> new_rule;
+};
+
+/**
+ * The ownership_diff class finds the paths whose owners differ between two versions of a
+ * CODEOWNERS file, without matching every path against both versions.
+ *
+ * The rules common to both versions appear in the same relative order in each, so a path
+ * that matches none of the removed or added rules has the same last matching rule in both
+ * versions.  Paths are therefore first matched against the removed and added rules only,
+ * which are usually few, and the paths that match one of them are then matched against
+ * both versions, whose owners are compared as sets.
+ *
+ * A diff refers to both rulesets, which must outlive it.  It uses cursors, so paths sharing
+ * parent directories are matched fastest, and a diff must not be used by several threads
+ * concurrently.
+ */
+class ownership_diff
+{
+public:
+    ownership_diff(const ruleset& old_rules, const ruleset& new_rules);
+    ownership_diff(ownership_diff&& other) noexcept;
+    ownership_diff& operator=(ownership_diff&& other) noexcept;
+    ~ownership_diff(); /* defaulted in cpp file */
+
+    const ruleset& old_rules() const { return *m_old; }
+    const ruleset& new_rules() const { return *m_new; }
+    const rule_diff& changed_rules() const { return m_diff; }
+
+    /// Return whether the owners of some file within the relative directory `dir` may
+    /// differ, that is, whether a removed or added rule may match such a file.
+    bool may_change_within(const fs::path& dir);
+
+    /// Return the change of owners of the file at relative path `path`, if they differ.
+    std::optional<ownership_change> compare(const fs::path& path);
+
+    /// Compare the owners of the given relative paths, such as the entries of the git
+    /// index, and return those that differ, in order.
+    template <typename InputIt> std::vector<ownership_change> compare(InputIt begin, InputIt end)
+    {
+        std::vector<ownership_change> changes;
+        for (; begin != end; ++begin)
+        {
+            if (auto change = compare(*begin))
+            {
+                changes.push_back(std::move(*change));
+            }
+        }
+        return changes;
+    }
+
+    /// Number of paths compared, and the number of those matched against both versions.
+    struct comparison_counts
+    {
+        std::uint64_t paths;
+        std::uint64_t candidates;
+    };
+    comparison_counts counts() const { return m_counts; }
+
+private:
+    struct impl;
+
+    const ruleset* m_old;
+    const ruleset* m_new;
+    rule_diff m_diff;
+    std::unique_ptr<impl> m_impl;
+    comparison_counts m_counts{};
+};
+
+/**
+ * Return the changes of owners of the files within the directory `start_path`, recursively,
+ * or of the file `start_path`, with paths relative to `work_dir`.  Directories equivalent to
+ * an element of `to_skip` are not descended into, nor are directories in which no removed
+ * or added rule can match a file, so most of an unaffected tree is never listed.
+ */
+std::vector<ownership_change> find_ownership_changes(ownership_diff& diff,
+                                                     const fs::path& work_dir,
+                                                     const fs::path& start_path,
+                                                     const std::vector<fs::path>& to_skip);
+
+/// Write a tab-separated table of the path, old owners and new owners of each change, with
+/// owners separated by spaces.
+std::ostream& write_ownership_changes(std::ostream& os, const ownership_diff& diff,
+                                      const std::vector<ownership_change>& changes);
+
+} // end namespace 'co'
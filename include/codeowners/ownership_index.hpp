@@ -0,0 +1,91 @@
+#pragma once
+
+#include "codeowners/ruleset.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace co
+{
+
+/**
+ * The ownership_index class answers owner-to-files queries over a fixed set of paths, such
+ * as the entries of the git index or a snapshot of a directory tree.
+ *
+ * Paths are added once, with the rule that applies to each, and are appended to that
+ * rule's posting list.  A query for an owner only reads the posting lists of the rules
+ * that name the owner, so repeated queries for different owners cost time proportional to
+ * the number of files returned, rather than to the number of paths.
+ *
+ * An index refers to its ruleset, which must outlive it.
+ */
+class ownership_index
+{
+public:
+    /// Identifies a path by its position in the order in which paths were added.
+    using path_id = std::uint32_t;
+
+    explicit ownership_index(const ruleset& rules);
+
+    /// Add the relative paths in [`begin`, `end`), matching them in a single pass with a
+    /// cursor.  Sorted paths, as listed by the git index, are matched fastest.
+    template <typename InputIt>
+    ownership_index(const ruleset& rules, InputIt begin, InputIt end)
+        : ownership_index(rules)
+    {
+        ruleset::cursor cursor{rules};
+        for (; begin != end; ++begin)
+        {
+            const fs::path& path = *begin;
+            add(path.native(), cursor.find(path));
+        }
+    }
+
+    /// Record `path`, to which rule `id` applies (if any), and return its identifier.
+    /// Throws `co::error` if the index already holds the maximum number of paths.
+    path_id add(std::string_view path, std::optional<ruleset::rule_id> id);
+
+    /// Number of paths added.
+    std::size_t size() const { return m_path_ends.size(); }
+    /// Return the path with identifier `id`.
+    std::string_view path(path_id id) const;
+    /// Return the rule that applies to the path with identifier `id`, if any.
+    std::optional<ruleset::rule_id> rule(path_id id) const;
+
+    /// Return the paths to which rule `id` applies, in the order they were added.
+    const std::vector<path_id>& rule_files(ruleset::rule_id id) const
+    {
+        return m_postings.at(id);
+    }
+
+    /// Return the paths owned by owner `id`, in the order they were added.
+    std::vector<path_id> files_owned_by(ruleset::owner_id id) const;
+    /// Return the paths owned by the owner named `name`, or no paths if no rule names it.
+    std::vector<path_id> files_owned_by(std::string_view name) const;
+    /// Return the paths owned by any of the owners named in `names`, each once, in the order
+    /// they were added.  Names that no rule names are ignored.
+    std::vector<path_id> files_owned_by_any(const std::vector<std::string>& names) const;
+    /// Return the paths to which no rule, or a rule without owners, applies.
+    std::vector<path_id> unowned_files() const;
+
+private:
+    std::vector<path_id> merge_postings(const std::vector<ruleset::rule_id>& rules) const;
+
+    const ruleset* m_ruleset;
+    /// All paths, concatenated, and the end offset of each in `m_paths`.
+    std::string m_paths;
+    std::vector<std::size_t> m_path_ends;
+    /// Rule of each path, or `no_rule`.
+    std::vector<ruleset::rule_id> m_path_rules;
+    /// Paths to which each rule applies, in increasing order.
+    std::vector<std::vector<path_id>> m_postings;
+    /// Paths to which no rule applies, in increasing order.
+    std::vector<path_id> m_unmatched;
+    /// Rules that name each owner, in increasing order.
+    std::vector<std::vector<ruleset::rule_id>> m_owner_rules;
+};
+
+} // end namespace 'co'
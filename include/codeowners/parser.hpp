@@ -2,6 +2,8 @@
 
 #include <codeowners/codeowners.hpp>
 
+#include <boost/tokenizer.hpp>
+
 #include <range/v3/view/enumerate.hpp>
 #include <range/v3/view/filter.hpp>
 #include <range/v3/view/subrange.hpp>
@@ -1,4 +1,5 @@
 #include <codeowners/filesystem.hpp>
+#include <codeowners/instrumentation.hpp>
 
 #include <range/v3/view/subrange.hpp>
 #include <range/v3/view/transform.hpp>
@@ -8,7 +9,8 @@
 namespace co
 {
 
-ranges::subrange<fs::recursive_directory_iterator> make_file_range(const fs::path& start_point)
+inline ranges::subrange<fs::recursive_directory_iterator>
+make_file_range(const fs::path& start_point)
 {
     return ranges::make_subrange(fs::recursive_directory_iterator{start_point},
                                  fs::recursive_directory_iterator{});
@@ -50,12 +52,20 @@ public:
         advance_to_next_unskipped();
     }
 
+    /// Do not descend into the directory at the current position, if it is one.
+    void no_push() { base_reference().no_push(); }
+
 private:
     friend class boost::iterator_core_access;
 
     bool should_skip(const fs::directory_entry& dir_ent) const
     {
-        return fs::is_directory(dir_ent) && !m_predicate(dir_ent);
+        if (!fs::is_directory(dir_ent))
+        {
+            return false;
+        }
+        instrumentation::add(counter::SKIP_CHECKS);
+        return !m_predicate(dir_ent);
     }
 
     void increment()
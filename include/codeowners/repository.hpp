@@ -6,6 +6,7 @@
 
 #include <memory>
 #include <optional>
+#include <string>
 #include <vector>
 
 namespace co
@@ -50,6 +51,11 @@ public:
 
     std::vector<fs::path> submodule_paths() const;
 
+    /// Return the contents of the file named by `revision`, in any form understood by
+    /// `git rev-parse`, such as `HEAD~1:.github/CODEOWNERS`.  Throws `co::error` if the
+    /// revision cannot be resolved, or does not name a file.
+    std::string read_blob(const std::string& revision) const;
+
 private:
     friend class index;
 
@@ -1,19 +1,47 @@
 #pragma once
 
 #include "codeowners/codeowners.hpp"
+#include "codeowners/type_utils.hpp"
 
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <string_view>
 #include <vector>
 
 namespace co
 {
 
 template <typename T> class pattern_map;
+class arena;
+class compiled_pattern;
 
+/**
+ * The ruleset class holds an immutable sequence of rules, and finds the rule that applies
+ * to a path.
+ *
+ * Owner names, source names, owner lists and rule records are copied into a single arena
+ * allocation when the ruleset is constructed, and are released together when it is
+ * destroyed.  The patterns of rules are kept once, by the structures used for matching,
+ * which also keep the patterns in compiled form; only those of shadowed rules, which are
+ * not matched, are copied into the arena.
+ */
 class ruleset
 {
 public:
-    ruleset(const std::vector<annotated_rule>& rules);
-    ruleset(std::vector<annotated_rule>&& rules);
+    /// Identifies a rule by its position in the list of rules.
+    using rule_id = std::size_t;
+    /// Identifies a distinct owner by its position in `owners()`.
+    using owner_id = std::size_t;
+
+    /// Compile `rules`.  The patterns of large rulesets are compiled in shards on up to
+    /// `compile_threads` threads, or on one thread per hardware thread if it is zero.
+    ruleset(const std::vector<annotated_rule>& rules, std::size_t compile_threads = 0);
+    ruleset(std::vector<annotated_rule>&& rules, std::size_t compile_threads = 0);
+    ruleset(ruleset&& other) noexcept;
+    ruleset& operator=(ruleset&& other) noexcept;
     ~ruleset(); /* defaulted in cpp file */
 
     template <typename InputIt>
@@ -24,8 +52,186 @@ public:
 
     std::optional<annotated_rule> apply(const fs::path& fs) const;
 
+    /// Return the identifier of the rule that applies to `path`, if any.
+    std::optional<rule_id> find(const fs::path& path) const;
+
+    /// Ownership shared by every file within a directory; see `find_subtree`.
+    struct subtree_match
+    {
+        /// Whether the same rule, or no rule, applies to every file within the directory.
+        bool determined;
+        /// The rule that applies to every file, if `determined`.
+        std::optional<rule_id> rule;
+    };
+
+    /// Determine whether a single rule (or no rule) applies to every file within the
+    /// relative directory `dir`, so that files within it need not be matched individually.
+    /// The analysis is conservative:  some directories with uniform ownership may be
+    /// reported as not determined.
+    subtree_match find_subtree(const fs::path& dir) const;
+
+    /// Effectiveness of the per-directory cache used by `find` and `apply`:  a miss means
+    /// the rules that depend only on a file's directory were evaluated for a new directory.
+    /// The cache is locked on every lookup, so concurrent calls to `find` on the same
+    /// ruleset serialize; cursors do not use it.
+    struct cache_statistics
+    {
+        std::uint64_t hits;
+        std::uint64_t misses;
+    };
+    cache_statistics directory_cache_statistics() const;
+
+    /// Matching statistics of one rule, recorded while profiling is enabled.
+    struct rule_profile
+    {
+        rule_id id;
+        /// Number of times the rule's pattern was evaluated against a path, or against a
+        /// directory or path component.
+        std::uint64_t evaluations;
+        /// Number of lookups (of a file, or of a directory by `find_subtree`) whose result
+        /// was the rule.  Lookups answered from the per-directory cache are included.
+        std::uint64_t wins;
+        /// Time spent evaluating the rule's pattern, including the cost of timing it.
+        std::chrono::nanoseconds time;
+    };
+
+    /// Start recording per-rule statistics, with zeroed counts, for lookups by this ruleset
+    /// and by cursors created afterwards; or stop recording.  Profiling makes lookups
+    /// several times slower.  Returns false if profiling is not compiled in, that is, if
+    /// `CODEOWNERS_INSTRUMENTATION` is defined as 0.
+    bool enable_profiling(bool on = true);
+
+    /// Return the statistics of every rule, in order of source line, or an empty vector if
+    /// profiling is not enabled.  Shadowed rules (see `shadowed_rules`) are never
+    /// evaluated.
+    std::vector<rule_profile> profile() const;
+
+    /// A rule that never applies to any file, because a later rule, which takes precedence,
+    /// matches every file that it matches.
+    struct shadowed_rule
+    {
+        rule_id id;
+        /// The nearest later rule found to match every file that rule `id` matches.
+        rule_id shadowed_by;
+    };
+
+    /// Return the rules that are shadowed by later rules, in order of identifier.  Shadowed
+    /// rules are excluded from matching when the ruleset is constructed, but remain
+    /// available through `rule()` and the other accessors.  The analysis is conservative:
+    /// it finds repeated patterns, rules followed by a rule matching every path (such as
+    /// `*`), and rules followed by a rule matching everything within a directory that
+    /// contains all of their files (such as `/docs/*.md` followed by `/docs/`).
+    const std::vector<shadowed_rule>& shadowed_rules() const { return m_shadowed; }
+
+    /// A rule that is ignored, because its pattern cannot be compiled.
+    struct skipped_rule
+    {
+        rule_id id;
+        /// Why the pattern cannot be compiled.
+        std::string reason;
+    };
+
+    /// Return the rules whose patterns cannot be compiled, such as patterns with more than
+    /// 63 path segments, in order of identifier.  Such rules match no path, but remain
+    /// available through `rule()` and the other accessors.
+    const std::vector<skipped_rule>& skipped_rules() const { return m_skipped; }
+
+    /// Return the rules, in order of identifier, whose patterns match some path that `pat`
+    /// also matches, such as the rules that a proposed new rule would override for some
+    /// files.  Shadowed rules are not included.  The answer is found by intersecting the
+    /// patterns' automata, without enumerating files.  Throws `co::error` if `pat` cannot
+    /// be compiled.
+    std::vector<rule_id> overlapping_rules(const pattern& pat) const;
+
+    /// The lookups supported by a cursor.
+    enum class match_mode
+    {
+        LAST, /// Only the rule that applies to each path is found.
+        ALL   /// Every rule that matches each path can also be found, with `find_all`.
+    };
+
+    /**
+     * A cursor looks up the rules for a series of paths, retaining matching state for the
+     * parent directories of the previous path.  Paths that share parent directories with
+     * the previous path, as in sorted listings or depth-first traversals, are matched by
+     * processing only their remaining components.  Results are the same as for
+     * `ruleset::find` and `ruleset::find_subtree`, for any order of paths.
+     *
+     * A cursor created with `match_mode::ALL` also finds every rule that matches a path,
+     * in the same pass over the rules as the rule that applies.  Since rules overridden
+     * within a directory are kept, `find_subtree` determines fewer directories.
+     *
+     * A cursor refers to its ruleset, which must outlive it.  A cursor must not be used
+     * by several threads concurrently.
+     */
+    class cursor
+    {
+    public:
+        explicit cursor(const ruleset& rules, match_mode mode = match_mode::LAST);
+        cursor(cursor&& other) noexcept;
+        cursor& operator=(cursor&& other) noexcept;
+        ~cursor(); /* defaulted in cpp file */
+
+        std::optional<rule_id> find(const fs::path& path);
+        subtree_match find_subtree(const fs::path& dir);
+
+        /// Replace the contents of `matching` with the identifiers of every rule that
+        /// matches `path`, in increasing order, and return the rule that applies.  Shadowed
+        /// rules that match are included, so the rule that applies is the last matching
+        /// rule that is not shadowed.  Throws `co::error` if the cursor was not created
+        /// with `match_mode::ALL`.
+        std::optional<rule_id> find_all(const fs::path& path, std::vector<rule_id>& matching);
+
+    private:
+        struct impl;
+        std::unique_ptr<impl> m_impl;
+    };
+
+    /// Number of rules.
+    std::size_t size() const { return m_size; }
+    /// Return a copy of a rule.  Throws `std::out_of_range` if `id` is not a valid rule.
+    annotated_rule rule(rule_id id) const;
+
+    /// Return the names of the distinct owners named by any rule, in order of first
+    /// appearance.
+    array_view<std::string_view> owners() const { return {m_owner_names, m_owner_count}; }
+    /// Return the identifiers of the owners of a rule.
+    array_view<owner_id> owner_ids(rule_id id) const;
+    /// Return the names of the owners of a rule.
+    array_view<std::string_view> owner_names(rule_id id) const;
+
 private:
-    std::unique_ptr<pattern_map<annotated_rule>> m_rule_map;
+    struct rule_record;
+
+    const rule_record& record(rule_id id) const;
+
+    std::unique_ptr<arena> m_arena;
+    /// Records of all rules, in the arena.
+    const rule_record* m_records;
+    std::size_t m_size;
+    /// Names of the distinct owners, in the arena.
+    const std::string_view* m_owner_names;
+    std::size_t m_owner_count;
+    std::vector<shadowed_rule> m_shadowed;
+    std::vector<skipped_rule> m_skipped;
+    /// Patterns of all rules that are not shadowed.
+    std::unique_ptr<pattern_map<rule_id>> m_rule_map;
+    /// Compiled patterns of the shadowed rules, in the order of `m_shadowed`.
+    std::unique_ptr<std::vector<compiled_pattern>> m_shadowed_patterns;
 };
 
-} // end namespace 'co'
\ No newline at end of file
+/// Write a tab-separated table of the source line, pattern, evaluation count, win count
+/// and evaluation time in microseconds of each rule in `profile`, in the given order.
+std::ostream& write_rule_profile(std::ostream& os, const ruleset& rules,
+                                 const std::vector<ruleset::rule_profile>& profile);
+
+/// Write a tab-separated table of the source line and pattern of each shadowed rule of
+/// `rules`, followed by those of the later rule that shadows it.
+std::ostream& write_shadowed_rules(std::ostream& os, const ruleset& rules);
+
+/// Write a tab-separated table of the source line, pattern and space-separated owners of
+/// each rule of `rules` that matches some path that `pat` also matches; see
+/// `ruleset::overlapping_rules`.
+std::ostream& write_overlapping_rules(std::ostream& os, const ruleset& rules, const pattern& pat);
+
+} // end namespace 'co'
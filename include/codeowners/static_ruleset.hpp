@@ -0,0 +1,229 @@
+#pragma once
+
+#include "codeowners/glob.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace co
+{
+
+/*
+ * Support for rulesets generated at build time by `codeowners-codegen` (see `codegen.hpp`).
+ *
+ * A generated header holds the rules, owners and a `find` function in `constexpr` tables,
+ * with one matcher per rule, whose type is specialized for the kind of the rule's pattern.
+ * Matching gives the same results as `ruleset::find` for normalized relative paths:
+ * non-empty paths whose components are separated by single slashes, without `.` or empty
+ * components, and without leading or trailing slashes.
+ */
+
+/// A rule of a generated ruleset.  Its owners are `owner_count` consecutive entries of the
+/// generated `owner_ids` table, starting at `first_owner`.
+struct static_rule
+{
+    std::int32_t line;
+    std::string_view pattern;
+    std::size_t first_owner;
+    std::size_t owner_count;
+};
+
+/// Return the final component of a path.
+constexpr std::string_view file_name(std::string_view path)
+{
+    const auto slash = path.rfind('/');
+    return slash == std::string_view::npos ? path : path.substr(slash + 1);
+}
+
+/// Matches every path:  `*`, `**`.
+struct universal_matcher
+{
+    constexpr bool matches(std::string_view, std::string_view) const { return true; }
+};
+
+/// Matches files whose name ends with a literal suffix:  `*.md`.
+struct suffix_matcher
+{
+    std::string_view suffix;
+
+    constexpr bool matches(std::string_view, std::string_view name) const
+    {
+        return name.size() >= suffix.size()
+            && name.substr(name.size() - suffix.size()) == suffix;
+    }
+};
+
+/// Matches files whose name matches a glob expression:  `*.t.?pp`, `README*`.
+struct name_matcher
+{
+    std::string_view glob;
+
+    constexpr bool matches(std::string_view, std::string_view name) const
+    {
+        return glob_match(glob, name);
+    }
+};
+
+/// Matches paths with a directory component equal to `component`, or, unless
+/// `directory_only`, whose name is equal to it:  `docs/`, `Makefile`.
+struct component_matcher
+{
+    std::string_view component;
+    bool directory_only;
+
+    constexpr bool matches(std::string_view path, std::string_view name) const
+    {
+        if (!directory_only && name == component)
+        {
+            return true;
+        }
+        const std::string_view dirs = path.substr(0, path.size() - name.size());
+        for (std::size_t pos = 0; pos < dirs.size();)
+        {
+            const auto slash = dirs.find('/', pos);
+            if (dirs.substr(pos, slash - pos) == component)
+            {
+                return true;
+            }
+            pos = slash + 1;
+        }
+        return false;
+    }
+};
+
+/// Matches everything within the directory at relative path `prefix`, and, unless
+/// `directory_only`, the file at that path:  `/docs/`, `/src/main.cpp`.
+struct prefix_matcher
+{
+    std::string_view prefix;
+    bool directory_only;
+
+    constexpr bool matches(std::string_view path, std::string_view) const
+    {
+        if (path.size() <= prefix.size())
+        {
+            return !directory_only && path == prefix;
+        }
+        return path[prefix.size()] == '/' && path.substr(0, prefix.size()) == prefix;
+    }
+};
+
+/// Matches files directly within the directory at relative path `prefix`, whose name
+/// matches a glob expression:  `/src/*`, `/src/*.py`.
+struct child_matcher
+{
+    std::string_view prefix;
+    std::string_view glob;
+
+    constexpr bool matches(std::string_view path, std::string_view name) const
+    {
+        return path.size() == prefix.size() + 1 + name.size() && path[prefix.size()] == '/'
+            && path.substr(0, prefix.size()) == prefix && glob_match(glob, name);
+    }
+};
+
+/// Matches files at any depth within the directory at relative path `prefix`, whose name
+/// matches a glob expression:  `/src/**/*.py`.
+struct descendant_matcher
+{
+    std::string_view prefix;
+    std::string_view glob;
+
+    constexpr bool matches(std::string_view path, std::string_view name) const
+    {
+        return path.size() > prefix.size() + name.size() && path[prefix.size()] == '/'
+            && path.substr(0, prefix.size()) == prefix && glob_match(glob, name);
+    }
+};
+
+enum class static_segment_kind
+{
+    LITERAL,  /// Matches one path component exactly.
+    STAR,     /// `*`:  matches any one path component.
+    GLOB,     /// Matches one path component, using wildcards.
+    ANY_DIRS, /// `**`:  matches zero or more path components.
+};
+
+struct static_segment
+{
+    static_segment_kind kind;
+    std::string_view text;
+};
+
+/// Matches any other pattern, given as segments, in the same way as `compiled_pattern`:
+/// by tracking the set of pattern positions consistent with the components consumed.
+template <std::size_t N> struct segments_matcher
+{
+    static_assert(N < 64, "Patterns have at most 63 segments");
+    using state_type = std::uint64_t;
+
+    std::array<static_segment, N> segments;
+    bool directory_only;
+    bool matches_contents;
+
+    constexpr bool matches(std::string_view path, std::string_view) const
+    {
+        constexpr state_type accepting = state_type{1} << N;
+        state_type state = closure(1);
+        for (std::size_t pos = 0;;)
+        {
+            // The components consumed so far name a parent directory of the path.
+            if ((state & accepting) && matches_contents)
+            {
+                return true;
+            }
+            const auto slash = path.find('/', pos);
+            state = step(state, path.substr(pos, slash - pos));
+            if (slash == std::string_view::npos)
+            {
+                return (state & accepting) && !directory_only;
+            }
+            if (!state)
+            {
+                return false;
+            }
+            pos = slash + 1;
+        }
+    }
+
+private:
+    constexpr state_type closure(state_type state) const
+    {
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            if ((state >> i & 1) && segments[i].kind == static_segment_kind::ANY_DIRS)
+            {
+                state |= state_type{1} << (i + 1);
+            }
+        }
+        return state;
+    }
+
+    constexpr state_type step(state_type state, std::string_view component) const
+    {
+        state_type next = 0;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            if (!(state >> i & 1))
+            {
+                continue;
+            }
+            const static_segment& seg = segments[i];
+            if (seg.kind == static_segment_kind::ANY_DIRS)
+            {
+                next |= state_type{1} << i;
+            }
+            else if (seg.kind == static_segment_kind::STAR
+                     || (seg.kind == static_segment_kind::LITERAL && component == seg.text)
+                     || (seg.kind == static_segment_kind::GLOB && glob_match(seg.text, component)))
+            {
+                next |= state_type{1} << (i + 1);
+            }
+        }
+        return closure(next);
+    }
+};
+
+} // end namespace 'co'
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "codeowners/ruleset.hpp"
+
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <vector>
+
+namespace co
+{
+
+/// File count and total size of a set of files.
+struct ownership_totals
+{
+    std::uint64_t files = 0;
+    std::uint64_t bytes = 0;
+
+    ownership_totals& operator+=(const ownership_totals& other)
+    {
+        files += other.files;
+        bytes += other.bytes;
+        return *this;
+    }
+};
+
+/**
+ * The ownership_statistics class accumulates the number of files, and their total size,
+ * belonging to each owner of a ruleset.
+ *
+ * Totals are stored densely, indexed by `ruleset::owner_id`, so recording a file costs one
+ * addition per owner of the matching rule.  A file whose rule names several owners is
+ * counted once for each of them.  Files without a matching rule, or whose rule has no
+ * owners, are counted as unowned.
+ *
+ * Sizes are optional, since finding them costs a `stat` call per file that counting files
+ * does not need.  Without them, the table omits the size column.
+ *
+ * Accumulators are not thread-safe.  Concurrent workers should each use their own
+ * accumulator, and combine them with `merge()` once finished.
+ */
+class ownership_statistics
+{
+public:
+    explicit ownership_statistics(const ruleset& rules, bool with_bytes = true);
+
+    /// Whether the sizes of files are recorded, and written in the table.
+    bool with_bytes() const { return m_with_bytes; }
+
+    /// Record a file of size `bytes`, to which rule `id` applies (if any).
+    void add(std::optional<ruleset::rule_id> id, std::uint64_t bytes = 0)
+    {
+        m_total.files += 1;
+        m_total.bytes += bytes;
+
+        const ownership_totals file_totals{1, bytes};
+        if (!id || m_ruleset->owner_ids(*id).empty())
+        {
+            m_unowned += file_totals;
+            return;
+        }
+        for (ruleset::owner_id oid : m_ruleset->owner_ids(*id))
+        {
+            m_owner_totals[oid] += file_totals;
+        }
+    }
+
+    /// Add the totals accumulated by `other`, which must refer to the same ruleset.
+    void merge(const ownership_statistics& other);
+
+    const ownership_totals& owner_totals(ruleset::owner_id id) const
+    {
+        return m_owner_totals.at(id);
+    }
+    const ownership_totals& unowned_totals() const { return m_unowned; }
+    /// Totals over all recorded files, each counted once.
+    const ownership_totals& overall_totals() const { return m_total; }
+
+    /// Write a tab-separated table of owner, file count and (if recorded) size, in
+    /// descending order of file count, followed by unowned and overall totals.
+    friend std::ostream& operator<<(std::ostream& os, const ownership_statistics& stats);
+
+private:
+    const ruleset* m_ruleset;
+    bool m_with_bytes;
+    std::vector<ownership_totals> m_owner_totals;
+    ownership_totals m_unowned;
+    ownership_totals m_total;
+};
+
+} // end namespace 'co'
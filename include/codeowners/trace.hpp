@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <utility>
+
+// As in instrumentation.hpp, which includes this header:  tracing is compiled in unless
+// `CODEOWNERS_INSTRUMENTATION` is defined as 0.
+#ifndef CODEOWNERS_INSTRUMENTATION
+#define CODEOWNERS_INSTRUMENTATION 1
+#endif
+
+namespace co
+{
+
+/// A completed span of work on one thread, with up to three numeric arguments.
+struct trace_event
+{
+    const char* name;
+    const char* category;
+    std::chrono::steady_clock::time_point begin;
+    std::chrono::steady_clock::time_point end;
+    /// Optional description, such as a directory path.
+    std::string detail;
+    std::array<std::pair<const char*, std::int64_t>, 3> args;
+    std::size_t arg_count = 0;
+};
+
+/**
+ * The tracer class collects spans from all threads, for viewing in a trace viewer such as
+ * `chrome://tracing` or Perfetto.  It is disabled until `enable()` is called.
+ *
+ * Each thread appends events to its own buffer, without locking; a thread's buffer is
+ * registered, under a mutex, when the thread first records an event.  Buffers outlive their
+ * threads.  `write_chrome_json` and `clear` must only be called while no thread is
+ * recording, for example after worker threads have been joined.
+ */
+class tracer
+{
+public:
+    static bool enabled() noexcept
+    {
+#if CODEOWNERS_INSTRUMENTATION
+        return s_enabled.load(std::memory_order_relaxed);
+#else
+        return false;
+#endif
+    }
+
+    /// Enable or disable tracing.  Returns false if tracing is not compiled in, that is, if
+    /// `CODEOWNERS_INSTRUMENTATION` is defined as 0.
+    static bool enable(bool on = true) noexcept;
+
+    /// Append an event to the calling thread's buffer, if tracing is enabled.  The event is
+    /// dropped if memory cannot be allocated.
+    static void record(trace_event&& event) noexcept;
+
+    /// Write all recorded events in Chrome trace-event JSON format.
+    static std::ostream& write_chrome_json(std::ostream& os);
+
+    /// Discard all recorded events.
+    static void clear();
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+/**
+ * A trace_span records an event spanning its lifetime, if tracing was enabled at
+ * construction.  `name` and `category`, and the names of arguments, must be string
+ * literals or otherwise outlive the tracer's buffers.
+ */
+class trace_span
+{
+public:
+    trace_span(const char* name, const char* category)
+    {
+        if (tracer::enabled())
+        {
+            m_active = true;
+            m_event.name = name;
+            m_event.category = category;
+            m_event.begin = std::chrono::steady_clock::now();
+        }
+    }
+
+    trace_span(const trace_span&) = delete;
+    trace_span& operator=(const trace_span&) = delete;
+
+    ~trace_span()
+    {
+        if (m_active)
+        {
+            m_event.end = std::chrono::steady_clock::now();
+            tracer::record(std::move(m_event));
+        }
+    }
+
+    bool active() const { return m_active; }
+
+    void set_detail(std::string detail)
+    {
+        if (m_active)
+        {
+            m_event.detail = std::move(detail);
+        }
+    }
+
+    /// Add a numeric argument; arguments beyond the third are ignored.
+    void add_arg(const char* name, std::int64_t value)
+    {
+        if (m_active && m_event.arg_count < m_event.args.size())
+        {
+            m_event.args[m_event.arg_count++] = {name, value};
+        }
+    }
+
+private:
+    bool m_active = false;
+    trace_event m_event{};
+};
+
+} // end namespace 'co'
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
 #include <iosfwd>
 #include <memory>
+#include <vector>
 
 namespace co
 {
@@ -34,4 +37,38 @@ struct is_istreamable<T, std::void_t<decltype(std::declval<std::istream&>() >> s
 
 template <typename T> constexpr bool is_istreamable_v = is_istreamable<T>::value;
 
+/// Read-only view of a contiguous sequence of objects owned elsewhere.
+template <typename T> class array_view
+{
+public:
+    using value_type = T;
+    using iterator = const T*;
+    using const_iterator = const T*;
+
+    constexpr array_view() = default;
+    constexpr array_view(const T* first, std::size_t size)
+        : m_first{first}
+        , m_size{size}
+    {
+    }
+
+    constexpr const T* begin() const { return m_first; }
+    constexpr const T* end() const { return m_first + m_size; }
+    constexpr std::size_t size() const { return m_size; }
+    constexpr bool empty() const { return m_size == 0; }
+    constexpr const T& operator[](std::size_t i) const { return m_first[i]; }
+
+    std::vector<T> to_vector() const { return std::vector<T>(begin(), end()); }
+
+    friend bool operator==(array_view lhs, array_view rhs)
+    {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+    friend bool operator!=(array_view lhs, array_view rhs) { return !(lhs == rhs); }
+
+private:
+    const T* m_first = nullptr;
+    std::size_t m_size = 0;
+};
+
 } // end namespace 'co'
\ No newline at end of file
@@ -0,0 +1,120 @@
+#include <codeowners/allocation_counter.hpp>
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace co
+{
+
+namespace
+{
+    /// Counts of the calling thread.  The type is trivial, so that it can be used by the
+    /// allocation functions without dynamic initialization.
+    thread_local allocation_counts thread_allocations;
+
+    void* allocate(std::size_t size, std::size_t alignment) noexcept
+    {
+        // `malloc(0)` may return null, which would mean failure to callers.
+        size = size == 0 ? 1 : size;
+        void* p = nullptr;
+        if (alignment <= alignof(std::max_align_t))
+        {
+            p = std::malloc(size);
+        }
+        else
+        {
+            // `aligned_alloc` requires the size to be a multiple of the alignment.
+            p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+        }
+        if (p)
+        {
+            ++thread_allocations.allocations;
+            thread_allocations.bytes += size;
+        }
+        return p;
+    }
+
+    void* allocate_or_throw(std::size_t size, std::size_t alignment)
+    {
+        for (;;)
+        {
+            if (void* p = allocate(size, alignment))
+            {
+                return p;
+            }
+            std::new_handler handler = std::get_new_handler();
+            if (!handler)
+            {
+                throw std::bad_alloc{};
+            }
+            handler();
+        }
+    }
+
+    void deallocate(void* p) noexcept
+    {
+        if (p)
+        {
+            ++thread_allocations.deallocations;
+            std::free(p);
+        }
+    }
+
+    constexpr std::size_t default_alignment = alignof(std::max_align_t);
+} // end anonymous namespace
+
+allocation_counts allocation_counter::thread_counts() noexcept { return thread_allocations; }
+
+} // end namespace 'co'
+
+// Replacements of the global allocation functions.
+
+void* operator new(std::size_t size) { return co::allocate_or_throw(size, co::default_alignment); }
+void* operator new[](std::size_t size)
+{
+    return co::allocate_or_throw(size, co::default_alignment);
+}
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return co::allocate_or_throw(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return co::allocate_or_throw(size, static_cast<std::size_t>(alignment));
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return co::allocate(size, co::default_alignment);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return co::allocate(size, co::default_alignment);
+}
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return co::allocate(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return co::allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* p) noexcept { co::deallocate(p); }
+void operator delete[](void* p) noexcept { co::deallocate(p); }
+void operator delete(void* p, std::size_t) noexcept { co::deallocate(p); }
+void operator delete[](void* p, std::size_t) noexcept { co::deallocate(p); }
+void operator delete(void* p, std::align_val_t) noexcept { co::deallocate(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { co::deallocate(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { co::deallocate(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { co::deallocate(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { co::deallocate(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { co::deallocate(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    co::deallocate(p);
+}
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    co::deallocate(p);
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <boost/noncopyable.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+
+namespace co
+{
+
+/**
+ * The arena class is a bump allocator over a single buffer, for immutable data structures
+ * whose size is known before they are built.  Objects are never freed individually; the
+ * whole buffer is released at once when the arena is destroyed.  Only trivially
+ * destructible objects may be allocated.
+ *
+ * The required capacity is computed exactly by a `layout`, from the same sequence of
+ * allocations.  Allocating beyond the capacity throws `std::bad_alloc`.
+ */
+class arena : boost::noncopyable
+{
+public:
+    /**
+     * The layout class computes the capacity needed for a sequence of allocations, made
+     * in the same order, including the padding that aligns each of them.  The buffer of an
+     * arena is aligned for any fundamental type, so offsets from its start are the same
+     * as offsets computed from zero.
+     */
+    class layout
+    {
+    public:
+        template <typename T> layout& add(std::size_t n)
+        {
+            static_assert(alignof(T) <= alignof(std::max_align_t));
+            if (n > 0)
+            {
+                m_size = (m_size + alignof(T) - 1) / alignof(T) * alignof(T) + n * sizeof(T);
+            }
+            return *this;
+        }
+
+        std::size_t size() const { return m_size; }
+
+    private:
+        std::size_t m_size = 0;
+    };
+
+    explicit arena(std::size_t capacity)
+        : m_buffer{capacity > 0 ? new std::byte[capacity] : nullptr}
+        , m_capacity{capacity}
+        , m_used{0}
+    {
+    }
+
+    explicit arena(const layout& l)
+        : arena(l.size())
+    {
+    }
+
+    /// Allocate uninitialized storage for `n` objects of type `T`.
+    template <typename T> T* allocate(std::size_t n)
+    {
+        static_assert(std::is_trivially_destructible_v<T>,
+                      "Objects in an arena are never destroyed");
+        if (n == 0)
+        {
+            return nullptr;
+        }
+        void* p = m_buffer.get() + m_used;
+        std::size_t space = m_capacity - m_used;
+        if (!std::align(alignof(T), n * sizeof(T), p, space))
+        {
+            throw std::bad_alloc{};
+        }
+        m_used = m_capacity - space + n * sizeof(T);
+        return static_cast<T*>(p);
+    }
+
+    /// Copy the characters of `s` into the arena, and return a view of the copy.
+    std::string_view copy(std::string_view s)
+    {
+        char* p = allocate<char>(s.size());
+        if (!s.empty())
+        {
+            std::memcpy(p, s.data(), s.size());
+        }
+        return {p, s.size()};
+    }
+
+    std::size_t capacity() const { return m_capacity; }
+    std::size_t used() const { return m_used; }
+
+private:
+    std::unique_ptr<std::byte[]> m_buffer;
+    std::size_t m_capacity;
+    std::size_t m_used;
+};
+
+} // end namespace 'co'
@@ -0,0 +1,258 @@
+#include "compiled_pattern.hpp"
+#include <codeowners/codegen.hpp>
+#include <codeowners/errors.hpp>
+#include <codeowners/ruleset.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <ostream>
+#include <string_view>
+
+namespace co
+{
+
+namespace
+{
+    using segment_kind = compiled_pattern::segment_kind;
+
+    /// Return `text` as a C++ string literal.  Characters other than printable ASCII are
+    /// written as three-digit octal escapes, which cannot run into following characters.
+    std::string string_literal(std::string_view text)
+    {
+        std::string result = "\"";
+        for (const char c : text)
+        {
+            const auto uc = static_cast<unsigned char>(c);
+            if (c == '"' || c == '\\')
+            {
+                result += '\\';
+                result += c;
+            }
+            else if (uc < 0x20 || uc >= 0x7f || c == '?')
+            {
+                // `?` is escaped to avoid trigraphs in compilers that still support them.
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\%03o", uc);
+                result += buf;
+            }
+            else
+            {
+                result += c;
+            }
+        }
+        return result + '"';
+    }
+
+    const char* to_string(segment_kind kind)
+    {
+        switch (kind)
+        {
+        case segment_kind::LITERAL:
+            return "co::static_segment_kind::LITERAL";
+        case segment_kind::STAR:
+            return "co::static_segment_kind::STAR";
+        case segment_kind::GLOB:
+            return "co::static_segment_kind::GLOB";
+        case segment_kind::ANY_DIRS:
+            return "co::static_segment_kind::ANY_DIRS";
+        }
+        return "";
+    }
+
+    /// Return whether a glob expression is `*` followed by text without special characters.
+    bool is_suffix_glob(std::string_view glob)
+    {
+        return glob.size() > 1 && glob.front() == '*'
+            && glob.find_first_of("*?[\\", 1) == std::string_view::npos;
+    }
+
+    /// Return the type and initializer of the matcher specialized for a pattern.
+    std::string matcher_definition(const compiled_pattern& pat)
+    {
+        const auto& segments = pat.segments();
+        const char* directory_only = pat.is_directory_only() ? "true" : "false";
+        if (pat.matches_all_within(""))
+        {
+            return "co::universal_matcher{}";
+        }
+        if (segments.size() == 2 && segments[0].kind == segment_kind::ANY_DIRS)
+        {
+            const auto& last = segments[1];
+            if (last.kind == segment_kind::LITERAL)
+            {
+                return "co::component_matcher{" + string_literal(last.text) + ", "
+                    + directory_only + "}";
+            }
+            if (last.kind == segment_kind::GLOB && !pat.is_directory_only())
+            {
+                return is_suffix_glob(last.text)
+                    ? "co::suffix_matcher{" + string_literal(last.text.substr(1)) + "}"
+                    : "co::name_matcher{" + string_literal(last.text) + "}";
+            }
+        }
+        const bool all_literal
+            = !segments.empty() && std::all_of(segments.begin(), segments.end(), [](const auto& s) {
+                  return s.kind == segment_kind::LITERAL;
+              });
+        if (all_literal)
+        {
+            return "co::prefix_matcher{" + string_literal(pat.literal_prefix()) + ", "
+                + directory_only + "}";
+        }
+
+        // A literal directory, followed by a wildcard segment for the file's name, at one or
+        // any level below the directory.
+        const std::size_t literals = static_cast<std::size_t>(
+            std::find_if(segments.begin(), segments.end(),
+                         [](const auto& s) { return s.kind != segment_kind::LITERAL; })
+            - segments.begin());
+        const auto& last = segments.back();
+        const bool wildcard_name = !pat.is_directory_only()
+            && (last.kind == segment_kind::GLOB || last.kind == segment_kind::STAR);
+        if (literals > 0 && wildcard_name && literals + 1 == segments.size())
+        {
+            return "co::child_matcher{" + string_literal(pat.literal_prefix()) + ", "
+                + string_literal(last.text) + "}";
+        }
+        if (literals > 0 && wildcard_name && literals + 2 == segments.size()
+            && segments[literals].kind == segment_kind::ANY_DIRS)
+        {
+            return "co::descendant_matcher{" + string_literal(pat.literal_prefix()) + ", "
+                + string_literal(last.text) + "}";
+        }
+
+        std::string result
+            = "co::segments_matcher<" + std::to_string(segments.size()) + ">{{{";
+        for (std::size_t i = 0; i < segments.size(); ++i)
+        {
+            result += i == 0 ? "" : ", ";
+            result += "{";
+            result += to_string(segments[i].kind);
+            result += ", " + string_literal(segments[i].text) + "}";
+        }
+        return result + "}}, " + directory_only + ", "
+            + (pat.matches_contents() ? "true" : "false") + "}";
+    }
+
+    /// Throw if `name` is not a namespace name, optionally qualified with `::`.
+    void check_namespace(const std::string& name)
+    {
+        std::string_view rest = name;
+        while (true)
+        {
+            const auto sep = rest.find("::");
+            const std::string_view part = rest.substr(0, sep);
+            const bool valid = !part.empty()
+                && !std::isdigit(static_cast<unsigned char>(part.front()))
+                && std::all_of(part.begin(), part.end(), [](char c) {
+                       return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+                   });
+            if (!valid)
+            {
+                throw error{"Invalid namespace name: " + name};
+            }
+            if (sep == std::string_view::npos)
+            {
+                return;
+            }
+            rest.remove_prefix(sep + 2);
+        }
+    }
+
+} // end anonymous namespace
+
+void write_static_ruleset(std::ostream& os, const std::vector<annotated_rule>& rules,
+                          const codegen_options& options)
+{
+    check_namespace(options.namespace_name);
+    const ruleset rset{rules};
+
+    std::vector<bool> shadowed(rules.size());
+    for (const ruleset::shadowed_rule& s : rset.shadowed_rules())
+    {
+        shadowed[s.id] = true;
+    }
+    // Rules whose patterns cannot be compiled match nothing, as in `ruleset`.
+    std::vector<bool> skipped(rules.size());
+    for (const ruleset::skipped_rule& s : rset.skipped_rules())
+    {
+        skipped[s.id] = true;
+    }
+
+    os << "// Generated by codeowners-codegen from " << options.source_name
+       << ".  Do not edit.\n"
+       << "#pragma once\n\n"
+       << "#include <codeowners/static_ruleset.hpp>\n\n"
+       << "#include <array>\n#include <cstddef>\n#include <optional>\n#include <string_view>\n\n"
+       << "namespace " << options.namespace_name << "\n{\n\n";
+
+    os << "inline constexpr std::array<std::string_view, " << rset.owners().size()
+       << "> owners{{\n";
+    for (const std::string_view name : rset.owners())
+    {
+        os << "    " << string_literal(name) << ",\n";
+    }
+    os << "}};\n\n";
+
+    std::size_t owner_refs = 0;
+    for (ruleset::rule_id id = 0; id < rset.size(); ++id)
+    {
+        owner_refs += rset.owner_ids(id).size();
+    }
+    os << "inline constexpr std::array<std::size_t, " << owner_refs << "> owner_ids{{\n";
+    for (ruleset::rule_id id = 0; id < rset.size(); ++id)
+    {
+        for (const ruleset::owner_id oid : rset.owner_ids(id))
+        {
+            os << "    " << oid << ",\n";
+        }
+    }
+    os << "}};\n\n";
+
+    os << "inline constexpr std::array<co::static_rule, " << rules.size() << "> rules{{\n";
+    std::size_t first_owner = 0;
+    for (ruleset::rule_id id = 0; id < rset.size(); ++id)
+    {
+        const std::size_t count = rset.owner_ids(id).size();
+        os << "    {" << rules[id].source.line << ", "
+           << string_literal(rules[id].rule.file_pattern.value()) << ", " << first_owner << ", "
+           << count << "},\n";
+        first_owner += count;
+    }
+    os << "}};\n\n";
+
+    os << "namespace matchers\n{\n";
+    for (ruleset::rule_id id = 0; id < rules.size(); ++id)
+    {
+        if (skipped[id])
+        {
+            os << "    // Rule " << id << " (line " << rules[id].source.line
+               << ") is omitted:  its pattern cannot be compiled, so it matches no path.\n";
+        }
+        else if (!shadowed[id])
+        {
+            const compiled_pattern pat{rules[id].rule.file_pattern};
+            os << "    inline constexpr auto rule_" << id << " = " << matcher_definition(pat)
+               << ";\n";
+        }
+    }
+    os << "} // end namespace 'matchers'\n\n";
+
+    os << "/// Return the index in `rules` of the rule that applies to `path`, a normalized\n"
+       << "/// relative path, or an empty optional if no rule applies.\n"
+       << "inline std::optional<std::size_t> find(std::string_view path) noexcept\n{\n"
+       << "    const std::string_view name = co::file_name(path);\n";
+    for (ruleset::rule_id id = rules.size(); id-- > 0;)
+    {
+        if (!shadowed[id] && !skipped[id])
+        {
+            os << "    if (matchers::rule_" << id << ".matches(path, name))\n"
+               << "        return " << id << ";\n";
+        }
+    }
+    os << "    return std::nullopt;\n}\n\n"
+       << "} // end namespace '" << options.namespace_name << "'\n";
+}
+
+} // end namespace 'co'
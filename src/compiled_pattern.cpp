@@ -0,0 +1,542 @@
+#include "compiled_pattern.hpp"
+
+#include <codeowners/errors.hpp>
+#include <codeowners/glob.hpp>
+
+#include <algorithm>
+#include <bitset>
+#include <cassert>
+#include <optional>
+
+namespace co
+{
+
+namespace
+{
+
+    /// Return whether the pattern segment contains unescaped wildcard characters.
+    bool has_wildcards(std::string_view text)
+    {
+        for (std::size_t i = 0; i < text.size(); ++i)
+        {
+            switch (text[i])
+            {
+            case '\\':
+                ++i;
+                break;
+            case '*':
+            case '?':
+            case '[':
+                return true;
+            default:
+                break;
+            }
+        }
+        return false;
+    }
+
+    std::string unescape(std::string_view text)
+    {
+        std::string result;
+        result.reserve(text.size());
+        for (std::size_t i = 0; i < text.size(); ++i)
+        {
+            if (text[i] == '\\' && i + 1 < text.size())
+            {
+                ++i;
+            }
+            result.push_back(text[i]);
+        }
+        return result;
+    }
+
+
+    /// One element of a glob expression:  a set of characters, matched once, or any number
+    /// of times for `*`.
+    struct glob_token
+    {
+        std::bitset<256> chars;
+        bool repeated;
+    };
+
+    /// Return the tokens of the component language of a segment, or of any component if
+    /// `seg` is null.  Path components never contain `/`.
+    std::vector<glob_token> component_tokens(const compiled_pattern::segment* seg)
+    {
+        using segment_kind = compiled_pattern::segment_kind;
+        std::bitset<256> any;
+        any.set();
+        any.reset(static_cast<unsigned char>('/'));
+
+        if (!seg || seg->kind == segment_kind::STAR || seg->kind == segment_kind::ANY_DIRS)
+        {
+            return {glob_token{any, true}};
+        }
+        std::vector<glob_token> tokens;
+        const auto literal = [&tokens](char c) {
+            glob_token token{{}, false};
+            token.chars.set(static_cast<unsigned char>(c));
+            tokens.push_back(token);
+        };
+        const std::string_view text = seg->text;
+        if (seg->kind == segment_kind::LITERAL)
+        {
+            std::for_each(text.begin(), text.end(), literal);
+            return tokens;
+        }
+        // Tokens are read as `glob_match` reads them.
+        for (std::size_t p = 0; p < text.size();)
+        {
+            if (text[p] == '*' || text[p] == '?')
+            {
+                tokens.push_back(glob_token{any, text[p] == '*'});
+                ++p;
+                continue;
+            }
+            bool matched = false;
+            const std::size_t length
+                = text[p] == '[' ? match_bracket(text.substr(p), '\0', matched) : 0;
+            if (length > 0)
+            {
+                glob_token token{{}, false};
+                for (std::size_t c = 0; c < 256; ++c)
+                {
+                    match_bracket(text.substr(p), static_cast<char>(c), matched);
+                    token.chars[c] = matched && any[c];
+                }
+                tokens.push_back(token);
+                p += length;
+                continue;
+            }
+            const std::size_t pos = text[p] == '\\' && p + 1 < text.size() ? p + 1 : p;
+            literal(text[pos]);
+            p = pos + 1;
+        }
+        return tokens;
+    }
+
+    /// Return whether some non-empty path component is matched by both segments, where a
+    /// null segment matches any component.  The product of the two glob automata is
+    /// searched for a path to the accepting state that consumes at least one character.
+    bool components_intersect(const compiled_pattern::segment* a,
+                              const compiled_pattern::segment* b)
+    {
+        using segment_kind = compiled_pattern::segment_kind;
+        if (a && b && a->kind == segment_kind::LITERAL && b->kind == segment_kind::LITERAL)
+        {
+            return a->text == b->text;
+        }
+        const std::vector<glob_token> ta = component_tokens(a);
+        const std::vector<glob_token> tb = component_tokens(b);
+
+        // A state is a position in each token list, and whether a character was consumed.
+        const auto index = [&](std::size_t i, std::size_t j, bool consumed) {
+            return (i * (tb.size() + 1) + j) * 2 + consumed;
+        };
+        std::vector<bool> visited((ta.size() + 1) * (tb.size() + 1) * 2);
+        std::vector<std::size_t> pending;
+        const auto visit = [&](std::size_t i, std::size_t j, bool consumed) {
+            if (!visited[index(i, j, consumed)])
+            {
+                visited[index(i, j, consumed)] = true;
+                pending.push_back(index(i, j, consumed));
+            }
+        };
+        visit(0, 0, false);
+        while (!pending.empty())
+        {
+            const std::size_t state = pending.back();
+            pending.pop_back();
+            const bool consumed = state % 2;
+            const std::size_t i = state / 2 / (tb.size() + 1);
+            const std::size_t j = state / 2 % (tb.size() + 1);
+            if (i == ta.size() && j == tb.size() && consumed)
+            {
+                return true;
+            }
+            // `*` may match no characters.
+            if (i < ta.size() && ta[i].repeated)
+            {
+                visit(i + 1, j, consumed);
+            }
+            if (j < tb.size() && tb[j].repeated)
+            {
+                visit(i, j + 1, consumed);
+            }
+            if (i < ta.size() && j < tb.size() && (ta[i].chars & tb[j].chars).any())
+            {
+                visit(ta[i].repeated ? i : i + 1, tb[j].repeated ? j : j + 1, true);
+            }
+        }
+        return false;
+    }
+} // end anonymous namespace
+
+bool compiled_pattern::segment::matches(std::string_view component) const
+{
+    switch (kind)
+    {
+    case segment_kind::LITERAL:
+        return component == text;
+    case segment_kind::GLOB:
+        return glob_match(text, component);
+    case segment_kind::STAR:
+    case segment_kind::ANY_DIRS:
+        return true;
+    }
+    assert(false && "Unreachable");
+    return false;
+}
+
+compiled_pattern::compiled_pattern(const pattern& pat)
+    : m_segments{}
+    , m_directory_only{false}
+    , m_matches_contents{false}
+{
+    std::string_view text = pat.value();
+
+    while (!text.empty() && text.back() == '/')
+    {
+        m_directory_only = true;
+        text.remove_suffix(1);
+    }
+    const bool anchored = text.find('/') != std::string_view::npos;
+
+    component_reader reader{text};
+    while (!reader.empty())
+    {
+        const std::string_view piece = reader.next();
+        if (piece == "**")
+        {
+            if (m_segments.empty() || m_segments.back().kind != segment_kind::ANY_DIRS)
+            {
+                m_segments.push_back(segment{segment_kind::ANY_DIRS, std::string{piece}});
+            }
+        }
+        else if (piece == "*")
+        {
+            m_segments.push_back(segment{segment_kind::STAR, std::string{piece}});
+        }
+        else if (has_wildcards(piece))
+        {
+            m_segments.push_back(segment{segment_kind::GLOB, std::string{piece}});
+        }
+        else
+        {
+            m_segments.push_back(segment{segment_kind::LITERAL, unescape(piece)});
+        }
+    }
+
+    // A trailing `/**` matches everything inside a directory.
+    if (!m_segments.empty() && m_segments.back().kind == segment_kind::ANY_DIRS)
+    {
+        m_segments.pop_back();
+        m_directory_only = true;
+    }
+    // An unanchored pattern is equivalent to a pattern with a leading `**/`.
+    if (!anchored && (m_segments.empty() || m_segments.front().kind != segment_kind::ANY_DIRS))
+    {
+        m_segments.insert(m_segments.begin(), segment{segment_kind::ANY_DIRS, "**"});
+    }
+
+    m_matches_contents = m_directory_only || m_segments.empty()
+        || m_segments.back().kind == segment_kind::LITERAL;
+
+    if (m_segments.size() > max_segments)
+    {
+        using namespace std::string_literals;
+        throw error{"Pattern has too many path segments: "s + pat.value()};
+    }
+}
+
+compiled_pattern::compiled_pattern(std::vector<segment>&& segments, bool directory_only,
+                                   bool matches_contents)
+    : m_segments{std::move(segments)}
+    , m_directory_only{directory_only}
+    , m_matches_contents{matches_contents}
+{
+}
+
+compiled_pattern compiled_pattern::matching_nothing()
+{
+    // Path components are never empty, so an empty literal segment matches none of them.
+    return compiled_pattern{{segment{segment_kind::LITERAL, ""}}, false, false};
+}
+
+compiled_pattern::state_type compiled_pattern::closure(state_type state) const
+{
+    // A `**` segment may match zero components, so its position implies the next one.
+    for (std::size_t i = 0; i < m_segments.size(); ++i)
+    {
+        if ((state >> i & 1) && m_segments[i].kind == segment_kind::ANY_DIRS)
+        {
+            state |= state_type{1} << (i + 1);
+        }
+    }
+    return state;
+}
+
+compiled_pattern::state_type compiled_pattern::step(state_type state,
+                                                    std::string_view component) const
+{
+    state_type next = 0;
+    for (std::size_t i = 0; i < m_segments.size(); ++i)
+    {
+        if (!(state >> i & 1))
+        {
+            continue;
+        }
+        const segment& seg = m_segments[i];
+        if (seg.kind == segment_kind::ANY_DIRS)
+        {
+            next |= state_type{1} << i;
+        }
+        else if (seg.matches(component))
+        {
+            next |= state_type{1} << (i + 1);
+        }
+    }
+    return closure(next);
+}
+
+bool compiled_pattern::matches(std::string_view path) const
+{
+    component_reader reader{path};
+    if (reader.empty())
+    {
+        return false;
+    }
+
+    const state_type accepting = accepting_state();
+    state_type state = initial_state();
+    while (true)
+    {
+        // The components consumed so far name a parent directory of the path.
+        if ((state & accepting) && m_matches_contents)
+        {
+            return true;
+        }
+        state = step(state, reader.next());
+        if (reader.empty())
+        {
+            return is_file_match(state);
+        }
+        if (!state)
+        {
+            return false;
+        }
+    }
+}
+
+std::pair<compiled_pattern::state_type, bool>
+compiled_pattern::consume_directory(std::string_view dir) const
+{
+    component_reader reader{dir};
+    state_type state = initial_state();
+    while (true)
+    {
+        if (matches_all_from(state))
+        {
+            return {state, true};
+        }
+        if (reader.empty() || !state)
+        {
+            return {state, false};
+        }
+        state = step(state, reader.next());
+    }
+}
+
+bool compiled_pattern::is_universal_from(std::size_t pos) const
+{
+    // Conservatively, recognize only a single `*` segment, optionally preceded by `**`
+    // segments.  If `*` is the only segment, it must also match directory contents.
+    if (pos >= m_segments.size() || m_directory_only
+        || m_segments.back().kind != segment_kind::STAR)
+    {
+        return false;
+    }
+    for (std::size_t i = pos; i + 1 < m_segments.size(); ++i)
+    {
+        if (m_segments[i].kind != segment_kind::ANY_DIRS)
+        {
+            return false;
+        }
+    }
+    return pos + 1 < m_segments.size() || m_matches_contents;
+}
+
+bool compiled_pattern::matches_all_from(state_type state) const
+{
+    if ((state & accepting_state()) && m_matches_contents)
+    {
+        return true;
+    }
+    for (std::size_t pos = 0; pos < m_segments.size(); ++pos)
+    {
+        if ((state >> pos & 1) && is_universal_from(pos))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string compiled_pattern::literal_prefix() const
+{
+    std::string result;
+    for (const segment& seg : m_segments)
+    {
+        if (seg.kind != segment_kind::LITERAL)
+        {
+            break;
+        }
+        result += result.empty() ? "" : "/";
+        result += seg.text;
+    }
+    return result;
+}
+
+bool compiled_pattern::subsumes(const compiled_pattern& other) const
+{
+    if (matches_all_from(initial_state()))
+    {
+        return true;
+    }
+    const bool same_segments = std::equal(
+        m_segments.begin(), m_segments.end(), other.m_segments.begin(), other.m_segments.end(),
+        [](const segment& a, const segment& b) { return a.kind == b.kind && a.text == b.text; });
+    if (same_segments && m_directory_only == other.m_directory_only)
+    {
+        return true;
+    }
+
+    // Every file that `other` matches is within the directory named by its literal prefix,
+    // or, if the pattern consists only of literal segments and matches files, is that path.
+    const std::string prefix = other.literal_prefix();
+    if (prefix.empty())
+    {
+        return false;
+    }
+    const bool all_literal = std::all_of(other.m_segments.begin(), other.m_segments.end(),
+                                         [](const segment& seg) {
+                                             return seg.kind == segment_kind::LITERAL;
+                                         });
+    if (all_literal && !other.m_directory_only && !matches(prefix))
+    {
+        return false;
+    }
+    return matches_all_within(prefix);
+}
+
+bool compiled_pattern::overlaps(const compiled_pattern& other) const
+{
+    // The product of the two segment automata is searched for a sequence of components
+    // that both patterns match.  Each automaton has positions 0 to n, with n accepting, and
+    // a position n + 1 for paths within a directory matched by a pattern that matches
+    // directory contents.  Each position has at most one transition:  a `**` segment
+    // consumes any component in place, another segment consumes a component it matches,
+    // and positions n (if matching contents) and n + 1 consume any component.
+    struct automaton
+    {
+        const compiled_pattern& pat;
+
+        std::size_t contents() const { return pat.m_segments.size() + 1; }
+
+        const segment* constraint(std::size_t pos) const
+        {
+            return pos < pat.m_segments.size()
+                    && pat.m_segments[pos].kind != segment_kind::ANY_DIRS
+                ? &pat.m_segments[pos]
+                : nullptr;
+        }
+
+        std::optional<std::size_t> next(std::size_t pos) const
+        {
+            const std::size_t n = pat.m_segments.size();
+            if (pos < n)
+            {
+                return pat.m_segments[pos].kind == segment_kind::ANY_DIRS ? pos : pos + 1;
+            }
+            if (pos == n && !pat.m_matches_contents)
+            {
+                return std::nullopt;
+            }
+            return contents();
+        }
+
+        bool accepts(std::size_t pos) const
+        {
+            return pos == contents() || (pos == pat.m_segments.size() && !pat.m_directory_only);
+        }
+
+        /// Return the positions implied by `pos`, as `**` segments may match no components.
+        std::vector<std::size_t> closure(std::size_t pos) const
+        {
+            std::vector<std::size_t> result{pos};
+            while (pos < pat.m_segments.size()
+                   && pat.m_segments[pos].kind == segment_kind::ANY_DIRS)
+            {
+                result.push_back(++pos);
+            }
+            return result;
+        }
+    };
+    const automaton a{*this};
+    const automaton b{other};
+
+    const std::size_t width = b.contents() + 1;
+    std::vector<bool> visited((a.contents() + 1) * width);
+    std::vector<std::pair<std::size_t, std::size_t>> pending;
+    // Pairs are visited after consuming at least one component, as paths are non-empty.
+    const auto step = [&](std::size_t i, std::size_t j) {
+        const auto ni = a.next(i);
+        const auto nj = b.next(j);
+        if (!ni || !nj || !components_intersect(a.constraint(i), b.constraint(j)))
+        {
+            return;
+        }
+        for (const std::size_t ci : a.closure(*ni))
+        {
+            for (const std::size_t cj : b.closure(*nj))
+            {
+                if (!visited[ci * width + cj])
+                {
+                    visited[ci * width + cj] = true;
+                    pending.emplace_back(ci, cj);
+                }
+            }
+        }
+    };
+    for (const std::size_t i : a.closure(0))
+    {
+        for (const std::size_t j : b.closure(0))
+        {
+            step(i, j);
+        }
+    }
+    while (!pending.empty())
+    {
+        const auto [i, j] = pending.back();
+        pending.pop_back();
+        if (a.accepts(i) && b.accepts(j))
+        {
+            return true;
+        }
+        step(i, j);
+    }
+    return false;
+}
+
+bool compiled_pattern::matches_all_within(std::string_view dir) const
+{
+    return consume_directory(dir).second;
+}
+
+bool compiled_pattern::may_match_within(std::string_view dir) const
+{
+    const auto [state, matches_all] = consume_directory(dir);
+    return matches_all || is_live(state);
+}
+
+} // end namespace 'co'
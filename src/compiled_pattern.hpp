@@ -0,0 +1,201 @@
+#pragma once
+
+#include "codeowners/codeowners.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace co
+{
+
+/// Reads the components of a relative path one at a time, ignoring empty and `.` components.
+class component_reader
+{
+public:
+    explicit component_reader(std::string_view path)
+        : m_rest{path}
+    {
+        skip_separators();
+    }
+
+    bool empty() const { return m_rest.empty(); }
+
+    std::string_view next()
+    {
+        assert(!empty());
+        const auto pos = m_rest.find('/');
+        const std::string_view component = m_rest.substr(0, pos);
+        m_rest.remove_prefix(pos == std::string_view::npos ? m_rest.size() : pos + 1);
+        skip_separators();
+        return component;
+    }
+
+private:
+    void skip_separators()
+    {
+        while (!m_rest.empty())
+        {
+            if (m_rest.front() == '/' || m_rest == "." || m_rest.substr(0, 2) == "./")
+            {
+                m_rest.remove_prefix(1);
+            }
+            else
+            {
+                break;
+            }
+        }
+    }
+
+private:
+    std::string_view m_rest;
+};
+
+/// The compiled_pattern class matches relative file paths against a single CODEOWNERS pattern.
+///
+/// Pattern syntax follows the gitignore conventions used by Github:
+///
+///   - A pattern with a slash at its start or middle is anchored at the repository root;
+///     otherwise, it matches at any depth.  `docs/` matches `a/docs/b.md`, but `/docs/` and
+///     `x/docs` do not.
+///   - Within a path segment, `*` matches any sequence of characters, `?` matches one
+///     character, `[...]` matches a character class, and `\` escapes the next character.
+///   - A `**` segment matches zero or more directories.  A trailing `/**` matches everything
+///     inside a directory.
+///   - A pattern that matches a directory also matches everything inside it.  As in Github,
+///     this does not apply when the final segment contains wildcards:  `docs/*` matches
+///     `docs/a.md`, but not `docs/build/b.md`.
+///   - A pattern with a trailing slash only matches directories, so for a file path it
+///     can only match one of the file's parent directories.
+///
+/// Matching is performed segment by segment, by tracking the set of pattern positions that
+/// are consistent with the path components consumed so far.
+class compiled_pattern
+{
+public:
+    enum class segment_kind
+    {
+        LITERAL,  /// Matches one path component exactly.
+        STAR,     /// `*`:  matches any one path component.
+        GLOB,     /// Matches one path component, using wildcards.
+        ANY_DIRS, /// `**`:  matches zero or more path components.
+    };
+
+    /// One path segment of a pattern.  The text of a literal segment is unescaped.
+    struct segment
+    {
+        segment_kind kind;
+        std::string text;
+
+        bool matches(std::string_view component) const;
+    };
+
+    /// Compile `pat`.  Throws `co::error` if the pattern has more than 63 path segments,
+    /// as matching states are bit sets of segment positions.
+    explicit compiled_pattern(const pattern& pat);
+
+    /// Return a pattern that matches no path, which stands in for a pattern that cannot be
+    /// compiled.
+    static compiled_pattern matching_nothing();
+
+    /// The segments of the pattern.  An unanchored pattern begins with an ANY_DIRS segment,
+    /// and a trailing `/**` is removed, making the pattern directory-only.
+    const std::vector<segment>& segments() const { return m_segments; }
+    /// Whether the pattern only matches directories (trailing slash or `/**`).
+    bool is_directory_only() const { return m_directory_only; }
+    /// Whether a match against a directory extends to everything inside it.
+    bool matches_contents() const { return m_matches_contents; }
+
+    /// Return whether the pattern matches the file at relative path `path`.
+    bool matches(std::string_view path) const;
+
+    /// Return whether the pattern matches every file within the relative directory `dir`.
+    /// The result is conservative:  it may be false for some patterns that do match every
+    /// such file.
+    bool matches_all_within(std::string_view dir) const;
+
+    /// Return whether the pattern might match some file within the relative directory
+    /// `dir`.  The result is conservative:  it may be true for some patterns that cannot
+    /// match any such file.
+    bool may_match_within(std::string_view dir) const;
+
+    /// Return whether the pattern matches every file that `other` matches, so that `other`
+    /// never applies to a file if this pattern takes precedence over it.  The result is
+    /// conservative:  it may be false for some patterns that do subsume `other`.
+    bool subsumes(const compiled_pattern& other) const;
+
+    /// Return whether some file matches both this pattern and `other`.  The automata of the
+    /// two patterns are intersected, without enumerating paths, so the cost depends only on
+    /// the lengths of the patterns.
+    bool overlaps(const compiled_pattern& other) const;
+
+    /// Return the directory, as a relative path, named by the leading literal segments of
+    /// an anchored pattern, or an empty string if the pattern does not begin with a literal
+    /// segment.  Every file matched by the pattern is this directory, or is within it.
+    std::string literal_prefix() const;
+
+    /// Return whether the pattern matches a file if and only if it matches every file within
+    /// the file's parent directory, regardless of the file's name.  For such patterns,
+    /// `matches_all_within` is exact.  This holds for patterns that only match directories,
+    /// and for patterns that match every path.
+    bool is_directory_determined() const
+    {
+        return m_directory_only || matches_all_from(initial_state());
+    }
+
+    /// Incremental matching.  A state records the progress of a match after consuming the
+    /// leading components of a path, one at a time, so that matching of paths sharing
+    /// parent directories can resume from the state of their common parent.
+    ///
+    /// A state is a bit set of pattern positions:  position `i` means that the first `i`
+    /// segments have matched.
+    using state_type = std::uint64_t;
+
+    /// Return the state before any path component has been consumed.
+    state_type initial_state() const { return closure(1); }
+
+    /// Return the state after consuming `component` in `state`.
+    state_type step(state_type state, std::string_view component) const;
+
+    /// Return whether consuming further components in `state` could lead to a match.
+    bool is_live(state_type state) const { return (state & ~accepting_state()) != 0; }
+
+    /// Return whether a file whose final component was consumed in `state` matches.
+    bool is_file_match(state_type state) const
+    {
+        return (state & accepting_state()) && !m_directory_only;
+    }
+
+    /// Return whether every file within a directory matches, when the directory's
+    /// components were consumed in `state`.  The result is conservative, as for
+    /// `matches_all_within`.
+    bool matches_all_from(state_type state) const;
+
+private:
+    static constexpr std::size_t max_segments = 63;
+
+    compiled_pattern(std::vector<segment>&& segments, bool directory_only,
+                     bool matches_contents);
+
+    state_type accepting_state() const { return state_type{1} << m_segments.size(); }
+    state_type closure(state_type state) const;
+
+    /// Return whether the pattern matches every non-empty sequence of path components when
+    /// starting at position `pos`.
+    bool is_universal_from(std::size_t pos) const;
+
+    /// Consume the components of directory `dir`.  Return the resulting state, and whether
+    /// every file within `dir` was found to match.
+    std::pair<state_type, bool> consume_directory(std::string_view dir) const;
+
+private:
+    std::vector<segment> m_segments;
+    /// Whether the pattern only matches directories (trailing slash or `/**`).
+    bool m_directory_only;
+    /// Whether a match against a directory extends to everything inside it.
+    bool m_matches_contents;
+};
+
+} // end namespace 'co'
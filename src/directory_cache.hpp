@@ -0,0 +1,96 @@
+#pragma once
+
+#include <codeowners/instrumentation.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace co
+{
+
+/**
+ * The directory_cache class memoizes a lookup result per directory, such as the position of
+ * the last directory-only pattern that matches the files within the directory.
+ *
+ * The cache holds at most `capacity` directories; when it is full, it is cleared before a
+ * new directory is added.  Entries are keyed by the hash of the directory path, and store
+ * the path itself to detect collisions, so that hits do not allocate memory; a miss
+ * allocates a copy of the path and a node of the table.
+ *
+ * Member functions may be called concurrently, but take a lock, so concurrent lookups on
+ * the same cache serialize (except while a missing value is computed).
+ */
+class directory_cache
+{
+public:
+    struct statistics
+    {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+    };
+
+    static constexpr std::size_t default_capacity = 4096;
+
+    explicit directory_cache(std::size_t capacity = default_capacity)
+        : m_capacity{capacity}
+    {
+    }
+
+    /// Return the value for directory `dir`, which is computed by `compute(dir)` if it is
+    /// not cached.
+    template <typename F> std::size_t get(std::string_view dir, F&& compute)
+    {
+        const std::size_t key = std::hash<std::string_view>{}(dir);
+        std::unique_lock<std::mutex> lock{m_mutex};
+        if (auto it = m_entries.find(key); it != m_entries.end() && it->second.directory == dir)
+        {
+            ++m_statistics.hits;
+            instrumentation::add(counter::DIRECTORY_CACHE_HITS);
+            return it->second.value;
+        }
+        ++m_statistics.misses;
+        instrumentation::add(counter::DIRECTORY_CACHE_MISSES);
+
+        lock.unlock();
+        const std::size_t value = compute(dir);
+        lock.lock();
+
+        if (m_entries.size() >= m_capacity)
+        {
+            m_entries.clear();
+        }
+        m_entries[key] = entry{std::string{dir}, value};
+        return value;
+    }
+
+    /// Remove all cached values.  Statistics are retained.
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_entries.clear();
+    }
+
+    statistics stats() const
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        return m_statistics;
+    }
+
+private:
+    struct entry
+    {
+        std::string directory;
+        std::size_t value;
+    };
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::size_t, entry> m_entries;
+    std::size_t m_capacity;
+    statistics m_statistics;
+};
+
+} // end namespace 'co'
@@ -36,4 +36,40 @@ std::vector<fs::path> distinct_prefixed_paths(std::vector<fs::path> paths)
     return paths;
 }
 
+relative_path_builder::relative_path_builder(const fs::path& base, const fs::path& start)
+    : m_start_size{start.native().size()}
+{
+    fs::path relative = fs::relative(start, base);
+    if (relative != ".")
+    {
+        m_prefix = relative.native();
+    }
+}
+
+const fs::path& relative_path_builder::operator()(const fs::path& entry)
+{
+    const fs::path::string_type& native = entry.native();
+    auto pos = std::min(m_start_size, native.size());
+    while (pos < native.size() && native[pos] == fs::path::preferred_separator)
+    {
+        ++pos;
+    }
+    m_buffer.assign(m_prefix);
+    if (pos < native.size())
+    {
+        if (!m_buffer.empty())
+        {
+            m_buffer += fs::path::preferred_separator;
+        }
+        m_buffer.append(native, pos, fs::path::string_type::npos);
+    }
+    else if (m_buffer.empty())
+    {
+        m_buffer += fs::path::dot;
+    }
+    // Assignment copies into the capacity that the path already has.
+    m_path = m_buffer;
+    return m_path;
+}
+
 } // end namespace 'co'
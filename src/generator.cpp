@@ -0,0 +1,355 @@
+#include <codeowners/errors.hpp>
+#include <codeowners/generator.hpp>
+
+#include <boost/process.hpp>
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <random>
+#include <set>
+#include <system_error>
+#include <tuple>
+#include <utility>
+
+namespace co
+{
+
+namespace
+{
+    // `std::mt19937_64` produces the same sequence everywhere, unlike the standard
+    // distributions, so values are reduced with `below` instead.
+    using random_engine = std::mt19937_64;
+
+    /// Return a value in [0, n), or zero if `n` is zero.
+    std::size_t below(random_engine& rng, std::size_t n) { return n == 0 ? 0 : rng() % n; }
+
+    constexpr std::array<const char*, 16> directory_names{
+        "src",    "lib",    "include", "tests", "docs",   "tools", "services", "api",
+        "common", "core",   "util",    "web",   "config", "data",  "scripts",  "internal"};
+
+    constexpr std::array<const char*, 10> extensions{"cpp", "hpp",  "py",   "md",  "go",
+                                                     "ts",  "json", "yaml", "txt", "java"};
+
+    constexpr std::array<const char*, 8> file_stems{"main",    "util",  "index", "handler",
+                                                    "service", "model", "test",  "README"};
+
+    /// Return the name of subdirectory `child` of a directory at `level`.  Names are distinct
+    /// among the subdirectories of a directory, and recur at different levels.
+    std::string directory_name(std::size_t level, std::size_t child)
+    {
+        std::string name = directory_names[(child + 3 * level) % directory_names.size()];
+        if (child >= directory_names.size())
+        {
+            name += std::to_string(child);
+        }
+        return name;
+    }
+
+    /// Return `count` relative file paths of at most `depth` directory components.  File
+    /// names are made unique by their index.
+    std::vector<fs::path> make_paths(random_engine& rng, std::size_t count, std::size_t depth,
+                                     std::size_t fan_out)
+    {
+        std::vector<fs::path> paths;
+        paths.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            // Most files of large repositories are several directories deep.
+            const std::size_t d
+                = fan_out == 0 ? 0 : std::max(below(rng, depth + 1), below(rng, depth + 1));
+            std::string p;
+            for (std::size_t level = 0; level < d; ++level)
+            {
+                p += directory_name(level, below(rng, fan_out));
+                p += '/';
+            }
+            p += file_stems[below(rng, file_stems.size())];
+            p += '_';
+            p += std::to_string(i);
+            p += '.';
+            p += extensions[below(rng, extensions.size())];
+            paths.emplace_back(std::move(p));
+        }
+        std::sort(paths.begin(), paths.end());
+        return paths;
+    }
+
+    owner make_owner(std::size_t k)
+    {
+        const std::string n = std::to_string(k);
+        switch (k % 3)
+        {
+        case 0:
+            return owner{"@org/team-" + n};
+        case 1:
+            return owner{"@user-" + n};
+        default:
+            return owner{"user-" + n + "@example.com"};
+        }
+    }
+
+    void write_files(const fs::path& root, const std::vector<fs::path>& paths,
+                     std::uint64_t seed, std::size_t max_file_size)
+    {
+        // Sizes are drawn separately, so that paths do not depend on `max_file_size`.
+        random_engine rng{seed ^ 0x5eedf11e5u};
+        std::set<fs::path> directories;
+        for (const auto& p : paths)
+        {
+            const fs::path full_path = root / p;
+            if (directories.insert(p.parent_path()).second)
+            {
+                fs::create_directories(full_path.parent_path());
+            }
+            std::ofstream ofs{full_path.string(), std::ios::binary};
+            ofs << std::string(below(rng, max_file_size + 1), 'x');
+            if (!ofs.flush())
+            {
+                throw error{"Cannot write " + full_path.string()};
+            }
+        }
+    }
+
+    template <typename... Args>
+    void git(const fs::path& work_directory, Args&&... args)
+    {
+        namespace bp = boost::process;
+        try
+        {
+            bp::system(bp::search_path("git"), std::forward<Args>(args)...,
+                       bp::start_dir = work_directory.string(), bp::std_out > bp::null,
+                       bp::std_err > bp::null, bp::throw_on_error);
+        }
+        catch (const std::system_error& err)
+        {
+            throw error{"Failed to run git in " + work_directory.string() + ": " + err.what()};
+        }
+    }
+} // end anonymous namespace
+
+std::vector<fs::path> generate_paths(const repository_spec& spec)
+{
+    random_engine rng{spec.seed};
+    return make_paths(rng, spec.file_count, spec.depth, spec.fan_out);
+}
+
+std::vector<fs::path> generate_submodule_paths(const repository_spec& spec)
+{
+    std::vector<fs::path> paths;
+    for (std::size_t k = 0; k < spec.submodule_count; ++k)
+    {
+        paths.push_back(fs::path{"external"} / ("module" + std::to_string(k)));
+    }
+    return paths;
+}
+
+std::vector<annotated_rule> generate_rules(const codeowners_spec& spec,
+                                           const std::vector<fs::path>& paths)
+{
+    std::vector<std::string> directories;
+    {
+        std::set<std::string> unique;
+        for (const auto& p : paths)
+        {
+            for (fs::path dir = p.parent_path(); !dir.empty(); dir = dir.parent_path())
+            {
+                if (!unique.insert(dir.generic_string()).second)
+                {
+                    break;
+                }
+            }
+        }
+        directories.assign(unique.begin(), unique.end());
+    }
+
+    using namespace std::string_literals;
+    random_engine rng{spec.seed};
+    const auto random_extension = [&] { return extensions[below(rng, extensions.size())]; };
+
+    // Directories named by earlier rules, which later rules refine.
+    std::vector<std::string> used_directories;
+    const auto random_directory = [&]() -> std::string {
+        if (below(rng, 3) == 0 && !used_directories.empty())
+        {
+            // A subdirectory, if any, of an earlier rule's directory `dir`.  Subdirectories
+            // sort between "dir/" and "dir0", since '0' follows '/'.
+            const std::string& dir = used_directories[below(rng, used_directories.size())];
+            const auto first
+                = std::lower_bound(directories.begin(), directories.end(), dir + '/');
+            const auto last = std::lower_bound(first, directories.end(), dir + '0');
+            if (first != last)
+            {
+                return *(first + below(rng, last - first));
+            }
+        }
+        std::string dir = directories[below(rng, directories.size())];
+        used_directories.push_back(dir);
+        return dir;
+    };
+
+    // Rules for all files with an extension come first, as they would otherwise override
+    // most directory rules.
+    std::vector<std::string> texts{"*"};
+    for (std::size_t i = 0; i < std::min(extensions.size(), spec.rule_count / 10); ++i)
+    {
+        texts.push_back("*."s + extensions[i]);
+    }
+
+    // Directory rules are sorted so that unanchored rules come first, and parent directories
+    // precede their subdirectories, as in hand-maintained files.  Random values are drawn
+    // in separate statements, since the evaluation order of operands of `+` is unspecified.
+    struct keyed_text
+    {
+        bool anchored;
+        std::string directory;
+        std::string text;
+    };
+    std::vector<keyed_text> keyed_texts;
+    while (texts.size() + keyed_texts.size() < spec.rule_count)
+    {
+        if (directories.empty())
+        {
+            texts.push_back("*."s + random_extension());
+            continue;
+        }
+
+        const std::string dir = random_directory();
+        const std::string name = dir.substr(dir.rfind('/') + 1); // Also correct for `npos`.
+        std::string text;
+        const std::size_t kind = below(rng, 100);
+        if (kind < 15)
+        {
+            text = "/" + dir + "/*.";
+            text += random_extension();
+        }
+        else if (kind < 60)
+        {
+            text = "/" + dir + "/";
+        }
+        else if (kind < 75)
+        {
+            text = "/" + dir + "/*";
+        }
+        else if (kind < 85)
+        {
+            text = "/" + dir + "/**";
+        }
+        else if (kind < 93)
+        {
+            text = "/" + dir + "/**/*.";
+            text += random_extension();
+        }
+        else if (kind < 97)
+        {
+            text = "**/" + name + "/";
+        }
+        else
+        {
+            text = name + "/";
+        }
+        const bool anchored = kind < 93;
+        keyed_texts.push_back({anchored, anchored ? dir : name, std::move(text)});
+    }
+    std::stable_sort(keyed_texts.begin(), keyed_texts.end(), [](const auto& a, const auto& b) {
+        return std::tie(a.anchored, a.directory) < std::tie(b.anchored, b.directory);
+    });
+    // Some rules are out of order, and are partly or fully overridden by later rules.
+    for (std::size_t n = keyed_texts.size() / 20; n > 0; --n)
+    {
+        const std::size_t a = below(rng, keyed_texts.size());
+        const std::size_t b = below(rng, keyed_texts.size());
+        std::swap(keyed_texts[a], keyed_texts[b]);
+    }
+    for (auto& kt : keyed_texts)
+    {
+        texts.push_back(std::move(kt.text));
+    }
+
+    std::vector<annotated_rule> rules;
+    rules.reserve(texts.size());
+    for (std::size_t i = 0; i < texts.size() && i < spec.rule_count; ++i)
+    {
+        std::vector<owner> owners;
+        if (spec.owner_count > 0)
+        {
+            for (std::size_t n = 1 + below(rng, 3); n > 0; --n)
+            {
+                owner o = make_owner(below(rng, spec.owner_count));
+                if (std::find(owners.begin(), owners.end(), o) == owners.end())
+                {
+                    owners.push_back(std::move(o));
+                }
+            }
+        }
+        rules.push_back(annotated_rule{rule_source{"CODEOWNERS", static_cast<std::int32_t>(i + 1)},
+                                       ownership_rule{pattern{texts[i]}, std::move(owners)}});
+    }
+    return rules;
+}
+
+void write_codeowners(std::ostream& os, const std::vector<annotated_rule>& rules)
+{
+    for (const auto& arule : rules)
+    {
+        os << arule.rule.file_pattern;
+        for (const auto& o : arule.rule.owners)
+        {
+            os << ' ' << o;
+        }
+        os << '\n';
+    }
+}
+
+generated_repository generate_repository(const fs::path& root, const repository_spec& repo_spec,
+                                         const codeowners_spec& codeowners_spec)
+{
+    generated_repository result{generate_paths(repo_spec), generate_submodule_paths(repo_spec),
+                                {}};
+    result.rules = generate_rules(codeowners_spec, result.paths);
+
+    fs::create_directories(root);
+    git(root, "init", "-q");
+    write_files(root, result.paths, repo_spec.seed, repo_spec.max_file_size);
+
+    if (!result.submodule_paths.empty())
+    {
+        std::ofstream gitmodules{(root / ".gitmodules").string()};
+        for (std::size_t k = 0; k < result.submodule_paths.size(); ++k)
+        {
+            const fs::path& subm_path = result.submodule_paths[k];
+            const fs::path subm_root = root / subm_path;
+            fs::create_directories(subm_root);
+            git(subm_root, "init", "-q");
+            random_engine rng{repo_spec.seed + k + 1};
+            write_files(subm_root, make_paths(rng, repo_spec.submodule_file_count, 2, 4),
+                        repo_spec.seed + k + 1, repo_spec.max_file_size);
+            git(subm_root, "add", "--all");
+            git(subm_root, "-c", "user.name=codeowners", "-c", "user.email=codeowners@example.com",
+                "commit", "-q", "--allow-empty", "-m", "Generated submodule");
+
+            const std::string p = subm_path.generic_string();
+            gitmodules << "[submodule \"" << p << "\"]\n"
+                       << "\tpath = " << p << '\n'
+                       << "\turl = ./" << p << '\n';
+        }
+        if (!gitmodules.flush())
+        {
+            throw error{"Cannot write " + (root / ".gitmodules").string()};
+        }
+    }
+
+    {
+        std::ofstream codeowners{(root / "CODEOWNERS").string()};
+        write_codeowners(codeowners, result.rules);
+        if (!codeowners.flush())
+        {
+            throw error{"Cannot write " + (root / "CODEOWNERS").string()};
+        }
+    }
+    // Submodules, which are repositories within the work tree, are added as gitlinks.
+    git(root, "add", "--all");
+    return result;
+}
+
+} // end namespace 'co'
@@ -5,6 +5,7 @@
 
 #include <git2/buffer.h>
 #include <git2/index.h>
+#include <git2/object.h>
 #include <git2/repository.h>
 
 #include <memory>
@@ -40,6 +41,14 @@ struct resource_traits<::git_index_iterator>
     constexpr static const char* resource_name = "git_index_iterator";
 };
 
+template <>
+struct resource_traits<::git_object>
+{
+    using value_type = ::git_object;
+    constexpr static deleter_type<value_type> deleter = ::git_object_free;
+    constexpr static const char* resource_name = "git_object";
+};
+
 template <typename T, typename F, typename... Args>
 std::unique_ptr<T, deleter_type<T>> make_resource_ptr(F f, Args... args)
 {
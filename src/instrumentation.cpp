@@ -0,0 +1,155 @@
+#include <codeowners/instrumentation.hpp>
+
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+
+namespace co
+{
+
+namespace
+{
+    /// Innermost active timer on this thread.
+    thread_local phase_timer* current_timer = nullptr;
+} // end anonymous namespace
+
+std::atomic<bool> instrumentation::s_enabled{false};
+std::array<std::atomic<std::int64_t>, instrumentation::phase_count> instrumentation::s_times{};
+std::array<std::atomic<std::uint64_t>, instrumentation::counter_count>
+    instrumentation::s_counts{};
+
+const char* to_string(phase p)
+{
+    switch (p)
+    {
+    case phase::DISCOVERY:
+        return "discovery";
+    case phase::SUBMODULES:
+        return "submodules";
+    case phase::PARSE:
+        return "parse";
+    case phase::COMPILE:
+        return "compile";
+    case phase::TRAVERSAL:
+        return "traversal";
+    case phase::MATCH:
+        return "match";
+    case phase::OUTPUT:
+        return "output";
+    }
+    return "unknown";
+}
+
+const char* to_string(counter c)
+{
+    switch (c)
+    {
+    case counter::DIRECTORIES_VISITED:
+        return "directories_visited";
+    case counter::FILES_VISITED:
+        return "files_visited";
+    case counter::FILES_MATCHED:
+        return "files_matched";
+    case counter::SUBTREES_DETERMINED:
+        return "subtrees_determined";
+    case counter::RULES_EVALUATED:
+        return "rules_evaluated";
+    case counter::DIRECTORY_CACHE_HITS:
+        return "directory_cache_hits";
+    case counter::DIRECTORY_CACHE_MISSES:
+        return "directory_cache_misses";
+    case counter::SKIP_CHECKS:
+        return "skip_checks";
+    }
+    return "unknown";
+}
+
+bool instrumentation::enable(bool on) noexcept
+{
+#if CODEOWNERS_INSTRUMENTATION
+    s_enabled.store(on, std::memory_order_relaxed);
+    return true;
+#else
+    return !on;
+#endif
+}
+
+std::uint64_t instrumentation::count(counter c) noexcept
+{
+    return s_counts[static_cast<std::size_t>(c)].load(std::memory_order_relaxed);
+}
+
+std::chrono::nanoseconds instrumentation::time(phase p) noexcept
+{
+    return std::chrono::nanoseconds{s_times[static_cast<std::size_t>(p)].load(
+        std::memory_order_relaxed)};
+}
+
+void instrumentation::reset() noexcept
+{
+    for (auto& t : s_times)
+    {
+        t.store(0, std::memory_order_relaxed);
+    }
+    for (auto& c : s_counts)
+    {
+        c.store(0, std::memory_order_relaxed);
+    }
+}
+
+std::ostream& instrumentation::report(std::ostream& os)
+{
+    // Format into a local stream, so that the caller's formatting state is unchanged.
+    std::ostringstream oss;
+    oss << "Phase times (ms):\n";
+    for (std::size_t i = 0; i < phase_count; ++i)
+    {
+        const auto p = static_cast<phase>(i);
+        const std::chrono::duration<double, std::milli> ms = time(p);
+        oss << "  " << std::left << std::setw(24) << to_string(p) << std::right << std::fixed
+            << std::setprecision(3) << std::setw(12) << ms.count() << '\n';
+    }
+    oss << "Counters:\n";
+    for (std::size_t i = 0; i < counter_count; ++i)
+    {
+        const auto c = static_cast<counter>(i);
+        oss << "  " << std::left << std::setw(24) << to_string(c) << std::right << std::setw(12)
+            << count(c) << '\n';
+    }
+    return os << oss.str();
+}
+
+void phase_timer::start(phase p) noexcept
+{
+    m_active = true;
+    m_phase = p;
+    m_parent = current_timer;
+    current_timer = this;
+    m_start = clock::now();
+}
+
+void phase_timer::stop() noexcept
+{
+    const clock::time_point end = clock::now();
+    const clock::duration elapsed = end - m_start;
+    instrumentation::add(m_phase, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                      elapsed - m_nested));
+    current_timer = m_parent;
+    if (m_parent)
+    {
+        m_parent->m_nested += elapsed;
+    }
+
+    if (tracer::enabled() && m_phase != phase::MATCH && m_phase != phase::OUTPUT
+        && !(m_parent && m_parent->m_phase == m_phase))
+    {
+        trace_event event{};
+        event.name = to_string(m_phase);
+        event.category = "phase";
+        event.begin = m_start;
+        event.end = end;
+        tracer::record(std::move(event));
+    }
+}
+
+} // end namespace 'co'
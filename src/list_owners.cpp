@@ -0,0 +1,289 @@
+#include <codeowners/list_owners.hpp>
+
+#include <codeowners/instrumentation.hpp>
+#include <codeowners/recursive_filter_iterator.hpp>
+#include <codeowners/trace.hpp>
+
+#include <cassert>
+#include <chrono>
+#include <new>
+#include <ostream>
+
+namespace co
+{
+
+namespace
+{
+    /**
+     * When tracing is enabled, records a span for each run of consecutive entries with the
+     * same parent directory, with the number of files in the run, the number matched
+     * individually, and the time spent matching them.  Matching is interleaved with
+     * traversal file by file, so it is reported per run rather than as spans of its own.
+     */
+    class directory_batch_trace
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        directory_batch_trace() : m_enabled{tracer::enabled()} {}
+
+        directory_batch_trace(const directory_batch_trace&) = delete;
+        directory_batch_trace& operator=(const directory_batch_trace&) = delete;
+
+        ~directory_batch_trace() { close(); }
+
+        bool enabled() const { return m_enabled; }
+
+        /// Start a new run if `entry` is not in the directory of the current run.
+        void next(const fs::path& entry)
+        {
+            if (!m_enabled)
+            {
+                return;
+            }
+            fs::path directory = entry.parent_path();
+            if (m_active && directory == m_directory)
+            {
+                return;
+            }
+            close();
+            m_active = true;
+            m_directory = std::move(directory);
+            m_begin = clock::now();
+            m_files = 0;
+            m_matched = 0;
+            m_match_time = clock::duration::zero();
+        }
+
+        void add_file() { ++m_files; }
+
+        void add_match(clock::duration elapsed)
+        {
+            ++m_matched;
+            m_match_time += elapsed;
+        }
+
+    private:
+        void close() noexcept
+        {
+            if (!m_active)
+            {
+                return;
+            }
+            m_active = false;
+            trace_event event{};
+            event.name = "directory";
+            event.category = "traversal";
+            event.begin = m_begin;
+            event.end = clock::now();
+            try
+            {
+                event.detail = m_directory.string();
+            }
+            catch (const std::bad_alloc&)
+            {
+            }
+            event.args = {{{"files", m_files},
+                           {"matched", m_matched},
+                           {"match_ns", std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                            m_match_time)
+                                            .count()}}};
+            event.arg_count = 3;
+            tracer::record(std::move(event));
+        }
+
+        const bool m_enabled;
+        bool m_active = false;
+        fs::path m_directory;
+        clock::time_point m_begin;
+        std::int64_t m_files = 0;
+        std::int64_t m_matched = 0;
+        clock::duration m_match_time = clock::duration::zero();
+    };
+} // end anonymous namespace
+
+void for_each_owned_file(ruleset::cursor& cursor, const fs::path& work_dir,
+                         const fs::path& start_path, const std::vector<fs::path>& to_skip,
+                         const owned_file_visitor& visit, const rule_filter& wanted)
+{
+    const auto is_wanted
+        = [&wanted](std::optional<ruleset::rule_id> id) { return !wanted || wanted(id); };
+    phase_timer timer{phase::TRAVERSAL};
+    // When a directory whose files all have the same owner is being traversed, `in_subtree`
+    // is set, and `subtree_depth` is the depth of the directory.
+    bool in_subtree = false;
+    int subtree_depth = 0;
+    std::optional<ruleset::rule_id> subtree_rule;
+    relative_path_builder relative{work_dir, start_path};
+    if (fs::is_directory(start_path))
+    {
+        auto subtree = cursor.find_subtree(relative(start_path));
+        if (subtree.determined)
+        {
+            instrumentation::add(counter::SUBTREES_DETERMINED);
+            if (!is_wanted(subtree.rule))
+            {
+                return;
+            }
+            in_subtree = true;
+            subtree_depth = -1;
+            subtree_rule = subtree.rule;
+        }
+    }
+
+    directory_batch_trace batch;
+    auto file_range = make_filtered_file_range(start_path, to_skip);
+    for (auto it = file_range.begin(); it != file_range.end(); ++it)
+    {
+        const int depth = it.base().depth();
+        if (in_subtree && depth <= subtree_depth)
+        {
+            in_subtree = false;
+        }
+
+        const fs::directory_entry& entry = *it;
+        const fs::path& path = entry.path();
+        batch.next(path);
+        if (fs::is_directory(entry.status()))
+        {
+            instrumentation::add(counter::DIRECTORIES_VISITED);
+            if (!in_subtree)
+            {
+                auto subtree = cursor.find_subtree(relative(path));
+                if (subtree.determined)
+                {
+                    instrumentation::add(counter::SUBTREES_DETERMINED);
+                    if (!is_wanted(subtree.rule))
+                    {
+                        it.no_push();
+                        continue;
+                    }
+                    in_subtree = true;
+                    subtree_depth = depth;
+                    subtree_rule = subtree.rule;
+                }
+            }
+            continue;
+        }
+
+        instrumentation::add(counter::FILES_VISITED);
+        batch.add_file();
+        const fs::path& relative_path = relative(path);
+        if (in_subtree)
+        {
+            visit(entry, relative_path.native(), subtree_rule);
+            continue;
+        }
+        instrumentation::add(counter::FILES_MATCHED);
+        std::optional<ruleset::rule_id> rule_id;
+        if (batch.enabled())
+        {
+            const auto begin = directory_batch_trace::clock::now();
+            rule_id = cursor.find(relative_path);
+            batch.add_match(directory_batch_trace::clock::now() - begin);
+        }
+        else
+        {
+            rule_id = cursor.find(relative_path);
+        }
+        if (is_wanted(rule_id))
+        {
+            visit(entry, relative_path.native(), rule_id);
+        }
+    }
+}
+
+void for_each_matched_file(ruleset::cursor& cursor, const fs::path& work_dir,
+                           const fs::path& start_path, const std::vector<fs::path>& to_skip,
+                           const matched_file_visitor& visit)
+{
+    phase_timer timer{phase::TRAVERSAL};
+    // While a directory in which no rule can match a file is being traversed, `in_unmatched`
+    // is set, and `unmatched_depth` is the depth of the directory.
+    bool in_unmatched = false;
+    int unmatched_depth = 0;
+    relative_path_builder relative{work_dir, start_path};
+    const auto no_rule_within = [&](const fs::path& dir) {
+        const ruleset::subtree_match subtree = cursor.find_subtree(relative(dir));
+        return subtree.determined && !subtree.rule;
+    };
+    if (fs::is_directory(start_path) && no_rule_within(start_path))
+    {
+        instrumentation::add(counter::SUBTREES_DETERMINED);
+        in_unmatched = true;
+        unmatched_depth = -1;
+    }
+
+    std::vector<ruleset::rule_id> matching;
+    auto file_range = make_filtered_file_range(start_path, to_skip);
+    for (auto it = file_range.begin(); it != file_range.end(); ++it)
+    {
+        const int depth = it.base().depth();
+        if (in_unmatched && depth <= unmatched_depth)
+        {
+            in_unmatched = false;
+        }
+
+        const fs::directory_entry& entry = *it;
+        const fs::path& path = entry.path();
+        if (fs::is_directory(entry.status()))
+        {
+            instrumentation::add(counter::DIRECTORIES_VISITED);
+            if (!in_unmatched && no_rule_within(path))
+            {
+                instrumentation::add(counter::SUBTREES_DETERMINED);
+                in_unmatched = true;
+                unmatched_depth = depth;
+            }
+            continue;
+        }
+
+        instrumentation::add(counter::FILES_VISITED);
+        if (in_unmatched)
+        {
+            matching.clear();
+            visit(entry, matching, std::nullopt);
+            continue;
+        }
+        instrumentation::add(counter::FILES_MATCHED);
+        const auto rule_id = cursor.find_all(relative(path), matching);
+        visit(entry, matching, rule_id);
+    }
+}
+
+rule_coverage::rule_coverage(const ruleset& rules)
+    : m_ruleset{&rules}
+    , m_counts(rules.size())
+{
+}
+
+void rule_coverage::merge(const rule_coverage& other)
+{
+    assert(m_ruleset == other.m_ruleset);
+    assert(m_counts.size() == other.m_counts.size());
+    for (std::size_t i = 0; i < m_counts.size(); ++i)
+    {
+        m_counts[i].matches += other.m_counts[i].matches;
+        m_counts[i].wins += other.m_counts[i].wins;
+    }
+    m_unmatched += other.m_unmatched;
+    m_files += other.m_files;
+}
+
+std::ostream& operator<<(std::ostream& os, const rule_coverage& coverage)
+{
+    os << "line\tpattern\tmatches\twins\n";
+    for (ruleset::rule_id id = 0; id < coverage.m_counts.size(); ++id)
+    {
+        const annotated_rule rule = coverage.m_ruleset->rule(id);
+        const rule_coverage_counts& counts = coverage.m_counts[id];
+        os << rule.source.line << '\t' << rule.rule.file_pattern.value() << '\t'
+           << counts.matches << '\t' << counts.wins << '\n';
+    }
+    // Every file is won by one rule, or by none.
+    os << "\t[NO_RULE]\t" << coverage.m_unmatched << '\t' << coverage.m_unmatched << '\n';
+    os << "\t[TOTAL]\t" << coverage.m_files << '\t' << coverage.m_files << '\n';
+    return os;
+}
+
+} // end namespace 'co'
@@ -0,0 +1,187 @@
+#include <codeowners/errors.hpp>
+#include <codeowners/instrumentation.hpp>
+#include <codeowners/mapped_parser.hpp>
+
+#include "text_scanner.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace co
+{
+
+namespace
+{
+    [[noreturn]] void throw_system_error(const char* what, const fs::path& path, int err)
+    {
+        using namespace std::string_literals;
+        if (err == ENOENT)
+        {
+            throw file_not_found_error{"File not found: "s + path.c_str()};
+        }
+        throw error{what + " "s + path.c_str() + ": " + std::strerror(err)};
+    }
+
+} // end anonymous namespace
+
+/// Read-only memory mapping of a whole file.
+class codeowners_view::mapping
+{
+public:
+    explicit mapping(const fs::path& path)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            throw_system_error("Cannot open", path, errno);
+        }
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0)
+        {
+            const int err = errno;
+            ::close(fd);
+            throw_system_error("Cannot stat", path, err);
+        }
+
+        // An empty file cannot be mapped, and needs no mapping.
+        m_size = static_cast<std::size_t>(st.st_size);
+        if (m_size > 0)
+        {
+            void* addr = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED)
+            {
+                const int err = errno;
+                ::close(fd);
+                throw_system_error("Cannot map", path, err);
+            }
+            m_data = static_cast<const char*>(addr);
+            // The file is scanned once, from start to end.
+            ::madvise(addr, m_size, MADV_SEQUENTIAL);
+        }
+        ::close(fd);
+    }
+
+    mapping(const mapping&) = delete;
+    mapping& operator=(const mapping&) = delete;
+
+    ~mapping()
+    {
+        if (m_data)
+        {
+            ::munmap(const_cast<char*>(m_data), m_size);
+        }
+    }
+
+    std::string_view contents() const { return {m_data, m_size}; }
+
+private:
+    const char* m_data = nullptr;
+    std::size_t m_size = 0;
+};
+
+ownership_rule codeowners_view::rule_view::to_rule() const
+{
+    std::vector<owner> owners;
+    owners.reserve(owner_count());
+    for (auto it = owners_begin(); it != owners_end(); ++it)
+    {
+        owners.emplace_back(std::string{*it});
+    }
+    return ownership_rule{pattern{std::string{file_pattern()}}, std::move(owners)};
+}
+
+codeowners_view::codeowners_view(std::string_view content, std::string source_name)
+    : m_mapping{}
+    , m_source_name{std::move(source_name)}
+    , m_tokens{}
+    , m_rules{}
+{
+    tokenize(content);
+}
+
+codeowners_view::codeowners_view(std::unique_ptr<mapping> map, std::string source_name)
+    : m_mapping{std::move(map)}
+    , m_source_name{std::move(source_name)}
+    , m_tokens{}
+    , m_rules{}
+{
+    tokenize(m_mapping->contents());
+}
+
+codeowners_view codeowners_view::map(const fs::path& path, const std::string& source_name)
+{
+    // Use `source_name` if provided.
+    return codeowners_view{std::make_unique<mapping>(path),
+                           source_name.empty() ? path.string() : source_name};
+}
+
+codeowners_view::codeowners_view(codeowners_view&& other) noexcept = default;
+codeowners_view& codeowners_view::operator=(codeowners_view&& other) noexcept = default;
+codeowners_view::~codeowners_view() = default;
+
+void codeowners_view::tokenize(std::string_view content)
+{
+    text_scanner scanner{content};
+    std::size_t pos = 0;
+    std::int32_t line = 0;
+
+    while (pos < content.size())
+    {
+        ++line;
+        const std::size_t eol = scanner.find_newline(pos);
+
+        const std::size_t first_token = m_tokens.size();
+        while ((pos = scanner.find_non_space(pos)) < eol)
+        {
+            const std::size_t token = pos;
+            pos = scanner.find_space(pos);
+            // A line whose first token begins with `#` is a comment.
+            if (m_tokens.size() == first_token && content[token] == '#')
+            {
+                break;
+            }
+            m_tokens.push_back(content.substr(token, pos - token));
+        }
+
+        const std::size_t size = m_tokens.size() - first_token;
+        if (size > 0)
+        {
+            // Token addresses are assigned once the token buffer is complete.
+            m_rules.push_back(rule_view{line, nullptr, size});
+        }
+        pos = eol + 1;
+    }
+
+    // Rules' tokens are stored consecutively, in order.
+    const std::string_view* tokens = m_tokens.data();
+    for (rule_view& rule : m_rules)
+    {
+        rule.m_tokens = tokens;
+        tokens += rule.m_size;
+    }
+}
+
+std::vector<annotated_rule> codeowners_view::to_annotated_rules() const
+{
+    std::vector<annotated_rule> result;
+    result.reserve(m_rules.size());
+    for (const rule_view& rule : m_rules)
+    {
+        result.push_back(annotated_rule{source(rule), rule.to_rule()});
+    }
+    return result;
+}
+
+std::vector<annotated_rule> parse_mapped(const fs::path& path, const std::string& source_name)
+{
+    phase_timer timer{phase::PARSE};
+    return codeowners_view::map(path, source_name).to_annotated_rules();
+}
+
+} // end namespace 'co'
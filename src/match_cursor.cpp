@@ -0,0 +1,222 @@
+#include "match_cursor.hpp"
+
+#include <codeowners/instrumentation.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace co
+{
+
+namespace
+{
+    /// Split a relative path into its directory, which is empty at the top level, and name.
+    std::pair<std::string_view, std::string_view> split_path(std::string_view path)
+    {
+        const auto slash = path.rfind('/');
+        if (slash == std::string_view::npos)
+        {
+            return {"", path};
+        }
+        return {path.substr(0, slash), path.substr(slash + 1)};
+    }
+} // end anonymous namespace
+
+match_cursor::match_cursor(const std::vector<compiled_pattern>& patterns,
+                           match_profile* profile, bool all_matches)
+    : m_patterns{&patterns}
+    , m_profile{profile}
+    , m_all_matches{all_matches}
+    , m_entries{}
+    , m_coverings{}
+    , m_frames{}
+    , m_directory{}
+{
+    // Root frame:  every pattern in its initial state.
+    std::size_t covering = npos;
+    for (std::size_t pos = 0; pos < patterns.size(); ++pos)
+    {
+        const compiled_pattern& pat = patterns[pos];
+        const auto state = pat.initial_state();
+        if (pat.matches_all_from(state))
+        {
+            covering = pos;
+            if (m_all_matches)
+            {
+                m_coverings.push_back(pos);
+            }
+        }
+        else if (pat.is_live(state))
+        {
+            m_entries.push_back(entry{pos, state});
+        }
+    }
+
+    // Patterns before the covering pattern can never take precedence over it.
+    if (!m_all_matches)
+    {
+        auto first_kept
+            = std::find_if(m_entries.begin(), m_entries.end(), [covering](const entry& e) {
+                  return covering == npos || e.position > covering;
+              });
+        m_entries.erase(m_entries.begin(), first_kept);
+    }
+    m_frames.push_back(frame{0, m_entries.size(), covering, m_coverings.size(), 0, 0});
+}
+
+std::size_t match_cursor::find(std::string_view path)
+{
+    const auto [dir, name] = split_path(path);
+    const frame& f = enter(dir);
+    // Entries are ordered by position, so the first match from the back is the last pattern.
+    std::size_t evaluated = 0;
+    for (std::size_t i = f.entries_end; i-- > f.entries_begin;)
+    {
+        const entry& e = m_entries[i];
+        if (f.covering != npos && e.position < f.covering)
+        {
+            break; // Kept only to find all matches.
+        }
+        ++evaluated;
+        const compiled_pattern& pat = (*m_patterns)[e.position];
+        if (profiled_evaluation(m_profile, e.position,
+                                [&] { return pat.is_file_match(pat.step(e.state, name)); }))
+        {
+            instrumentation::add(counter::RULES_EVALUATED, evaluated);
+            profiled_result(m_profile, e.position);
+            return e.position;
+        }
+    }
+    instrumentation::add(counter::RULES_EVALUATED, evaluated);
+    profiled_result(m_profile, f.covering);
+    return f.covering;
+}
+
+std::size_t match_cursor::find_all(std::string_view path, std::vector<std::size_t>& positions)
+{
+    assert(m_all_matches);
+    const auto [dir, name] = split_path(path);
+    const frame& f = enter(dir);
+    positions.assign(m_coverings.begin(), m_coverings.begin() + f.coverings_end);
+    for (std::size_t i = f.entries_begin; i < f.entries_end; ++i)
+    {
+        const entry& e = m_entries[i];
+        const compiled_pattern& pat = (*m_patterns)[e.position];
+        if (profiled_evaluation(m_profile, e.position,
+                                [&] { return pat.is_file_match(pat.step(e.state, name)); }))
+        {
+            positions.push_back(e.position);
+        }
+    }
+    instrumentation::add(counter::RULES_EVALUATED, f.entries_end - f.entries_begin);
+    // Patterns covering a directory may precede those covering its parents, or live ones.
+    std::sort(positions.begin(), positions.end());
+    const std::size_t last = positions.empty() ? npos : positions.back();
+    profiled_result(m_profile, last);
+    return last;
+}
+
+std::optional<std::size_t> match_cursor::find_within(std::string_view dir)
+{
+    const frame& f = enter(dir);
+    if (f.entries_begin == f.entries_end)
+    {
+        profiled_result(m_profile, f.covering);
+        return f.covering;
+    }
+    return std::nullopt;
+}
+
+auto match_cursor::enter(std::string_view dir) -> const frame&
+{
+    component_reader reader{dir};
+    std::size_t depth = 0;
+    bool diverged = false;
+    while (!reader.empty())
+    {
+        const std::string_view c = reader.next();
+        if (!diverged && depth + 1 < m_frames.size() && component(m_frames[depth + 1]) == c)
+        {
+            ++depth;
+            continue;
+        }
+        if (!diverged)
+        {
+            truncate(depth);
+            diverged = true;
+        }
+        push_frame(c);
+        ++depth;
+    }
+    if (!diverged)
+    {
+        truncate(depth);
+    }
+    assert(m_frames.size() == depth + 1);
+    return m_frames.back();
+}
+
+void match_cursor::truncate(std::size_t depth)
+{
+    assert(depth < m_frames.size());
+    m_frames.resize(depth + 1);
+    m_entries.resize(m_frames.back().entries_end);
+    m_coverings.resize(m_frames.back().coverings_end);
+    m_directory.resize(m_frames.back().component_end);
+}
+
+void match_cursor::push_frame(std::string_view c)
+{
+    const frame parent = m_frames.back();
+    assert(parent.entries_end == m_entries.size());
+
+    if (!m_directory.empty())
+    {
+        m_directory.push_back('/');
+    }
+    const std::size_t component_begin = m_directory.size();
+    m_directory.append(c.data(), c.size());
+
+    std::size_t covering = parent.covering;
+    const std::size_t entries_begin = m_entries.size();
+    instrumentation::add(counter::RULES_EVALUATED, parent.entries_end - parent.entries_begin);
+    for (std::size_t i = parent.entries_begin; i < parent.entries_end; ++i)
+    {
+        const entry e = m_entries[i];
+        const compiled_pattern& pat = (*m_patterns)[e.position];
+        const auto state
+            = profiled_evaluation(m_profile, e.position, [&] { return pat.step(e.state, c); });
+        if (pat.matches_all_from(state))
+        {
+            // Entries are in increasing order of position, but when all matches are kept,
+            // they include patterns before the parent's covering pattern.
+            if (covering == npos || e.position > covering)
+            {
+                covering = e.position;
+            }
+            if (m_all_matches)
+            {
+                m_coverings.push_back(e.position);
+            }
+        }
+        else if (pat.is_live(state))
+        {
+            m_entries.push_back(entry{e.position, state});
+        }
+    }
+
+    // Patterns before the covering pattern can never take precedence over it.
+    if (!m_all_matches)
+    {
+        auto first_kept = std::find_if(
+            m_entries.begin() + entries_begin, m_entries.end(),
+            [covering](const entry& e) { return covering == npos || e.position > covering; });
+        m_entries.erase(m_entries.begin() + entries_begin, first_kept);
+    }
+
+    m_frames.push_back(frame{entries_begin, m_entries.size(), covering, m_coverings.size(),
+                             component_begin, m_directory.size()});
+}
+
+} // end namespace 'co'
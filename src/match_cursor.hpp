@@ -0,0 +1,109 @@
+#pragma once
+
+#include "compiled_pattern.hpp"
+#include "match_profile.hpp"
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace co
+{
+
+/**
+ * The match_cursor class finds the last pattern, in a sequence of compiled patterns, that
+ * matches each of a series of relative paths.
+ *
+ * The cursor keeps a stack of matching states, one frame per component of the directory of
+ * the previous path.  Each frame holds the patterns that can still match something within
+ * that directory, and the pattern (if any) that already matches everything within it.
+ * When the next path shares parent directories with the previous one, as is the case for
+ * sorted paths or depth-first traversals, matching resumes from the deepest common frame,
+ * so only the differing components are processed.
+ *
+ * Any sequence of paths is supported; the order only affects performance.  The cursor
+ * refers to the pattern sequence, which must outlive the cursor and must not be modified.
+ * If a profile is given, pattern evaluations and lookup results are recorded in it.
+ *
+ * By default, patterns before one that matches everything within a directory are dropped
+ * from the directory's frame, as they can no longer be the last match.  A cursor created
+ * with `all_matches` keeps them, and also records every pattern that matches everything
+ * within each directory, so that `find_all` can report every matching pattern.
+ */
+class match_cursor
+{
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    explicit match_cursor(const std::vector<compiled_pattern>& patterns,
+                          match_profile* profile = nullptr, bool all_matches = false);
+
+    /// Return the position of the last pattern that matches the file at relative path
+    /// `path`, or `npos` if no pattern matches.
+    std::size_t find(std::string_view path);
+
+    /// Replace the contents of `positions` with the positions of every pattern that matches
+    /// the file at relative path `path`, in increasing order, and return the last of them,
+    /// or `npos` if no pattern matches.  The cursor must have been created with
+    /// `all_matches`.  Every pattern that may match is evaluated, so this is slower than
+    /// `find`.
+    std::size_t find_all(std::string_view path, std::vector<std::size_t>& positions);
+
+    /// If the same pattern (or no pattern) matches every file within the relative directory
+    /// `dir`, return its position (or `npos`).  Otherwise, return an empty optional.  As
+    /// with `compiled_pattern::matches_all_within`, the analysis is conservative.
+    std::optional<std::size_t> find_within(std::string_view dir);
+
+private:
+    /// Matching state of a single pattern after consuming a directory's components.
+    struct entry
+    {
+        std::size_t position;
+        compiled_pattern::state_type state;
+    };
+
+    struct frame
+    {
+        /// Range of live entries in `m_entries`, in increasing order of position.
+        std::size_t entries_begin;
+        std::size_t entries_end;
+        /// Last pattern that matches every file within the directory, or `npos`.
+        /// Unless all matches are kept, entries are only kept for patterns after this one.
+        std::size_t covering;
+        /// End of the patterns in `m_coverings` that match every file within the directory,
+        /// if all matches are kept.
+        std::size_t coverings_end;
+        /// Range of the directory's final component in `m_directory`.
+        std::size_t component_begin;
+        std::size_t component_end;
+    };
+
+    /// Move the cursor to relative directory `dir`, and return its frame.
+    const frame& enter(std::string_view dir);
+    void truncate(std::size_t depth);
+    void push_frame(std::string_view component);
+    std::string_view component(const frame& f) const
+    {
+        return std::string_view{m_directory}.substr(f.component_begin,
+                                                    f.component_end - f.component_begin);
+    }
+
+private:
+    const std::vector<compiled_pattern>* m_patterns;
+    match_profile* m_profile;
+    /// Whether entries are kept for every pattern that may match, including covering ones.
+    bool m_all_matches;
+    /// Storage for the entries of all frames.
+    std::vector<entry> m_entries;
+    /// If all matches are kept, the positions of the patterns that match every file within
+    /// the current directory, starting with those of the root.  Each frame refers to a
+    /// prefix of them.
+    std::vector<std::size_t> m_coverings;
+    /// Frames for the current directory and each of its parents, starting with the root.
+    std::vector<frame> m_frames;
+    /// Current directory path, whose components are referred to by `m_frames`.
+    std::string m_directory;
+};
+
+} // end namespace 'co'
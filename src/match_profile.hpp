@@ -0,0 +1,115 @@
+#pragma once
+
+#include <codeowners/instrumentation.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace co
+{
+
+/**
+ * The match_profile class counts, for each pattern in a sequence, how often it was
+ * evaluated against a path or path component, how often it was the result of a lookup,
+ * and the time spent evaluating it.
+ *
+ * Evaluation times include the cost of reading the clock, which is comparable to the cost
+ * of evaluating a simple pattern, so they are most useful for comparing patterns.  Counters
+ * are relaxed atomics, so a profile may be shared by cursors on several threads.
+ */
+class match_profile
+{
+public:
+    struct pattern_counts
+    {
+        std::uint64_t evaluations;
+        std::uint64_t wins;
+        std::chrono::nanoseconds time;
+    };
+
+    explicit match_profile(std::size_t size)
+        : m_size{size}
+        , m_counters{std::make_unique<counters[]>(size)}
+    {
+    }
+
+    std::size_t size() const { return m_size; }
+
+    /// Return `f()`, recording an evaluation of the pattern at `pos`.
+    template <typename F> auto evaluate(std::size_t pos, F&& f)
+    {
+        const auto begin = std::chrono::steady_clock::now();
+        const auto result = f();
+        const auto elapsed = std::chrono::steady_clock::now() - begin;
+        counters& c = m_counters[pos];
+        c.evaluations.fetch_add(1, std::memory_order_relaxed);
+        c.time_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+                            std::memory_order_relaxed);
+        return result;
+    }
+
+    /// Record that a lookup resulted in the pattern at `pos`, unless `pos` is out of range,
+    /// meaning that no pattern matched.
+    void add_win(std::size_t pos)
+    {
+        if (pos < m_size)
+        {
+            m_counters[pos].wins.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    pattern_counts counts(std::size_t pos) const
+    {
+        const counters& c = m_counters[pos];
+        return pattern_counts{c.evaluations.load(std::memory_order_relaxed),
+                              c.wins.load(std::memory_order_relaxed),
+                              std::chrono::nanoseconds{c.time_ns.load(std::memory_order_relaxed)}};
+    }
+
+private:
+    struct counters
+    {
+        std::atomic<std::uint64_t> evaluations{0};
+        std::atomic<std::uint64_t> wins{0};
+        std::atomic<std::int64_t> time_ns{0};
+    };
+
+    std::size_t m_size;
+    std::unique_ptr<counters[]> m_counters;
+};
+
+/// Return `f()`, recorded as an evaluation of the pattern at `pos` if `profile` is not
+/// null.  Without instrumentation, this is just `f()`.
+template <typename F>
+inline auto profiled_evaluation(match_profile* profile, std::size_t pos, F&& f)
+{
+#if CODEOWNERS_INSTRUMENTATION
+    if (profile)
+    {
+        return profile->evaluate(pos, std::forward<F>(f));
+    }
+#else
+    (void)profile;
+    (void)pos;
+#endif
+    return f();
+}
+
+/// Record a lookup result, if `profile` is not null.
+inline void profiled_result(match_profile* profile, std::size_t pos)
+{
+#if CODEOWNERS_INSTRUMENTATION
+    if (profile)
+    {
+        profile->add_win(pos);
+    }
+#else
+    (void)profile;
+    (void)pos;
+#endif
+}
+
+} // end namespace 'co'
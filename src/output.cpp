@@ -0,0 +1,269 @@
+#include "utf8.hpp"
+#include <codeowners/errors.hpp>
+#include <codeowners/instrumentation.hpp>
+#include <codeowners/output.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <unistd.h>
+
+namespace co
+{
+
+namespace
+{
+    constexpr std::string_view no_owner_marker = "[NO_OWNER]";
+
+    /// Return whether `c` must be escaped in the given format.
+    bool needs_escape(output_format format, char c)
+    {
+        switch (format)
+        {
+        case output_format::TSV:
+            return c == '\t' || c == '\n' || c == '\r' || c == '\\';
+        case output_format::JSONL:
+            return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20
+                || static_cast<unsigned char>(c) >= 0x80;
+        default:
+            return false;
+        }
+    }
+
+} // end anonymous namespace
+
+output_format parse_output_format(std::string_view name)
+{
+    if (name == "text")
+        return output_format::TEXT;
+    if (name == "tsv")
+        return output_format::TSV;
+    if (name == "jsonl")
+        return output_format::JSONL;
+    if (name == "nul")
+        return output_format::NUL;
+
+    using namespace std::string_literals;
+    throw error{"Unrecognized output format: "s + std::string{name}};
+}
+
+output_writer::output_writer(int fd, output_format format, std::size_t capacity)
+    : m_fd{fd}
+    , m_format{format}
+    , m_buffer(std::max<std::size_t>(capacity, 1))
+    , m_size{0}
+{
+}
+
+output_writer::~output_writer()
+{
+    try
+    {
+        flush();
+    }
+    catch (const error&)
+    {
+        // Ignore errors to prevent an exception propagating outside destructor.
+    }
+}
+
+void output_writer::write(std::string_view path, const std::vector<owner>& owners)
+{
+    phase_timer timer{phase::OUTPUT};
+    begin_record(path, owners.empty());
+    for (std::size_t i = 0; i < owners.size(); ++i)
+    {
+        append_owner(owners[i].value(), i == 0);
+    }
+    end_record();
+}
+
+void output_writer::write(std::string_view path, array_view<std::string_view> owners)
+{
+    phase_timer timer{phase::OUTPUT};
+    begin_record(path, owners.empty());
+    for (std::size_t i = 0; i < owners.size(); ++i)
+    {
+        append_owner(owners[i], i == 0);
+    }
+    end_record();
+}
+
+void output_writer::begin_record(std::string_view path, bool unowned)
+{
+    switch (m_format)
+    {
+    case output_format::TEXT:
+        append(path);
+        append(":    ");
+        if (unowned)
+        {
+            append(no_owner_marker);
+        }
+        break;
+    case output_format::TSV:
+        append_escaped(path);
+        put('\t');
+        break;
+    case output_format::JSONL:
+        append(R"({"path":)");
+        append_json_string(path);
+        append(R"(,"owners":[)");
+        break;
+    case output_format::NUL:
+        append(path);
+        put('\0');
+        break;
+    }
+}
+
+void output_writer::append_owner(std::string_view name, bool first)
+{
+    if (!first)
+    {
+        put(m_format == output_format::JSONL ? ',' : ' ');
+    }
+    if (m_format == output_format::JSONL)
+    {
+        append_json_string(name);
+    }
+    else
+    {
+        append_escaped(name);
+    }
+}
+
+void output_writer::end_record()
+{
+    switch (m_format)
+    {
+    case output_format::JSONL:
+        append("]}\n");
+        break;
+    case output_format::NUL:
+        put('\0');
+        break;
+    default:
+        put('\n');
+        break;
+    }
+}
+
+void output_writer::flush()
+{
+    if (m_size == 0)
+    {
+        return;
+    }
+    phase_timer timer{phase::OUTPUT};
+    trace_span span{"flush", "output"};
+    span.add_arg("bytes", static_cast<std::int64_t>(m_size));
+    const char* data = m_buffer.data();
+    std::size_t remaining = m_size;
+    while (remaining > 0)
+    {
+        const ::ssize_t written = ::write(m_fd, data, remaining);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            m_size = 0;
+            using namespace std::string_literals;
+            throw error{"Error while writing output: "s + std::strerror(errno)};
+        }
+        data += written;
+        remaining -= static_cast<std::size_t>(written);
+    }
+    m_size = 0;
+}
+
+void output_writer::append(std::string_view s)
+{
+    while (!s.empty())
+    {
+        if (m_size == m_buffer.size())
+        {
+            flush();
+        }
+        const std::size_t n = std::min(s.size(), m_buffer.size() - m_size);
+        std::memcpy(m_buffer.data() + m_size, s.data(), n);
+        m_size += n;
+        s.remove_prefix(n);
+    }
+}
+
+void output_writer::append_escaped(std::string_view s)
+{
+    // Copy runs of characters that need no escaping in a single step.
+    while (!s.empty())
+    {
+        auto it = std::find_if(s.begin(), s.end(),
+                               [this](char c) { return needs_escape(m_format, c); });
+        const auto run_length = static_cast<std::size_t>(it - s.begin());
+        append(s.substr(0, run_length));
+        s.remove_prefix(run_length);
+        if (s.empty())
+        {
+            break;
+        }
+        if (m_format == output_format::JSONL && static_cast<unsigned char>(s.front()) >= 0x80)
+        {
+            // Well-formed UTF-8 is copied, and other bytes are escaped below.
+            if (const std::size_t length = utf8_sequence_length(s); length > 0)
+            {
+                append(s.substr(0, length));
+                s.remove_prefix(length);
+                continue;
+            }
+        }
+
+        const char c = s.front();
+        s.remove_prefix(1);
+        put('\\');
+        switch (c)
+        {
+        case '\t':
+            put('t');
+            break;
+        case '\n':
+            put('n');
+            break;
+        case '\r':
+            put('r');
+            break;
+        case '\b':
+            put('b');
+            break;
+        case '\f':
+            put('f');
+            break;
+        case '\\':
+        case '"':
+            put(c);
+            break;
+        default:
+        {
+            // Remaining control characters, and bytes that are not part of well-formed
+            // UTF-8, as the code points U+0001 to U+00FF (JSON only).
+            constexpr const char* hex_digits = "0123456789abcdef";
+            const auto uc = static_cast<unsigned char>(c);
+            append("u00");
+            put(hex_digits[uc >> 4]);
+            put(hex_digits[uc & 0xf]);
+            break;
+        }
+        }
+    }
+}
+
+void output_writer::append_json_string(std::string_view s)
+{
+    put('"');
+    append_escaped(s);
+    put('"');
+}
+
+} // end namespace 'co'
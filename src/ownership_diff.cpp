@@ -0,0 +1,301 @@
+#include <codeowners/ownership_diff.hpp>
+
+#include <codeowners/filesystem.hpp>
+#include <codeowners/instrumentation.hpp>
+#include <codeowners/recursive_filter_iterator.hpp>
+
+#include <algorithm>
+#include <ostream>
+#include <string_view>
+
+namespace co
+{
+
+namespace
+{
+    /// Maximum number of removed and added rules for which a minimal diff is searched for.
+    /// Beyond this, every rule between the common leading and trailing rules is reported.
+    /// The search keeps O(D^2) positions for D edits, about 2 MB at this limit.
+    constexpr std::size_t max_edit_distance = 500;
+
+    /**
+     * Find a shortest edit script between `old_rules[begin, end_old)` and
+     * `new_rules[begin, end_new)` with Myers' algorithm, which takes O((N + M) D) time
+     * for D edits, and add the removed and added rules to `diff`.  Return false, leaving
+     * `diff` unchanged, if more than `max_edit_distance` edits are needed.
+     */
+    bool append_shortest_edits(const std::vector<ownership_rule>& old_rules,
+                               const std::vector<ownership_rule>& new_rules, std::size_t begin,
+                               std::size_t end_old, std::size_t end_new, rule_diff& diff)
+    {
+        const auto n = static_cast<std::ptrdiff_t>(end_old - begin);
+        const auto m = static_cast<std::ptrdiff_t>(end_new - begin);
+        const auto max_d = std::min<std::ptrdiff_t>(n + m, max_edit_distance);
+        const auto equal = [&](std::ptrdiff_t x, std::ptrdiff_t y) {
+            return old_rules[begin + x] == new_rules[begin + y];
+        };
+
+        // `v[k + offset]` is the furthest x reached on diagonal k = x - y, and `trace[d]` is a
+        // copy of `v` for diagonals -d to d, the only ones that step d reads, before step d.
+        const std::ptrdiff_t offset = max_d + 1;
+        std::vector<std::ptrdiff_t> v(2 * offset + 1, 0);
+        std::vector<std::vector<std::ptrdiff_t>> trace;
+        for (std::ptrdiff_t d = 0; d <= max_d; ++d)
+        {
+            trace.emplace_back(v.begin() + offset - d, v.begin() + offset + d + 1);
+            for (std::ptrdiff_t k = -d; k <= d; k += 2)
+            {
+                std::ptrdiff_t x = k == -d || (k != d && v[k - 1 + offset] < v[k + 1 + offset])
+                    ? v[k + 1 + offset]
+                    : v[k - 1 + offset] + 1;
+                std::ptrdiff_t y = x - k;
+                while (x < n && y < m && equal(x, y))
+                {
+                    ++x;
+                    ++y;
+                }
+                v[k + offset] = x;
+                if (x < n || y < m)
+                {
+                    continue;
+                }
+
+                // Walk back from the end, recording the edit taken at each step.
+                std::vector<ruleset::rule_id> removed;
+                std::vector<ruleset::rule_id> added;
+                for (std::ptrdiff_t e = d; e > 0; --e)
+                {
+                    const auto& prev = trace[e];
+                    const std::ptrdiff_t ek = x - y;
+                    const std::ptrdiff_t prev_k
+                        = ek == -e || (ek != e && prev[ek - 1 + e] < prev[ek + 1 + e])
+                        ? ek + 1
+                        : ek - 1;
+                    const std::ptrdiff_t prev_x = prev[prev_k + e];
+                    const std::ptrdiff_t prev_y = prev_x - prev_k;
+                    if (prev_k == ek + 1)
+                    {
+                        added.push_back(begin + prev_y);
+                    }
+                    else
+                    {
+                        removed.push_back(begin + prev_x);
+                    }
+                    x = prev_x;
+                    y = prev_y;
+                }
+                diff.removed.insert(diff.removed.end(), removed.rbegin(), removed.rend());
+                diff.added.insert(diff.added.end(), added.rbegin(), added.rend());
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Return the rules of `rules`, without source information.
+    std::vector<ownership_rule> plain_rules(const ruleset& rules)
+    {
+        std::vector<ownership_rule> result;
+        result.reserve(rules.size());
+        for (ruleset::rule_id id = 0; id < rules.size(); ++id)
+        {
+            result.push_back(rules.rule(id).rule);
+        }
+        return result;
+    }
+
+    /// Return the owner names of a rule, sorted, or no names if there is no rule.
+    std::vector<std::string_view> sorted_owners(const ruleset& rules,
+                                                std::optional<ruleset::rule_id> id)
+    {
+        std::vector<std::string_view> names;
+        if (id)
+        {
+            const auto view = rules.owner_names(*id);
+            names.assign(view.begin(), view.end());
+            std::sort(names.begin(), names.end());
+            names.erase(std::unique(names.begin(), names.end()), names.end());
+        }
+        return names;
+    }
+
+    void write_owners(std::ostream& os, const ruleset& rules,
+                      std::optional<ruleset::rule_id> id)
+    {
+        const char* separator = "";
+        for (const std::string_view name : sorted_owners(rules, id))
+        {
+            os << separator << name;
+            separator = " ";
+        }
+    }
+} // end anonymous namespace
+
+rule_diff diff_rules(const ruleset& old_rules, const ruleset& new_rules)
+{
+    const std::vector<ownership_rule> old_plain = plain_rules(old_rules);
+    const std::vector<ownership_rule> new_plain = plain_rules(new_rules);
+
+    // Common leading and trailing rules are trimmed first, as edits are usually local.
+    std::size_t begin = 0;
+    while (begin < old_plain.size() && begin < new_plain.size()
+           && old_plain[begin] == new_plain[begin])
+    {
+        ++begin;
+    }
+    std::size_t end_old = old_plain.size();
+    std::size_t end_new = new_plain.size();
+    while (end_old > begin && end_new > begin && old_plain[end_old - 1] == new_plain[end_new - 1])
+    {
+        --end_old;
+        --end_new;
+    }
+
+    rule_diff diff;
+    if (!append_shortest_edits(old_plain, new_plain, begin, end_old, end_new, diff))
+    {
+        for (std::size_t id = begin; id < end_old; ++id)
+        {
+            diff.removed.push_back(id);
+        }
+        for (std::size_t id = begin; id < end_new; ++id)
+        {
+            diff.added.push_back(id);
+        }
+    }
+    return diff;
+}
+
+struct ownership_diff::impl
+{
+    /// The removed and added rules, which are the only rules whose matches can change.
+    ruleset changed;
+    ruleset::cursor changed_cursor;
+    ruleset::cursor old_cursor;
+    ruleset::cursor new_cursor;
+
+    impl(std::vector<annotated_rule>&& changed_rules, const ruleset& old_rules,
+         const ruleset& new_rules)
+        : changed{std::move(changed_rules)}
+        , changed_cursor{changed}
+        , old_cursor{old_rules}
+        , new_cursor{new_rules}
+    {
+    }
+};
+
+ownership_diff::ownership_diff(const ruleset& old_rules, const ruleset& new_rules)
+    : m_old{&old_rules}
+    , m_new{&new_rules}
+    , m_diff{diff_rules(old_rules, new_rules)}
+{
+    std::vector<annotated_rule> changed;
+    changed.reserve(m_diff.removed.size() + m_diff.added.size());
+    for (const ruleset::rule_id id : m_diff.removed)
+    {
+        changed.push_back(old_rules.rule(id));
+    }
+    for (const ruleset::rule_id id : m_diff.added)
+    {
+        changed.push_back(new_rules.rule(id));
+    }
+    m_impl = std::make_unique<impl>(std::move(changed), old_rules, new_rules);
+}
+
+ownership_diff::ownership_diff(ownership_diff&& other) noexcept = default;
+ownership_diff& ownership_diff::operator=(ownership_diff&& other) noexcept = default;
+ownership_diff::~ownership_diff() = default;
+
+bool ownership_diff::may_change_within(const fs::path& dir)
+{
+    const ruleset::subtree_match subtree = m_impl->changed_cursor.find_subtree(dir);
+    return !subtree.determined || subtree.rule.has_value();
+}
+
+std::optional<ownership_change> ownership_diff::compare(const fs::path& path)
+{
+    ++m_counts.paths;
+    if (!m_impl->changed_cursor.find(path))
+    {
+        return std::nullopt;
+    }
+    ++m_counts.candidates;
+    const auto old_rule = m_impl->old_cursor.find(path);
+    const auto new_rule = m_impl->new_cursor.find(path);
+    if (sorted_owners(*m_old, old_rule) == sorted_owners(*m_new, new_rule))
+    {
+        return std::nullopt;
+    }
+    return ownership_change{path.string(), old_rule, new_rule};
+}
+
+std::vector<ownership_change> find_ownership_changes(ownership_diff& diff,
+                                                     const fs::path& work_dir,
+                                                     const fs::path& start_path,
+                                                     const std::vector<fs::path>& to_skip)
+{
+    phase_timer timer{phase::TRAVERSAL};
+    std::vector<ownership_change> changes;
+    relative_path_builder relative{work_dir, start_path};
+    const auto add = [&](const fs::path& path) {
+        if (auto change = diff.compare(relative(path)))
+        {
+            changes.push_back(std::move(*change));
+        }
+    };
+    if (!fs::is_directory(start_path))
+    {
+        add(start_path);
+        return changes;
+    }
+    if (!diff.may_change_within(relative(start_path)))
+    {
+        return changes;
+    }
+
+    std::vector<fs::path> skipped;
+    for (const fs::path& p : to_skip)
+    {
+        boost::system::error_code ec;
+        fs::path canonical = fs::canonical(p, ec);
+        if (!ec)
+        {
+            skipped.push_back(std::move(canonical));
+        }
+    }
+    // Directories in which no removed or added rule can match are not descended into.
+    const auto descend = [&](const fs::path& dir) {
+        const bool is_skipped = std::any_of(skipped.begin(), skipped.end(), [&](const auto& p) {
+            boost::system::error_code ec;
+            return fs::equivalent(p, dir, ec);
+        });
+        instrumentation::add(counter::DIRECTORIES_VISITED);
+        return !is_skipped && diff.may_change_within(relative(dir));
+    };
+    for (recursive_filter_iterator it{start_path, descend}, end; it != end; ++it)
+    {
+        if (!fs::is_directory(it->status()))
+        {
+            instrumentation::add(counter::FILES_VISITED);
+            add(it->path());
+        }
+    }
+    return changes;
+}
+
+std::ostream& write_ownership_changes(std::ostream& os, const ownership_diff& diff,
+                                      const std::vector<ownership_change>& changes)
+{
+    os << "path\told_owners\tnew_owners\n";
+    for (const ownership_change& change : changes)
+    {
+        os << change.path << '\t';
+        write_owners(os, diff.old_rules(), change.old_rule);
+        os << '\t';
+        write_owners(os, diff.new_rules(), change.new_rule);
+        os << '\n';
+    }
+    return os;
+}
+
+} // end namespace 'co'
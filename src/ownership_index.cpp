@@ -0,0 +1,137 @@
+#include <codeowners/ownership_index.hpp>
+
+#include <codeowners/errors.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace co
+{
+
+namespace
+{
+    constexpr ruleset::rule_id no_rule = std::numeric_limits<ruleset::rule_id>::max();
+} // end anonymous namespace
+
+ownership_index::ownership_index(const ruleset& rules)
+    : m_ruleset{&rules}
+    , m_postings(rules.size())
+    , m_owner_rules(rules.owners().size())
+{
+    for (ruleset::rule_id id = 0; id < rules.size(); ++id)
+    {
+        for (const ruleset::owner_id oid : rules.owner_ids(id))
+        {
+            // A rule may name the same owner more than once.
+            auto& owner_rules = m_owner_rules[oid];
+            if (owner_rules.empty() || owner_rules.back() != id)
+            {
+                owner_rules.push_back(id);
+            }
+        }
+    }
+}
+
+ownership_index::path_id ownership_index::add(std::string_view path,
+                                              std::optional<ruleset::rule_id> id)
+{
+    if (m_path_ends.size() > std::numeric_limits<path_id>::max())
+    {
+        throw error{"Too many paths for an ownership index"};
+    }
+    const auto pid = static_cast<path_id>(m_path_ends.size());
+    m_paths.append(path);
+    m_path_ends.push_back(m_paths.size());
+    m_path_rules.push_back(id.value_or(no_rule));
+    (id ? m_postings.at(*id) : m_unmatched).push_back(pid);
+    return pid;
+}
+
+std::string_view ownership_index::path(path_id id) const
+{
+    const std::size_t end = m_path_ends.at(id);
+    const std::size_t begin = id == 0 ? 0 : m_path_ends[id - 1];
+    return std::string_view{m_paths}.substr(begin, end - begin);
+}
+
+std::optional<ruleset::rule_id> ownership_index::rule(path_id id) const
+{
+    const ruleset::rule_id rule = m_path_rules.at(id);
+    return rule == no_rule ? std::nullopt : std::optional<ruleset::rule_id>{rule};
+}
+
+std::vector<ownership_index::path_id>
+ownership_index::merge_postings(const std::vector<ruleset::rule_id>& rules) const
+{
+    std::size_t count = 0;
+    for (const ruleset::rule_id id : rules)
+    {
+        count += m_postings[id].size();
+    }
+    std::vector<path_id> result;
+    result.reserve(count);
+    for (const ruleset::rule_id id : rules)
+    {
+        result.insert(result.end(), m_postings[id].begin(), m_postings[id].end());
+    }
+    // Each path is in the posting list of one rule at most, so there are no duplicates.
+    if (rules.size() > 1)
+    {
+        std::sort(result.begin(), result.end());
+    }
+    return result;
+}
+
+std::vector<ownership_index::path_id> ownership_index::files_owned_by(ruleset::owner_id id) const
+{
+    return merge_postings(m_owner_rules.at(id));
+}
+
+std::vector<ownership_index::path_id> ownership_index::files_owned_by(std::string_view name) const
+{
+    const auto owners = m_ruleset->owners();
+    const auto it = std::find(owners.begin(), owners.end(), name);
+    if (it == owners.end())
+    {
+        return {};
+    }
+    return files_owned_by(static_cast<ruleset::owner_id>(it - owners.begin()));
+}
+
+std::vector<ownership_index::path_id>
+ownership_index::files_owned_by_any(const std::vector<std::string>& names) const
+{
+    const auto owners = m_ruleset->owners();
+    std::vector<ruleset::rule_id> rules;
+    for (const std::string& name : names)
+    {
+        const auto it = std::find(owners.begin(), owners.end(), name);
+        if (it != owners.end())
+        {
+            const auto& owner_rules = m_owner_rules[static_cast<std::size_t>(it - owners.begin())];
+            rules.insert(rules.end(), owner_rules.begin(), owner_rules.end());
+        }
+    }
+    // A rule may name several of the owners, and an owner may be named more than once.
+    std::sort(rules.begin(), rules.end());
+    rules.erase(std::unique(rules.begin(), rules.end()), rules.end());
+    return merge_postings(rules);
+}
+
+std::vector<ownership_index::path_id> ownership_index::unowned_files() const
+{
+    std::vector<ruleset::rule_id> rules;
+    for (ruleset::rule_id id = 0; id < m_ruleset->size(); ++id)
+    {
+        if (m_ruleset->owner_ids(id).empty())
+        {
+            rules.push_back(id);
+        }
+    }
+    std::vector<path_id> result = merge_postings(rules);
+    const auto middle = result.insert(result.end(), m_unmatched.begin(), m_unmatched.end());
+    std::inplace_merge(result.begin(), middle, result.end());
+    return result;
+}
+
+} // end namespace 'co'
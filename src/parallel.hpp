@@ -0,0 +1,77 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace co
+{
+
+/// Return the number of threads to use for `requested` threads, where zero requests one
+/// thread per hardware thread.
+inline std::size_t thread_count(std::size_t requested)
+{
+    return requested != 0 ? requested : std::max(1u, std::thread::hardware_concurrency());
+}
+
+/**
+ * Divide the range `[0, count)` into contiguous shards of at least `min_shard_size`
+ * elements (except when `count` is smaller), one per thread up to `threads` threads, and
+ * call `f(shard, begin, end)` for each shard.  The first shard is processed on the calling
+ * thread, and the others on new threads.  Returns the number of shards.
+ *
+ * If calls throw exceptions, the exception of the first shard (in order of the range) that
+ * threw is rethrown once all shards are finished, so that the outcome does not depend on
+ * the number of threads when `f` processes its elements in order.
+ */
+template <typename F>
+std::size_t for_each_shard(std::size_t count, std::size_t min_shard_size, std::size_t threads,
+                           F&& f)
+{
+    const std::size_t max_shards = count / std::max<std::size_t>(1, min_shard_size);
+    const std::size_t shards = std::max<std::size_t>(1, std::min(threads, max_shards));
+    std::vector<std::exception_ptr> errors(shards);
+    const auto run = [&](std::size_t shard) {
+        try
+        {
+            f(shard, count * shard / shards, count * (shard + 1) / shards);
+        }
+        catch (...)
+        {
+            errors[shard] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(shards - 1);
+    for (std::size_t shard = 1; shard < shards; ++shard)
+    {
+        try
+        {
+            workers.emplace_back(run, shard);
+        }
+        catch (const std::system_error&)
+        {
+            // No more threads can be started:  process the shard on this thread instead.
+            run(shard);
+        }
+    }
+    run(0);
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+    for (const std::exception_ptr& error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+    return shards;
+}
+
+} // end namespace 'co'
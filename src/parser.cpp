@@ -1,3 +1,4 @@
+#include <codeowners/instrumentation.hpp>
 #include <codeowners/parser.hpp>
 
 #include <boost/tokenizer.hpp>
@@ -47,6 +48,7 @@ std::optional<ownership_rule> parse_line(const std::string& line)
 
 std::vector<annotated_rule> parse(const fs::path& path, const std::string& source_name)
 {
+    phase_timer timer{phase::PARSE};
     // Use `source_name` if provided.
     std::string eff_source_name = source_name.empty() ? path.string() : source_name;
     std::ifstream ifs{path.c_str()};
@@ -55,6 +57,7 @@ std::vector<annotated_rule> parse(const fs::path& path, const std::string& sourc
 
 std::vector<annotated_rule> parse(std::istream& is, const std::string& source_name)
 {
+    phase_timer timer{phase::PARSE};
     auto lines = line_range(is);
     return parse(lines.begin(), lines.end(), source_name);
 }
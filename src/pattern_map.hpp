@@ -1,7 +1,15 @@
-#include "attribute_set.hpp"
+#include "compiled_pattern.hpp"
+#include "directory_cache.hpp"
+#include "match_cursor.hpp"
+#include "match_profile.hpp"
+
+#include <codeowners/instrumentation.hpp>
 
 #include <algorithm>
-#include <map>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <optional>
 #include <stdexcept>
 #include <utility>
 #include <vector>
@@ -9,30 +17,61 @@
 namespace co
 {
 
+/**
+ * The pattern_map class associates values with patterns, and finds the value of the last
+ * pattern that matches a path.
+ *
+ * Entries are stored in flat arrays, structure-of-arrays style:  patterns, values and
+ * compiled patterns in order of insertion (which is the order of precedence), and an index
+ * of positions sorted by pattern for lookup by key.  Iteration is in order of pattern.
+ *
+ * The arrays are shared between copies, so copying a map is cheap; they are copied when a
+ * shared map is modified.  Each copy has its own directory cache, so distinct copies may be
+ * used by different threads concurrently without contention; concurrent lookups on the same
+ * map serialize on the lock of its cache.
+ * As for standard containers, modification invalidates iterators.
+ */
 template <typename T> class pattern_map
 {
-    using mapping_type = std::map<pattern, T>;
-    using pattern_index_type = std::vector<typename mapping_type::iterator>;
+    template <bool Const> class basic_iterator;
 
 public:
     using key_type = pattern;
     using mapped_type = T;
     using value_type = std::pair<const key_type, mapped_type>;
-    using iterator = typename mapping_type::iterator;
-    using const_iterator = typename mapping_type::const_iterator;
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    class cursor;
+
+    using cache_statistics = directory_cache::statistics;
 
     /// Constructors
     pattern_map() = default;
-    pattern_map(const pattern_map& other) = delete;
-    pattern_map(pattern_map&& other);
+    pattern_map(const pattern_map& other)
+        : m_storage{other.m_storage}
+        , m_profile{other.m_profile}
+    {
+    }
+    pattern_map& operator=(const pattern_map& other)
+    {
+        pattern_map copy{other};
+        swap(copy);
+        return *this;
+    }
 
     template <typename InputIt> pattern_map(InputIt first, InputIt last);
 
+    /// Construct a map from entries whose patterns are already compiled:  `compiled[i]` is
+    /// the compiled form of the pattern of `items[i]`.  As for insertion, only the first
+    /// occurrence of a repeated pattern is retained.
+    pattern_map(const std::vector<value_type>& items, std::vector<compiled_pattern>&& compiled);
+
     pattern_map(std::initializer_list<value_type> ilist);
 
     /// Capacity/size
-    bool empty() const { return m_items.empty(); }
-    std::size_t size() const { return m_items.size(); }
+    bool empty() const { return m_storage->patterns.empty(); }
+    std::size_t size() const { return m_storage->patterns.size(); }
 
     /// Lookup by path.
     bool contains(const fs::path& p) const;
@@ -41,10 +80,39 @@ public:
     const T& at(const fs::path& p) const;
     const T* get(const fs::path& p) const;
 
+    /// If the same entry (or no entry) is found for every file within the relative
+    /// directory `dir`, regardless of the file's name, return an iterator to that entry
+    /// (or `end()`).  Otherwise, return an empty optional.
+    std::optional<const_iterator> find_within(const fs::path& dir) const;
+
+    /// Return the positions, in order of insertion, of the entries whose patterns match some
+    /// path that `pat` also matches.  No paths are enumerated; see
+    /// `compiled_pattern::overlaps`.
+    std::vector<std::size_t> find_overlapping(const compiled_pattern& pat) const;
+
+    /// Return the hit and miss counts of the per-directory cache used by `find`.
+    cache_statistics directory_cache_statistics() const { return m_directory_cache->stats(); }
+
+    /// Start recording pattern evaluations and lookup results, with zeroed counts, in a
+    /// profile indexed by position in order of insertion; or stop recording.  Cursors
+    /// created while profiling is enabled record into the same profile.  The profile is
+    /// shared between copies, and is reset when the map is modified.
+    void enable_profiling(bool on = true)
+    {
+        m_profile = on ? std::make_shared<match_profile>(size()) : nullptr;
+    }
+
+    /// Return the profile, or null if profiling is not enabled.
+    const match_profile* profile() const { return m_profile.get(); }
+
+    /// Return the pattern and value at position `pos`, in order of insertion.
+    const key_type& key_at(std::size_t pos) const { return m_storage->patterns.at(pos); }
+    const T& value_at(std::size_t pos) const { return m_storage->values.at(pos); }
+
     /// Lookup by pattern.
-    bool contains(const key_type& key) const { return m_items.find(key) != m_items.end(); }
-    iterator find(const key_type& key) { return m_items.find(key); }
-    const_iterator find(const key_type& key) const { return m_items.find(key); }
+    bool contains(const key_type& key) const { return find_key(key) != npos; }
+    iterator find(const key_type& key);
+    const_iterator find(const key_type& key) const;
 
     /// Return a reference to the mapped value if `pat` is already in the
     /// mapping; otherwise, associates a default-constructed value with `pat`
@@ -63,39 +131,222 @@ public:
     void swap(pattern_map& other);
 
     /// Iterators
-    iterator begin() { return m_items.begin(); }
-    const_iterator begin() const { return m_items.begin(); }
-    const_iterator cbegin() const { return m_items.cbegin(); }
-    iterator end() { return m_items.end(); }
-    const_iterator end() const { return m_items.end(); }
-    const_iterator cend() const { return m_items.cend(); }
+    iterator begin() { return make_iterator(0); }
+    const_iterator begin() const { return cbegin(); }
+    const_iterator cbegin() const { return const_iterator{this, 0}; }
+    iterator end() { return make_iterator(size()); }
+    const_iterator end() const { return cend(); }
+    const_iterator cend() const { return const_iterator{this, size()}; }
 
 private:
-    std::size_t update_pattern_index(iterator it);
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    struct storage
+    {
+        /// Entries in order of insertion, which is the order of precedence.
+        std::vector<pattern> patterns;
+        std::vector<T> values;
+        std::vector<compiled_pattern> compiled;
+        /// Positions in increasing order of pattern, and the inverse permutation.
+        std::vector<std::size_t> sorted;
+        std::vector<std::size_t> rank;
+        /// Positions of directory-determined patterns, and of all other patterns.
+        std::vector<std::size_t> directory_positions;
+        std::vector<std::size_t> name_positions;
+    };
+
+    /// Return the storage for modification, copying it first if it is shared.
+    storage& mutable_storage();
+
+    /// Return the sorted index of `key`, or `npos`.
+    std::size_t find_key(const key_type& key) const;
+
+    /// Append entries for patterns that are not yet in the map, then update the indexes.
+    template <typename InputIt> void append_new(InputIt first, InputIt last);
+    void remove_new_duplicates(std::size_t first_new);
+    void update_indexes(std::size_t first_new);
+
+    iterator make_iterator(std::size_t index)
+    {
+        mutable_storage();
+        return iterator{this, index};
+    }
+    const_iterator to_iterator(std::size_t pos) const
+    {
+        return pos == npos ? cend() : const_iterator{this, m_storage->rank[pos]};
+    }
+
+    /// Return the position of the last directory-determined pattern that matches the files
+    /// within relative directory `dir`, or `npos`.
+    std::size_t find_directory_position(std::string_view dir) const;
 
     /* Class invariants are:
      *
-     *   - Patterns (keys) in `m_items` are unique.
+     *   - Patterns in `patterns` are unique.  `values` and `compiled` have the same size,
+     *     and hold the value and compiled form of the pattern at the same position.
      *
-     *   - There is a one-to-one correspondence between pairs in `m_items`
-     *     and valid iterators in `m_pattern_index` pointing to them.
-     *     (This implies the containers are the same size.)
+     *   - `sorted` is a permutation of positions, in increasing order of pattern, and
+     *     `rank` is its inverse.
      *
-     *   - There is exactly one write into `m_attr_set` for each pattern,
-     *     even if values associated with the pattern are updated.
+     *   - Each position is in exactly one of `directory_positions` (for
+     *     directory-determined patterns) or `name_positions` (for all other patterns),
+     *     which are in increasing order.
+     *
+     *   - `m_directory_cache` only holds results for the current set of patterns.
      *
      */
-    void assert_invariant()
+    void assert_invariant() const
+    {
+        const storage& s = *m_storage;
+        assert(s.values.size() == s.patterns.size());
+        assert(s.compiled.size() == s.patterns.size());
+        assert(s.sorted.size() == s.patterns.size());
+        assert(s.rank.size() == s.patterns.size());
+        assert(s.directory_positions.size() + s.name_positions.size() == s.patterns.size());
+        assert(std::is_sorted(s.sorted.begin(), s.sorted.end(), [&](std::size_t a, std::size_t b) {
+            return s.patterns[a] < s.patterns[b];
+        }));
+        (void)s;
+    }
+
+private:
+    std::shared_ptr<storage> m_storage = std::make_shared<storage>();
+    std::unique_ptr<directory_cache> m_directory_cache = std::make_unique<directory_cache>();
+    std::shared_ptr<match_profile> m_profile;
+};
+
+/**
+ * Iterator over the entries of a pattern_map, in order of pattern.  Dereferencing yields a
+ * pair of references to the pattern and its value.
+ */
+template <typename T> template <bool Const> class pattern_map<T>::basic_iterator
+{
+    using map_pointer = std::conditional_t<Const, const pattern_map*, pattern_map*>;
+    using value_reference = std::conditional_t<Const, const T&, T&>;
+
+public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = pattern_map::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::pair<const pattern&, value_reference>;
+
+    struct pointer
+    {
+        reference ref;
+        const reference* operator->() const { return &ref; }
+    };
+
+    basic_iterator() = default;
+
+    /// Conversion from iterator to const_iterator.
+    template <bool C = Const, typename = std::enable_if_t<C>>
+    basic_iterator(const basic_iterator<false>& other)
+        : m_map{other.m_map}
+        , m_index{other.m_index}
+    {
+    }
+
+    reference operator*() const
+    {
+        const std::size_t pos = m_map->m_storage->sorted[m_index];
+        return reference{m_map->m_storage->patterns[pos], m_map->m_storage->values[pos]};
+    }
+    pointer operator->() const { return pointer{**this}; }
+
+    basic_iterator& operator++()
+    {
+        ++m_index;
+        return *this;
+    }
+    basic_iterator operator++(int)
+    {
+        auto result = *this;
+        ++m_index;
+        return result;
+    }
+    basic_iterator& operator--()
+    {
+        --m_index;
+        return *this;
+    }
+    basic_iterator operator--(int)
     {
-        assert(m_items.size() == m_pattern_index.size());
-        assert(std::all_of(m_pattern_index.begin(), m_pattern_index.end(),
-                           [&](const auto it) { return m_items.find(it->first) == it; }));
+        auto result = *this;
+        --m_index;
+        return result;
+    }
+
+    friend bool operator==(const basic_iterator& lhs, const basic_iterator& rhs)
+    {
+        return lhs.m_map == rhs.m_map && lhs.m_index == rhs.m_index;
+    }
+    friend bool operator!=(const basic_iterator& lhs, const basic_iterator& rhs)
+    {
+        return !(lhs == rhs);
     }
 
 private:
-    mapping_type m_items;
-    pattern_index_type m_pattern_index;
-    attribute_set m_attr_set;
+    friend class pattern_map;
+    template <bool> friend class basic_iterator;
+
+    basic_iterator(map_pointer map, std::size_t index)
+        : m_map{map}
+        , m_index{index}
+    {
+    }
+
+    map_pointer m_map = nullptr;
+    /// Index in the order of patterns.
+    std::size_t m_index = 0;
+};
+
+/**
+ * Cursor for looking up a series of paths, which retains matching state for the parent
+ * directories of the previous path; see `match_cursor`.  Lookups of sorted paths are much
+ * faster than with `pattern_map::find`.  The cursor is invalidated by any modification of
+ * the map.
+ */
+template <typename T> class pattern_map<T>::cursor
+{
+public:
+    /// If `all_matches` is set, the cursor also supports `find_all`.
+    explicit cursor(const pattern_map& map, bool all_matches = false)
+        : m_map{&map}
+        , m_cursor{map.m_storage->compiled, map.m_profile.get(), all_matches}
+    {
+    }
+
+    const_iterator find(const fs::path& p) { return to_iterator(m_cursor.find(p.native())); }
+
+    /// Replace the contents of `positions` with the positions, in order of insertion, of
+    /// every pattern that matches `p` (see `value_at`), and return the entry of the last of
+    /// them, which is the entry found by `find`.  The cursor must have been created with
+    /// `all_matches`.
+    const_iterator find_all(const fs::path& p, std::vector<std::size_t>& positions)
+    {
+        return to_iterator(m_cursor.find_all(p.native(), positions));
+    }
+
+    /// See `pattern_map::find_within`.
+    std::optional<const_iterator> find_within(const fs::path& dir)
+    {
+        if (auto pos = m_cursor.find_within(dir.native()))
+        {
+            return to_iterator(*pos);
+        }
+        return std::nullopt;
+    }
+
+private:
+    const_iterator to_iterator(std::size_t pos) const
+    {
+        static_assert(match_cursor::npos == pattern_map::npos);
+        return m_map->to_iterator(pos);
+    }
+
+private:
+    const pattern_map* m_map;
+    match_cursor m_cursor;
 };
 
 template <typename T>
@@ -106,6 +357,29 @@ pattern_map<T>::pattern_map(InputIt first, InputIt last)
     insert(first, last);
 }
 
+template <typename T>
+pattern_map<T>::pattern_map(const std::vector<value_type>& items,
+                            std::vector<compiled_pattern>&& compiled)
+    : pattern_map{}
+{
+    if (compiled.size() != items.size())
+    {
+        throw std::invalid_argument{"Each pattern must have one compiled pattern"};
+    }
+    storage& s = *m_storage;
+    s.patterns.reserve(items.size());
+    s.values.reserve(items.size());
+    for (const value_type& item : items)
+    {
+        s.patterns.push_back(item.first);
+        s.values.push_back(item.second);
+    }
+    s.compiled = std::move(compiled);
+    remove_new_duplicates(0);
+    update_indexes(0);
+    assert_invariant();
+}
+
 template <typename T>
 pattern_map<T>::pattern_map(std::initializer_list<value_type> ilist)
     : pattern_map{}
@@ -116,25 +390,109 @@ pattern_map<T>::pattern_map(std::initializer_list<value_type> ilist)
 template <typename T> bool pattern_map<T>::contains(const fs::path& p) const
 {
     auto it = find(p);
-    return it != m_items.end();
+    return it != end();
 }
 
 template <typename T> auto pattern_map<T>::find(const fs::path& p) const -> const_iterator
 {
-    auto maybe_index_str = m_attr_set.get_optional(p);
-    if (maybe_index_str)
+    const storage& s = *m_storage;
+    const std::string_view path = p.native();
+    const auto slash = path.rfind('/');
+    const std::string_view dir = slash == std::string_view::npos ? "" : path.substr(0, slash);
+
+    // Directory-determined patterns give the same result for every file in a directory,
+    // so their result is cached per directory; only the other patterns depend on the
+    // file's name.  The last matching pattern takes precedence.
+    const std::size_t dir_pos = s.directory_positions.empty()
+        ? npos
+        : m_directory_cache->get(dir, [this](std::string_view d) {
+              return find_directory_position(d);
+          });
+    auto it = s.name_positions.rbegin();
+    for (; it != s.name_positions.rend(); ++it)
+    {
+        if (dir_pos != npos && *it < dir_pos)
+        {
+            break;
+        }
+        const std::size_t pos = *it;
+        if (profiled_evaluation(m_profile.get(), pos,
+                                [&] { return s.compiled[pos].matches(path); }))
+        {
+            instrumentation::add(counter::RULES_EVALUATED, it - s.name_positions.rbegin() + 1);
+            profiled_result(m_profile.get(), pos);
+            return to_iterator(pos);
+        }
+    }
+    instrumentation::add(counter::RULES_EVALUATED, it - s.name_positions.rbegin());
+    profiled_result(m_profile.get(), dir_pos);
+    return to_iterator(dir_pos);
+}
+
+template <typename T>
+std::size_t pattern_map<T>::find_directory_position(std::string_view dir) const
+{
+    const storage& s = *m_storage;
+    for (auto it = s.directory_positions.rbegin(); it != s.directory_positions.rend(); ++it)
     {
-        const std::size_t idx = std::stoi(*maybe_index_str);
-        assert(idx < m_pattern_index.size());
-        return m_pattern_index.at(idx);
+        const std::size_t pos = *it;
+        if (profiled_evaluation(m_profile.get(), pos,
+                                [&] { return s.compiled[pos].matches_all_within(dir); }))
+        {
+            instrumentation::add(counter::RULES_EVALUATED,
+                                 it - s.directory_positions.rbegin() + 1);
+            return *it;
+        }
     }
-    return m_items.end();
+    instrumentation::add(counter::RULES_EVALUATED, s.directory_positions.size());
+    return npos;
+}
+
+template <typename T>
+auto pattern_map<T>::find_within(const fs::path& dir) const -> std::optional<const_iterator>
+{
+    const storage& s = *m_storage;
+    const std::string_view dir_str = dir.native();
+    for (std::size_t idx = s.compiled.size(); idx-- > 0;)
+    {
+        const compiled_pattern& pat = s.compiled[idx];
+        if (!profiled_evaluation(m_profile.get(), idx,
+                                 [&] { return pat.may_match_within(dir_str); }))
+        {
+            continue;
+        }
+        instrumentation::add(counter::RULES_EVALUATED, s.compiled.size() - idx);
+        if (pat.matches_all_within(dir_str))
+        {
+            profiled_result(m_profile.get(), idx);
+            return to_iterator(idx);
+        }
+        // This pattern matches some, but not necessarily all, paths in the directory.
+        return std::nullopt;
+    }
+    instrumentation::add(counter::RULES_EVALUATED, s.compiled.size());
+    return end();
+}
+
+template <typename T>
+std::vector<std::size_t> pattern_map<T>::find_overlapping(const compiled_pattern& pat) const
+{
+    const storage& s = *m_storage;
+    std::vector<std::size_t> result;
+    for (std::size_t pos = 0; pos < s.compiled.size(); ++pos)
+    {
+        if (s.compiled[pos].overlaps(pat))
+        {
+            result.push_back(pos);
+        }
+    }
+    return result;
 }
 
 template <typename T> const T& pattern_map<T>::at(const fs::path& p) const
 {
     auto it = find(p);
-    if (it == m_items.end())
+    if (it == end())
     {
         throw std::out_of_range{p.c_str()};
     }
@@ -144,13 +502,37 @@ template <typename T> const T& pattern_map<T>::at(const fs::path& p) const
 template <typename T> const T* pattern_map<T>::get(const fs::path& p) const
 {
     auto it = find(p);
-    if (it == m_items.end())
+    if (it == end())
     {
         return nullptr;
     }
     return std::addressof(it->second);
 }
 
+template <typename T> std::size_t pattern_map<T>::find_key(const key_type& key) const
+{
+    const storage& s = *m_storage;
+    const auto is_less = [&](std::size_t pos, const key_type& k) { return s.patterns[pos] < k; };
+    auto it = std::lower_bound(s.sorted.begin(), s.sorted.end(), key, is_less);
+    if (it == s.sorted.end() || s.patterns[*it] != key)
+    {
+        return npos;
+    }
+    return static_cast<std::size_t>(it - s.sorted.begin());
+}
+
+template <typename T> auto pattern_map<T>::find(const key_type& key) -> iterator
+{
+    const std::size_t index = find_key(key);
+    return make_iterator(index == npos ? size() : index);
+}
+
+template <typename T> auto pattern_map<T>::find(const key_type& key) const -> const_iterator
+{
+    const std::size_t index = find_key(key);
+    return const_iterator{this, index == npos ? size() : index};
+}
+
 template <typename T> T& pattern_map<T>::operator[](const pattern& pat)
 {
     // TODO: avoid default construction if not needed.
@@ -162,37 +544,34 @@ template <typename T> T& pattern_map<T>::operator[](const pattern& pat)
 template <typename T>
 auto pattern_map<T>::insert(const value_type& pair) -> std::pair<iterator, bool>
 {
-    auto [it, inserted] = m_items.insert(pair);
+    const bool inserted = !contains(pair.first);
     if (inserted)
     {
-        update_pattern_index(it);
+        append_new(&pair, &pair + 1);
     }
     assert_invariant();
-    return std::make_pair(it, inserted);
+    return std::make_pair(make_iterator(find_key(pair.first)), inserted);
 }
 
 template <typename T>
 auto pattern_map<T>::insert_or_assign(const key_type& key, const mapped_type& m)
     -> std::pair<iterator, bool>
 {
-    auto [it, inserted] = m_items.insert_or_assign(key, m);
-    if (inserted)
+    const std::size_t index = find_key(key);
+    if (index != npos)
     {
-        update_pattern_index(it);
+        storage& s = mutable_storage();
+        s.values[s.sorted[index]] = m;
+        return std::make_pair(iterator{this, index}, false);
     }
-    assert_invariant();
-    return std::make_pair(it, inserted);
+    return insert(value_type{key, m});
 }
 
 template <typename T>
 template <typename InputIt>
 void pattern_map<T>::insert(InputIt first, InputIt last)
 {
-    while (first != last)
-    {
-        insert(*first);
-        first++;
-    }
+    append_new(first, last);
     assert_invariant();
 }
 
@@ -211,21 +590,140 @@ template <typename T> void pattern_map<T>::clear()
 template <typename T> void pattern_map<T>::swap(pattern_map<T>& other)
 {
     using std::swap;
-    swap(m_pattern_index, other.m_pattern_index);
-    swap(m_attr_set, other.m_attr_set);
-    swap(m_items, other.m_items);
+    swap(m_storage, other.m_storage);
+    swap(m_directory_cache, other.m_directory_cache);
+    swap(m_profile, other.m_profile);
 }
 
-template <typename T> std::size_t pattern_map<T>::update_pattern_index(iterator it)
+template <typename T> auto pattern_map<T>::mutable_storage() -> storage&
 {
-    assert(m_items.size() == m_pattern_index.size() + 1);
-    m_pattern_index.push_back(it);
-    auto index = m_pattern_index.size() - 1;
-    m_attr_set.add_pattern(it->first, std::to_string(index));
-    assert_invariant();
-    return index;
+    if (m_storage.use_count() > 1)
+    {
+        m_storage = std::make_shared<storage>(*m_storage);
+    }
+    return *m_storage;
+}
+
+template <typename T>
+template <typename InputIt>
+void pattern_map<T>::append_new(InputIt first, InputIt last)
+{
+    // The key index is updated once, after all new entries are appended, so that inserting
+    // many entries takes O(n log n) time.
+    storage& s = mutable_storage();
+    const std::size_t first_new = s.patterns.size();
+    try
+    {
+        for (; first != last; ++first)
+        {
+            const value_type& item = *first;
+            if (find_key(item.first) != npos)
+            {
+                continue;
+            }
+            // Compile first, so that a pattern that cannot be compiled leaves no entry.
+            s.compiled.emplace_back(item.first);
+            s.patterns.push_back(item.first);
+            s.values.push_back(item.second);
+        }
+    }
+    catch (...)
+    {
+        // Restore the invariant for the entries appended so far before propagating.
+        const std::size_t appended
+            = std::min({s.patterns.size(), s.values.size(), s.compiled.size()});
+        s.patterns.erase(s.patterns.begin() + appended, s.patterns.end());
+        s.values.erase(s.values.begin() + appended, s.values.end());
+        s.compiled.erase(s.compiled.begin() + appended, s.compiled.end());
+        remove_new_duplicates(first_new);
+        update_indexes(first_new);
+        throw;
+    }
+    remove_new_duplicates(first_new);
+    update_indexes(first_new);
+}
+
+template <typename T> void pattern_map<T>::remove_new_duplicates(std::size_t first_new)
+{
+    storage& s = *m_storage;
+    std::vector<std::size_t> order(s.patterns.size() - first_new);
+    std::iota(order.begin(), order.end(), first_new);
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return s.patterns[a] < s.patterns[b];
+    });
+
+    // The first occurrence of a repeated pattern is retained.
+    std::vector<bool> repeated(order.size());
+    bool any_repeated = false;
+    for (std::size_t i = 1; i < order.size(); ++i)
+    {
+        if (s.patterns[order[i]] == s.patterns[order[i - 1]])
+        {
+            repeated[order[i] - first_new] = true;
+            any_repeated = true;
+        }
+    }
+    if (!any_repeated)
+    {
+        return;
+    }
+
+    std::size_t kept = first_new;
+    for (std::size_t pos = first_new; pos < s.patterns.size(); ++pos)
+    {
+        if (repeated[pos - first_new])
+        {
+            continue;
+        }
+        if (kept != pos)
+        {
+            s.patterns[kept] = std::move(s.patterns[pos]);
+            s.values[kept] = std::move(s.values[pos]);
+            s.compiled[kept] = std::move(s.compiled[pos]);
+        }
+        ++kept;
+    }
+    s.patterns.erase(s.patterns.begin() + kept, s.patterns.end());
+    s.values.erase(s.values.begin() + kept, s.values.end());
+    s.compiled.erase(s.compiled.begin() + kept, s.compiled.end());
+}
+
+template <typename T> void pattern_map<T>::update_indexes(std::size_t first_new)
+{
+    storage& s = *m_storage;
+    if (first_new == s.patterns.size())
+    {
+        return;
+    }
+
+    const std::size_t old_size = s.sorted.size();
+    for (std::size_t pos = first_new; pos < s.patterns.size(); ++pos)
+    {
+        s.sorted.push_back(pos);
+        (s.compiled[pos].is_directory_determined() ? s.directory_positions : s.name_positions)
+            .push_back(pos);
+    }
+    const auto by_pattern = [&](std::size_t a, std::size_t b) {
+        return s.patterns[a] < s.patterns[b];
+    };
+    std::sort(s.sorted.begin() + old_size, s.sorted.end(), by_pattern);
+    std::inplace_merge(s.sorted.begin(), s.sorted.begin() + old_size, s.sorted.end(), by_pattern);
+
+    s.rank.resize(s.sorted.size());
+    for (std::size_t index = 0; index < s.sorted.size(); ++index)
+    {
+        s.rank[s.sorted[index]] = index;
+    }
+
+    if (m_profile)
+    {
+        m_profile = std::make_shared<match_profile>(s.patterns.size());
+    }
+
+    // Cached results are for the previous set of patterns.
+    m_directory_cache->clear();
 }
 
 template <typename T> inline void swap(pattern_map<T>& a, pattern_map<T>& b) { a.swap(b); }
 
-} /* end namespace 'co' */
\ No newline at end of file
+} /* end namespace 'co' */
@@ -1,10 +1,13 @@
 #include <codeowners/errors.hpp>
+#include <codeowners/instrumentation.hpp>
 #include <codeowners/repository.hpp>
 
 #include "git_resources.hpp"
 
+#include <git2/blob.h>
 #include <git2/errors.h> // libgit2 error codes
 #include <git2/repository.h>
+#include <git2/revparse.h>
 #include <git2/submodule.h>
 
 #include <range/v3/range/conversion.hpp>
@@ -61,6 +64,7 @@ std::optional<repository> repository::try_discover(const fs::path& start_point)
 std::optional<repository> repository::try_discover(const fs::path& start_point,
                                                    discovery_strategy strategy)
 {
+    phase_timer timer{phase::DISCOVERY};
     if (!fs::exists(start_point))
     {
         using namespace std::string_literals;
@@ -125,6 +129,7 @@ bool repository::is_empty() const
 
 std::vector<fs::path> repository::submodule_paths() const
 {
+    phase_timer timer{phase::SUBMODULES};
     std::vector<fs::path> paths;
 
     const auto callback = [](git_submodule* sm, const char* /*name*/, void* payload) -> int {
@@ -136,12 +141,30 @@ std::vector<fs::path> repository::submodule_paths() const
     return paths;
 }
 
+std::string repository::read_blob(const std::string& revision) const
+{
+    ::git_object* resolved = nullptr;
+    if (::git_revparse_single(&resolved, const_cast<::git_repository*>(raw()), revision.c_str()))
+    {
+        throw error{"Revision not found: " + revision};
+    }
+    const owning_ptr<::git_object> object{resolved, resource_traits<::git_object>::deleter};
+    if (::git_object_type(object.get()) != GIT_OBJECT_BLOB)
+    {
+        throw error{"Revision does not name a file: " + revision};
+    }
+    const auto* blob = reinterpret_cast<const ::git_blob*>(object.get());
+    return std::string(static_cast<const char*>(::git_blob_rawcontent(blob)),
+                       static_cast<std::size_t>(::git_blob_rawsize(blob)));
+}
+
 ::git_repository* repository::raw() { return m_ptr.get(); }
 
 const ::git_repository* repository::raw() const { return m_ptr.get(); }
 
 std::optional<fs::path> codeowners_path(const fs::path& work_directory)
 {
+    phase_timer timer{phase::DISCOVERY};
     for (const auto& rel_path : codeowner_relative_paths)
     {
         if (fs::path p = work_directory / rel_path; fs::exists(p))
@@ -154,6 +177,7 @@ std::optional<fs::path> codeowners_path(const fs::path& work_directory)
 
 std::vector<fs::path> nonwork_directories(const repository& repo)
 {
+    phase_timer timer{phase::SUBMODULES};
     fs::path work_dir = repo.work_directory();
     auto subm_paths = repo.submodule_paths();
     auto full_subm_paths = subm_paths
@@ -1,59 +1,543 @@
+#include "arena.hpp"
+#include "parallel.hpp"
 #include "pattern_map.hpp"
+#include <codeowners/errors.hpp>
+#include <codeowners/instrumentation.hpp>
 #include <codeowners/ruleset.hpp>
-#include <range/v3/view/move.hpp>
-#include <range/v3/view/transform.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <iomanip>
+#include <iterator>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 
 namespace co
 {
 
+struct ruleset::rule_record
+{
+    std::string_view file_pattern;
+    std::string_view source_name;
+    std::int32_t line;
+    std::size_t owner_count;
+    const owner_id* owner_ids;
+    const std::string_view* owner_names;
+};
+
 namespace
 {
 
-    using map_value_type = typename pattern_map<annotated_rule>::value_type;
+    /// Minimum number of rules compiled by each thread.  Smaller rulesets are compiled on
+    /// the calling thread.
+    constexpr std::size_t min_rules_per_shard = 4096;
 
-    std::unique_ptr<pattern_map<annotated_rule>>
-    make_rule_map(const std::vector<annotated_rule>& arules)
+    /// Compile the patterns of all rules, on up to `threads` threads.  A pattern that
+    /// cannot be compiled is replaced by one matching nothing, and its rule is appended to
+    /// `skipped`.  Rules are divided into contiguous shards, whose results are concatenated
+    /// in order, so the result is the same as for serial compilation.
+    std::vector<compiled_pattern> compile_patterns(const std::vector<annotated_rule>& arules,
+                                                   std::size_t threads,
+                                                   std::vector<ruleset::skipped_rule>& skipped)
     {
-        auto make_pattern_pair = [](const annotated_rule& ar) -> map_value_type {
-            return map_value_type{ar.rule.file_pattern, ar};
-        };
+        phase_timer timer{phase::COMPILE};
+        std::vector<std::vector<compiled_pattern>> shards(thread_count(threads));
+        std::vector<std::vector<ruleset::skipped_rule>> shard_skipped(shards.size());
+        const std::size_t used = for_each_shard(
+            arules.size(), min_rules_per_shard, shards.size(),
+            [&](std::size_t shard, std::size_t begin, std::size_t end) {
+                trace_span span{"compile shard", "compile"};
+                span.add_arg("rules", static_cast<std::int64_t>(end - begin));
+                std::vector<compiled_pattern>& compiled = shards[shard];
+                compiled.reserve(end - begin);
+                for (std::size_t id = begin; id < end; ++id)
+                {
+                    try
+                    {
+                        compiled.emplace_back(arules[id].rule.file_pattern);
+                    }
+                    catch (const error& err)
+                    {
+                        compiled.push_back(compiled_pattern::matching_nothing());
+                        shard_skipped[shard].push_back(ruleset::skipped_rule{id, err.what()});
+                    }
+                }
+            });
+        for (std::size_t shard = 0; shard < used; ++shard)
+        {
+            std::move(shard_skipped[shard].begin(), shard_skipped[shard].end(),
+                      std::back_inserter(skipped));
+        }
+        if (used == 1)
+        {
+            return std::move(shards.front());
+        }
+        std::vector<compiled_pattern> result;
+        result.reserve(arules.size());
+        for (std::vector<compiled_pattern>& compiled : shards)
+        {
+            std::move(compiled.begin(), compiled.end(), std::back_inserter(result));
+        }
+        return result;
+    }
+
+    /// Find the rules that are shadowed by a later rule.  Rules are visited in reverse
+    /// order, and candidate shadowing rules are looked up by pattern text, and by the
+    /// directories containing the files that a rule can match, rather than comparing every
+    /// pair of rules.
+    std::vector<ruleset::shadowed_rule>
+    find_shadowed_rules(const std::vector<annotated_rule>& arules,
+                        const std::vector<compiled_pattern>& compiled)
+    {
+        phase_timer timer{phase::COMPILE};
+        using rule_id = ruleset::rule_id;
+        constexpr rule_id none = static_cast<rule_id>(-1);
+
+        // The nearest later rule with each pattern; the nearest later rule matching every
+        // path; and the nearest later rule matching every file within each directory named
+        // by a pattern's literal prefix.
+        std::unordered_map<std::string_view, rule_id> by_pattern;
+        rule_id universal = none;
+        std::unordered_map<std::string, rule_id> by_directory;
 
-        auto rule_pairs = arules | ranges::views::transform(make_pattern_pair);
-        return std::make_unique<pattern_map<annotated_rule>>(rule_pairs.begin(), rule_pairs.end());
+        std::vector<ruleset::shadowed_rule> result;
+        for (rule_id id = arules.size(); id-- > 0;)
+        {
+            const std::string_view text = arules[id].rule.file_pattern.value();
+            const compiled_pattern& pat = compiled[id];
+            const std::string prefix = pat.literal_prefix();
+
+            rule_id shadowed_by = universal;
+            if (const auto it = by_pattern.find(text); it != by_pattern.end())
+            {
+                shadowed_by = std::min(shadowed_by, it->second);
+            }
+            std::string_view dir = prefix;
+            while (!dir.empty())
+            {
+                const auto it = by_directory.find(std::string{dir});
+                if (it != by_directory.end() && it->second < shadowed_by
+                    && compiled[it->second].subsumes(pat))
+                {
+                    shadowed_by = it->second;
+                }
+                const auto slash = dir.rfind('/');
+                dir = dir.substr(0, slash == std::string_view::npos ? 0 : slash);
+            }
+            if (shadowed_by != none)
+            {
+                result.push_back(ruleset::shadowed_rule{id, shadowed_by});
+            }
+
+            by_pattern[text] = id;
+            if (pat.matches_all_within(""))
+            {
+                universal = id;
+            }
+            else if (!prefix.empty() && pat.matches_all_within(prefix))
+            {
+                by_directory[prefix] = id;
+            }
+        }
+        std::reverse(result.begin(), result.end());
+        return result;
     }
 
-    std::unique_ptr<pattern_map<annotated_rule>> make_rule_map(std::vector<annotated_rule>&& arules)
+    /// Return the map of the rules that are not shadowed, moving their compiled patterns out
+    /// of `compiled`.  Those of shadowed rules are left in place.
+    std::unique_ptr<pattern_map<ruleset::rule_id>>
+    make_rule_map(const std::vector<annotated_rule>& arules,
+                  const std::vector<ruleset::shadowed_rule>& shadowed,
+                  std::vector<compiled_pattern>& compiled)
     {
-        auto make_pattern_pair = [](annotated_rule&& ar) -> map_value_type {
-            // Need to copy pattern before moving from the annotated rule.
-            pattern pat{ar.rule.file_pattern};
-            return map_value_type{std::move(pat), std::move(ar)};
-        };
+        phase_timer timer{phase::COMPILE};
+        // Insert all patterns at once, so that the map's key index is built only once.  A
+        // repeated pattern is shadowed by its last occurrence, so patterns are distinct.
+        std::vector<std::pair<const pattern, ruleset::rule_id>> items;
+        items.reserve(arules.size() - shadowed.size());
+        std::vector<compiled_pattern> kept;
+        kept.reserve(arules.size() - shadowed.size());
+        auto next_shadowed = shadowed.begin();
+        for (ruleset::rule_id id = 0; id < arules.size(); ++id)
+        {
+            if (next_shadowed != shadowed.end() && next_shadowed->id == id)
+            {
+                ++next_shadowed;
+                continue;
+            }
+            items.emplace_back(arules[id].rule.file_pattern, id);
+            kept.push_back(std::move(compiled[id]));
+        }
+        return std::make_unique<pattern_map<ruleset::rule_id>>(items, std::move(kept));
+    }
 
-        auto rule_pairs = ranges::views::move(arules) | ranges::views::transform(make_pattern_pair);
-        return std::make_unique<pattern_map<annotated_rule>>(rule_pairs.begin(), rule_pairs.end());
+    /// Return whether the source name of rule `id` is the same as that of the previous
+    /// rule, in which case its storage is shared.
+    bool same_source_as_previous(const std::vector<annotated_rule>& arules, std::size_t id)
+    {
+        return id > 0 && arules[id].source.filename == arules[id - 1].source.filename;
     }
 
+    /// Patterns evaluated instead of those of shadowed rules, by cursors that do not find
+    /// every matching rule.
+    const std::vector<compiled_pattern> no_patterns;
+
 } // end anonymous namespace
 
-ruleset::ruleset(const std::vector<annotated_rule>& rules)
-    : m_rule_map{make_rule_map(rules)}
+ruleset::ruleset(const std::vector<annotated_rule>& rules, std::size_t compile_threads)
+    : m_arena{}
+    , m_records{nullptr}
+    , m_size{rules.size()}
+    , m_owner_names{nullptr}
+    , m_owner_count{0}
+    , m_shadowed{}
+    , m_skipped{}
+    , m_rule_map{}
+    , m_shadowed_patterns{}
 {
+    std::vector<compiled_pattern> compiled = compile_patterns(rules, compile_threads, m_skipped);
+    m_shadowed = find_shadowed_rules(rules, compiled);
+    m_rule_map = make_rule_map(rules, m_shadowed, compiled);
+    // Shadowed rules are only evaluated by cursors that find every matching rule.
+    m_shadowed_patterns = std::make_unique<std::vector<compiled_pattern>>();
+    m_shadowed_patterns->reserve(m_shadowed.size());
+    for (const shadowed_rule& s : m_shadowed)
+    {
+        m_shadowed_patterns->push_back(std::move(compiled[s.id]));
+    }
+
+    phase_timer timer{phase::COMPILE};
+    // Distinct owners, and the storage needed for the rules.  The patterns of rules that
+    // are not shadowed are kept by the rule map, and the records refer to them there.
+    std::unordered_map<std::string_view, owner_id> owner_index;
+    std::vector<std::string_view> owner_names;
+    std::size_t owner_refs = 0;
+    std::size_t chars = 0;
+    for (const shadowed_rule& s : m_shadowed)
+    {
+        chars += rules[s.id].rule.file_pattern.value().size();
+    }
+    for (std::size_t id = 0; id < rules.size(); ++id)
+    {
+        const annotated_rule& arule = rules[id];
+        if (!same_source_as_previous(rules, id))
+        {
+            chars += arule.source.filename.size();
+        }
+        owner_refs += arule.rule.owners.size();
+        for (const owner& o : arule.rule.owners)
+        {
+            if (owner_index.emplace(o.value(), owner_names.size()).second)
+            {
+                owner_names.push_back(o.value());
+                chars += o.value().size();
+            }
+        }
+    }
+
+    // Allocations are made in the order of the layout.
+    m_arena = std::make_unique<arena>(arena::layout{}
+                                          .add<std::string_view>(owner_names.size())
+                                          .add<rule_record>(rules.size())
+                                          .add<owner_id>(owner_refs)
+                                          .add<std::string_view>(owner_refs)
+                                          .add<char>(chars));
+
+    std::string_view* names = m_arena->allocate<std::string_view>(owner_names.size());
+    rule_record* records = m_arena->allocate<rule_record>(rules.size());
+    owner_id* ids = m_arena->allocate<owner_id>(owner_refs);
+    std::string_view* rule_names = m_arena->allocate<std::string_view>(owner_refs);
+    for (owner_id oid = 0; oid < owner_names.size(); ++oid)
+    {
+        names[oid] = m_arena->copy(owner_names[oid]);
+    }
+    m_owner_names = names;
+    m_owner_count = owner_names.size();
+
+    auto next_shadowed = m_shadowed.begin();
+    std::size_t map_position = 0;
+    for (std::size_t id = 0; id < rules.size(); ++id)
+    {
+        const annotated_rule& arule = rules[id];
+        rule_record& record = records[id];
+        if (next_shadowed != m_shadowed.end() && next_shadowed->id == id)
+        {
+            record.file_pattern = m_arena->copy(arule.rule.file_pattern.value());
+            ++next_shadowed;
+        }
+        else
+        {
+            record.file_pattern = m_rule_map->key_at(map_position++).value();
+        }
+        record.source_name = same_source_as_previous(rules, id)
+            ? records[id - 1].source_name
+            : m_arena->copy(arule.source.filename);
+        record.line = arule.source.line;
+        record.owner_count = arule.rule.owners.size();
+        record.owner_ids = ids;
+        record.owner_names = rule_names;
+        for (const owner& o : arule.rule.owners)
+        {
+            *ids = owner_index.find(o.value())->second;
+            *rule_names++ = names[*ids++];
+        }
+    }
+    assert(m_arena->used() == m_arena->capacity());
+    m_records = records;
 }
 
-ruleset::ruleset(std::vector<annotated_rule>&& rules)
-    : m_rule_map{make_rule_map(std::move(rules))}
+ruleset::ruleset(std::vector<annotated_rule>&& rules, std::size_t compile_threads)
+    : ruleset(static_cast<const std::vector<annotated_rule>&>(rules), compile_threads)
 {
 }
 
+ruleset::ruleset(ruleset&& other) noexcept = default;
+ruleset& ruleset::operator=(ruleset&& other) noexcept = default;
 ruleset::~ruleset() = default;
 
+std::optional<ruleset::rule_id> ruleset::find(const fs::path& path) const
+{
+    phase_timer timer{phase::MATCH};
+    const rule_id* id = m_rule_map->get(path);
+    return id ? std::optional<rule_id>{*id} : std::nullopt;
+}
+
+auto ruleset::record(rule_id id) const -> const rule_record&
+{
+    if (id >= m_size)
+    {
+        throw std::out_of_range{"Invalid rule identifier"};
+    }
+    return m_records[id];
+}
+
+annotated_rule ruleset::rule(rule_id id) const
+{
+    const rule_record& r = record(id);
+    std::vector<owner> owners;
+    owners.reserve(r.owner_count);
+    for (std::size_t i = 0; i < r.owner_count; ++i)
+    {
+        owners.emplace_back(std::string{r.owner_names[i]});
+    }
+    return annotated_rule{rule_source{std::string{r.source_name}, r.line},
+                          ownership_rule{pattern{std::string{r.file_pattern}}, std::move(owners)}};
+}
+
+array_view<ruleset::owner_id> ruleset::owner_ids(rule_id id) const
+{
+    const rule_record& r = record(id);
+    return {r.owner_ids, r.owner_count};
+}
+
+array_view<std::string_view> ruleset::owner_names(rule_id id) const
+{
+    const rule_record& r = record(id);
+    return {r.owner_names, r.owner_count};
+}
+
+ruleset::cache_statistics ruleset::directory_cache_statistics() const
+{
+    const auto stats = m_rule_map->directory_cache_statistics();
+    return cache_statistics{stats.hits, stats.misses};
+}
+
+bool ruleset::enable_profiling(bool on)
+{
+#if CODEOWNERS_INSTRUMENTATION
+    m_rule_map->enable_profiling(on);
+    return true;
+#else
+    return !on;
+#endif
+}
+
+std::vector<ruleset::rule_profile> ruleset::profile() const
+{
+    const match_profile* map_profile = m_rule_map->profile();
+    if (!map_profile)
+    {
+        return {};
+    }
+    std::vector<rule_profile> result(m_size);
+    for (rule_id id = 0; id < m_size; ++id)
+    {
+        result[id].id = id;
+    }
+    for (std::size_t pos = 0; pos < map_profile->size(); ++pos)
+    {
+        const auto counts = map_profile->counts(pos);
+        rule_profile& p = result[m_rule_map->value_at(pos)];
+        p.evaluations = counts.evaluations;
+        p.wins = counts.wins;
+        p.time = counts.time;
+    }
+    std::stable_sort(result.begin(), result.end(), [this](const auto& a, const auto& b) {
+        return m_records[a.id].line < m_records[b.id].line;
+    });
+    return result;
+}
+
+ruleset::subtree_match ruleset::find_subtree(const fs::path& dir) const
+{
+    phase_timer timer{phase::MATCH};
+    const auto maybe_it = m_rule_map->find_within(dir);
+    if (!maybe_it)
+    {
+        return subtree_match{false, std::nullopt};
+    }
+    const auto it = *maybe_it;
+    return subtree_match{true, it == m_rule_map->end() ? std::nullopt
+                                                        : std::optional<rule_id>{it->second}};
+}
+
+std::vector<ruleset::rule_id> ruleset::overlapping_rules(const pattern& pat) const
+{
+    std::vector<rule_id> result;
+    for (const std::size_t pos : m_rule_map->find_overlapping(compiled_pattern{pat}))
+    {
+        result.push_back(m_rule_map->value_at(pos));
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+struct ruleset::cursor::impl
+{
+    const ruleset* rules;
+    match_mode mode;
+    pattern_map<rule_id>::cursor map_cursor;
+    /// Cursor over the patterns of shadowed rules, which only `find_all` evaluates.
+    match_cursor shadowed_cursor;
+    /// Positions in the rule map, or among the shadowed rules, of the rules found by the
+    /// last `find_all`.
+    std::vector<std::size_t> positions;
+};
+
+ruleset::cursor::cursor(const ruleset& rules, match_mode mode)
+    : m_impl{std::make_unique<impl>(
+        impl{&rules, mode,
+             pattern_map<rule_id>::cursor{*rules.m_rule_map, mode == match_mode::ALL},
+             match_cursor{mode == match_mode::ALL ? *rules.m_shadowed_patterns : no_patterns,
+                          nullptr, mode == match_mode::ALL},
+             {}})}
+{
+}
+
+ruleset::cursor::cursor(cursor&& other) noexcept = default;
+ruleset::cursor& ruleset::cursor::operator=(cursor&& other) noexcept = default;
+ruleset::cursor::~cursor() = default;
+
+std::optional<ruleset::rule_id> ruleset::cursor::find(const fs::path& path)
+{
+    phase_timer timer{phase::MATCH};
+    auto it = m_impl->map_cursor.find(path);
+    return it == m_impl->rules->m_rule_map->end() ? std::nullopt
+                                                  : std::optional<rule_id>{it->second};
+}
+
+std::optional<ruleset::rule_id> ruleset::cursor::find_all(const fs::path& path,
+                                                         std::vector<rule_id>& matching)
+{
+    if (m_impl->mode != match_mode::ALL)
+    {
+        throw error{"Cursor does not find all matching rules"};
+    }
+    phase_timer timer{phase::MATCH};
+    const pattern_map<rule_id>& map = *m_impl->rules->m_rule_map;
+    auto it = m_impl->map_cursor.find_all(path, m_impl->positions);
+    // Rules that are not shadowed have distinct patterns, so positions follow identifiers.
+    matching.clear();
+    for (const std::size_t pos : m_impl->positions)
+    {
+        matching.push_back(map.value_at(pos));
+    }
+    // Shadowed rules never apply, but may match.
+    m_impl->shadowed_cursor.find_all(path.native(), m_impl->positions);
+    if (!m_impl->positions.empty())
+    {
+        const auto middle = matching.size();
+        for (const std::size_t pos : m_impl->positions)
+        {
+            matching.push_back(m_impl->rules->m_shadowed[pos].id);
+        }
+        std::inplace_merge(matching.begin(), matching.begin() + middle, matching.end());
+    }
+    return it == map.end() ? std::nullopt : std::optional<rule_id>{it->second};
+}
+
+ruleset::subtree_match ruleset::cursor::find_subtree(const fs::path& dir)
+{
+    phase_timer timer{phase::MATCH};
+    const auto maybe_it = m_impl->map_cursor.find_within(dir);
+    if (!maybe_it)
+    {
+        return subtree_match{false, std::nullopt};
+    }
+    const auto it = *maybe_it;
+    return subtree_match{true, it == m_impl->rules->m_rule_map->end()
+                                   ? std::nullopt
+                                   : std::optional<rule_id>{it->second}};
+}
+
 std::optional<annotated_rule> ruleset::apply(const fs::path& path) const
 {
-    const annotated_rule* arule = m_rule_map->get(path);
+    auto id = find(path);
 
     std::optional<annotated_rule> result; // For NRVO
-    return arule ? (result = *arule) : result;
+    return id ? (result = rule(*id)) : result;
+}
+
+std::ostream& write_rule_profile(std::ostream& os, const ruleset& rules,
+                                 const std::vector<ruleset::rule_profile>& profile)
+{
+    const auto flags = os.flags();
+    const auto precision = os.precision();
+    os << "line\tpattern\tevaluations\twins\ttime_us\n" << std::fixed << std::setprecision(3);
+    for (const ruleset::rule_profile& p : profile)
+    {
+        const annotated_rule rule = rules.rule(p.id);
+        const std::chrono::duration<double, std::micro> us = p.time;
+        os << rule.source.line << '\t' << rule.rule.file_pattern.value() << '\t'
+           << p.evaluations << '\t' << p.wins << '\t' << us.count() << '\n';
+    }
+    os.flags(flags);
+    os.precision(precision);
+    return os;
+}
+
+std::ostream& write_shadowed_rules(std::ostream& os, const ruleset& rules)
+{
+    os << "line\tpattern\tshadowed_by_line\tshadowed_by_pattern\n";
+    for (const ruleset::shadowed_rule& s : rules.shadowed_rules())
+    {
+        const annotated_rule rule = rules.rule(s.id);
+        const annotated_rule by = rules.rule(s.shadowed_by);
+        os << rule.source.line << '\t' << rule.rule.file_pattern.value() << '\t'
+           << by.source.line << '\t' << by.rule.file_pattern.value() << '\n';
+    }
+    return os;
+}
+
+std::ostream& write_overlapping_rules(std::ostream& os, const ruleset& rules, const pattern& pat)
+{
+    os << "line\tpattern\towners\n";
+    for (const ruleset::rule_id id : rules.overlapping_rules(pat))
+    {
+        const annotated_rule rule = rules.rule(id);
+        os << rule.source.line << '\t' << rule.rule.file_pattern.value() << '\t';
+        const char* separator = "";
+        for (const std::string_view name : rules.owner_names(id))
+        {
+            os << separator << name;
+            separator = " ";
+        }
+        os << '\n';
+    }
+    return os;
 }
 
-} // end namespace 'co'
\ No newline at end of file
+} // end namespace 'co'
@@ -0,0 +1,60 @@
+#include <codeowners/statistics.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+#include <ostream>
+
+namespace co
+{
+
+ownership_statistics::ownership_statistics(const ruleset& rules, bool with_bytes)
+    : m_ruleset{&rules}
+    , m_with_bytes{with_bytes}
+    , m_owner_totals(rules.owners().size())
+    , m_unowned{}
+    , m_total{}
+{
+}
+
+void ownership_statistics::merge(const ownership_statistics& other)
+{
+    assert(m_ruleset == other.m_ruleset);
+    assert(m_with_bytes == other.m_with_bytes);
+    assert(m_owner_totals.size() == other.m_owner_totals.size());
+    for (std::size_t i = 0; i < m_owner_totals.size(); ++i)
+    {
+        m_owner_totals[i] += other.m_owner_totals[i];
+    }
+    m_unowned += other.m_unowned;
+    m_total += other.m_total;
+}
+
+std::ostream& operator<<(std::ostream& os, const ownership_statistics& stats)
+{
+    std::vector<ruleset::owner_id> ids(stats.m_owner_totals.size());
+    std::iota(ids.begin(), ids.end(), ruleset::owner_id{0});
+    std::stable_sort(ids.begin(), ids.end(), [&](ruleset::owner_id a, ruleset::owner_id b) {
+        return stats.m_owner_totals[a].files > stats.m_owner_totals[b].files;
+    });
+
+    auto write_row = [&](const auto& name, const ownership_totals& totals) {
+        os << name << '\t' << totals.files;
+        if (stats.m_with_bytes)
+        {
+            os << '\t' << totals.bytes;
+        }
+        os << '\n';
+    };
+
+    os << (stats.m_with_bytes ? "owner\tfiles\tbytes\n" : "owner\tfiles\n");
+    for (ruleset::owner_id id : ids)
+    {
+        write_row(stats.m_ruleset->owners()[id], stats.m_owner_totals[id]);
+    }
+    write_row("[NO_OWNER]", stats.m_unowned);
+    write_row("[TOTAL]", stats.m_total);
+    return os;
+}
+
+} // end namespace 'co'
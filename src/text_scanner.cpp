@@ -0,0 +1,183 @@
+#include "text_scanner.hpp"
+
+#include <cassert>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define CODEOWNERS_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace co
+{
+
+namespace
+{
+    using block_masks = text_scanner::block_masks;
+    constexpr std::size_t block_size = text_scanner::block_size;
+
+    block_masks classify_scalar(const char* block)
+    {
+        block_masks masks{0, 0};
+        for (std::size_t i = 0; i < block_size; ++i)
+        {
+            const auto c = static_cast<unsigned char>(block[i]);
+            // Whitespace is the space character, and the range from `\t` to `\r`.
+            const bool space = c == ' ' || static_cast<unsigned char>(c - '\t') <= '\r' - '\t';
+            masks.space |= std::uint64_t{space} << i;
+            masks.newline |= std::uint64_t{c == '\n'} << i;
+        }
+        return masks;
+    }
+
+#ifdef CODEOWNERS_X86_KERNELS
+
+    block_masks classify_sse2(const char* block)
+    {
+        const __m128i space = _mm_set1_epi8(' ');
+        const __m128i tab = _mm_set1_epi8('\t');
+        const __m128i control_range = _mm_set1_epi8('\r' - '\t');
+        const __m128i newline = _mm_set1_epi8('\n');
+
+        block_masks masks{0, 0};
+        for (std::size_t i = 0; i < block_size; i += 16)
+        {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+            // Unsigned `bytes - '\t' <= '\r' - '\t'`, as `min(x, n) == x`.
+            const __m128i offset = _mm_sub_epi8(bytes, tab);
+            const __m128i is_control
+                = _mm_cmpeq_epi8(_mm_min_epu8(offset, control_range), offset);
+            const __m128i is_space = _mm_or_si128(_mm_cmpeq_epi8(bytes, space), is_control);
+            const __m128i is_newline = _mm_cmpeq_epi8(bytes, newline);
+
+            masks.space |= std::uint64_t(static_cast<std::uint16_t>(_mm_movemask_epi8(is_space)))
+                << i;
+            masks.newline
+                |= std::uint64_t(static_cast<std::uint16_t>(_mm_movemask_epi8(is_newline))) << i;
+        }
+        return masks;
+    }
+
+    __attribute__((target("avx2"))) block_masks classify_avx2(const char* block)
+    {
+        const __m256i space = _mm256_set1_epi8(' ');
+        const __m256i tab = _mm256_set1_epi8('\t');
+        const __m256i control_range = _mm256_set1_epi8('\r' - '\t');
+        const __m256i newline = _mm256_set1_epi8('\n');
+
+        block_masks masks{0, 0};
+        for (std::size_t i = 0; i < block_size; i += 32)
+        {
+            const __m256i bytes
+                = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i));
+            const __m256i offset = _mm256_sub_epi8(bytes, tab);
+            const __m256i is_control
+                = _mm256_cmpeq_epi8(_mm256_min_epu8(offset, control_range), offset);
+            const __m256i is_space
+                = _mm256_or_si256(_mm256_cmpeq_epi8(bytes, space), is_control);
+            const __m256i is_newline = _mm256_cmpeq_epi8(bytes, newline);
+
+            masks.space
+                |= std::uint64_t(static_cast<std::uint32_t>(_mm256_movemask_epi8(is_space))) << i;
+            masks.newline
+                |= std::uint64_t(static_cast<std::uint32_t>(_mm256_movemask_epi8(is_newline)))
+                << i;
+        }
+        return masks;
+    }
+
+#endif
+
+    text_scanner::classify_function select_classifier(scan_kernel kernel)
+    {
+        assert(is_supported(kernel));
+        switch (kernel)
+        {
+#ifdef CODEOWNERS_X86_KERNELS
+        case scan_kernel::SSE2:
+            return classify_sse2;
+        case scan_kernel::AVX2:
+            return classify_avx2;
+#endif
+        default:
+            return classify_scalar;
+        }
+    }
+
+} // end anonymous namespace
+
+const char* to_string(scan_kernel kernel)
+{
+    switch (kernel)
+    {
+    case scan_kernel::SCALAR:
+        return "scalar";
+    case scan_kernel::SSE2:
+        return "sse2";
+    case scan_kernel::AVX2:
+        return "avx2";
+    }
+    assert(false && "Unreachable");
+    return "";
+}
+
+bool is_supported(scan_kernel kernel)
+{
+    switch (kernel)
+    {
+    case scan_kernel::SCALAR:
+        return true;
+#ifdef CODEOWNERS_X86_KERNELS
+    case scan_kernel::SSE2:
+        return true; // Part of the x86-64 baseline.
+    case scan_kernel::AVX2:
+        return __builtin_cpu_supports("avx2");
+#endif
+    default:
+        return false;
+    }
+}
+
+scan_kernel default_scan_kernel()
+{
+    static const scan_kernel kernel = [] {
+        for (auto k : {scan_kernel::AVX2, scan_kernel::SSE2})
+        {
+            if (is_supported(k))
+            {
+                return k;
+            }
+        }
+        return scan_kernel::SCALAR;
+    }();
+    return kernel;
+}
+
+text_scanner::text_scanner(std::string_view text, scan_kernel kernel)
+    : m_text{text}
+    , m_classify{select_classifier(kernel)}
+    , m_block{static_cast<std::size_t>(-1)}
+    , m_masks{0, 0}
+{
+}
+
+void text_scanner::load_block(std::size_t block)
+{
+    const std::size_t offset = block * block_size;
+    assert(offset < m_text.size());
+    if (m_text.size() - offset >= block_size)
+    {
+        m_masks = m_classify(m_text.data() + offset);
+    }
+    else
+    {
+        // The final, partial block is padded with whitespace.
+        char padded[block_size];
+        std::memset(padded, ' ', block_size);
+        std::memcpy(padded, m_text.data() + offset, m_text.size() - offset);
+        m_masks = m_classify(padded);
+    }
+    m_block = block;
+}
+
+} // end namespace 'co'
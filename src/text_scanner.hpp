@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace co
+{
+
+/// Implementations of byte classification.  Vector kernels are only available on x86-64
+/// processors that support the corresponding instruction set.
+enum class scan_kernel
+{
+    SCALAR,
+    SSE2,
+    AVX2,
+};
+
+const char* to_string(scan_kernel kernel);
+
+/// Return whether `kernel` can be used on this processor.
+bool is_supported(scan_kernel kernel);
+
+/// Return the fastest kernel supported by this processor.  It is determined once.
+scan_kernel default_scan_kernel();
+
+/**
+ * The text_scanner class finds newlines, whitespace and non-whitespace characters in a
+ * text, for tokenizing CODEOWNERS files.  Whitespace is as for `std::isspace` in the "C"
+ * locale.
+ *
+ * The text is classified in blocks of 64 bytes, using SIMD instructions where available,
+ * into bit masks of whitespace and newline positions.  The masks of the most recently used
+ * block are retained, so that successive searches moving forward through the text classify
+ * each byte only once, and find each result with a few bit operations.
+ */
+class text_scanner
+{
+public:
+    static constexpr std::size_t block_size = 64;
+
+    explicit text_scanner(std::string_view text, scan_kernel kernel = default_scan_kernel());
+
+    /// Return the position of the first newline, whitespace or non-whitespace character at
+    /// or after `pos`, or the size of the text if there is none.
+    std::size_t find_newline(std::size_t pos) { return find<NEWLINE>(pos); }
+    std::size_t find_space(std::size_t pos) { return find<SPACE>(pos); }
+    std::size_t find_non_space(std::size_t pos) { return find<NON_SPACE>(pos); }
+
+    /// Bit `i` of each mask describes byte `i` of a block.
+    struct block_masks
+    {
+        std::uint64_t space;
+        std::uint64_t newline;
+    };
+    using classify_function = block_masks (*)(const char* block);
+
+private:
+    enum target
+    {
+        NEWLINE,
+        SPACE,
+        NON_SPACE,
+    };
+
+    template <target Target> std::size_t find(std::size_t pos);
+    void load_block(std::size_t block);
+
+    std::string_view m_text;
+    classify_function m_classify;
+    /// Index of the block whose masks are loaded, or -1.
+    std::size_t m_block;
+    block_masks m_masks;
+};
+
+template <text_scanner::target Target> std::size_t text_scanner::find(std::size_t pos)
+{
+    while (pos < m_text.size())
+    {
+        const std::size_t block = pos / block_size;
+        if (block != m_block)
+        {
+            load_block(block);
+        }
+        std::uint64_t mask = Target == NEWLINE ? m_masks.newline
+            : Target == SPACE                  ? m_masks.space
+                                               : ~m_masks.space;
+        mask &= ~std::uint64_t{0} << (pos % block_size);
+        if (mask)
+        {
+            const std::size_t found = block * block_size + __builtin_ctzll(mask);
+            // Bytes after the end of the text are classified as whitespace.
+            return found < m_text.size() ? found : m_text.size();
+        }
+        pos = (block + 1) * block_size;
+    }
+    return m_text.size();
+}
+
+} // end namespace 'co'
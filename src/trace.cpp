@@ -0,0 +1,187 @@
+#include "utf8.hpp"
+#include <codeowners/trace.hpp>
+
+#include <codeowners/instrumentation.hpp>
+
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace co
+{
+
+namespace
+{
+    struct thread_buffer
+    {
+        std::size_t thread_id;
+        std::vector<trace_event> events;
+    };
+
+    /// Buffers of all threads that have recorded events, in order of registration.
+    struct registry
+    {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<thread_buffer>> buffers;
+        /// Start of the trace; timestamps are written relative to it.
+        std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    };
+
+    registry& get_registry()
+    {
+        static registry r;
+        return r;
+    }
+
+    thread_buffer& local_buffer()
+    {
+        thread_local const std::shared_ptr<thread_buffer> buffer = [] {
+            registry& r = get_registry();
+            std::lock_guard<std::mutex> lock{r.mutex};
+            auto b = std::make_shared<thread_buffer>();
+            b->thread_id = r.buffers.size() + 1;
+            r.buffers.push_back(b);
+            return b;
+        }();
+        return *buffer;
+    }
+
+    /// Write `s` as a JSON string.  Bytes that are not part of well-formed UTF-8, such as
+    /// those of some paths, are escaped as the code points U+0080 to U+00FF, as in JSON
+    /// Lines output, so that the trace remains valid JSON.
+    void write_json_string(std::ostream& os, std::string_view s)
+    {
+        os << '"';
+        while (!s.empty())
+        {
+            const unsigned char c = static_cast<unsigned char>(s.front());
+            if (c >= 0x80)
+            {
+                if (const std::size_t length = utf8_sequence_length(s); length > 0)
+                {
+                    os << s.substr(0, length);
+                    s.remove_prefix(length);
+                    continue;
+                }
+            }
+            if (c == '"' || c == '\\')
+            {
+                os << '\\' << s.front();
+            }
+            else if (c < 0x20 || c >= 0x80)
+            {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                os << escaped;
+            }
+            else
+            {
+                os << s.front();
+            }
+            s.remove_prefix(1);
+        }
+        os << '"';
+    }
+
+    /// Write a time point or duration in microseconds, which is the unit of trace events.
+    void write_microseconds(std::ostream& os, std::chrono::steady_clock::duration d)
+    {
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.3f", static_cast<double>(ns) / 1000.0);
+        os << text;
+    }
+} // end anonymous namespace
+
+std::atomic<bool> tracer::s_enabled{false};
+
+bool tracer::enable(bool on) noexcept
+{
+#if CODEOWNERS_INSTRUMENTATION
+    get_registry();
+    s_enabled.store(on, std::memory_order_relaxed);
+    return true;
+#else
+    return !on;
+#endif
+}
+
+void tracer::record(trace_event&& event) noexcept
+{
+    if (!enabled())
+    {
+        return;
+    }
+    try
+    {
+        local_buffer().events.push_back(std::move(event));
+    }
+    catch (const std::bad_alloc&)
+    {
+    }
+}
+
+std::ostream& tracer::write_chrome_json(std::ostream& os)
+{
+    registry& r = get_registry();
+    std::lock_guard<std::mutex> lock{r.mutex};
+    os << "{\"traceEvents\":[";
+    bool first = true;
+    for (const auto& buffer : r.buffers)
+    {
+        os << (first ? "\n" : ",\n");
+        first = false;
+        os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->thread_id
+           << ",\"args\":{\"name\":\"thread " << buffer->thread_id << "\"}}";
+        for (const trace_event& event : buffer->events)
+        {
+            os << ",\n{\"name\":";
+            write_json_string(os, event.name);
+            os << ",\"cat\":";
+            write_json_string(os, event.category);
+            os << ",\"ph\":\"X\",\"ts\":";
+            write_microseconds(os, event.begin - r.epoch);
+            os << ",\"dur\":";
+            write_microseconds(os, event.end - event.begin);
+            os << ",\"pid\":1,\"tid\":" << buffer->thread_id;
+            if (!event.detail.empty() || event.arg_count > 0)
+            {
+                os << ",\"args\":{";
+                const char* separator = "";
+                if (!event.detail.empty())
+                {
+                    os << "\"detail\":";
+                    write_json_string(os, event.detail);
+                    separator = ",";
+                }
+                for (std::size_t i = 0; i < event.arg_count; ++i)
+                {
+                    os << separator;
+                    write_json_string(os, event.args[i].first);
+                    os << ':' << event.args[i].second;
+                    separator = ",";
+                }
+                os << '}';
+            }
+            os << '}';
+        }
+    }
+    os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return os;
+}
+
+void tracer::clear()
+{
+    registry& r = get_registry();
+    std::lock_guard<std::mutex> lock{r.mutex};
+    for (const auto& buffer : r.buffers)
+    {
+        buffer->events.clear();
+    }
+}
+
+} // end namespace 'co'
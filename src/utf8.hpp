@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace co
+{
+
+/// Return the length of the well-formed UTF-8 sequence encoding a non-ASCII code point
+/// at the start of `s`, or zero if there is none.
+inline std::size_t utf8_sequence_length(std::string_view s)
+{
+    const auto byte = [s](std::size_t i) { return static_cast<unsigned char>(s[i]); };
+    const auto in_range = [&](std::size_t i, unsigned char lo, unsigned char hi) {
+        return i < s.size() && byte(i) >= lo && byte(i) <= hi;
+    };
+    const unsigned char lead = byte(0);
+    // The range of the second byte excludes overlong encodings, surrogates, and code
+    // points beyond U+10FFFF.
+    std::size_t length = 0;
+    unsigned char lo = 0x80;
+    unsigned char hi = 0xbf;
+    if (lead >= 0xc2 && lead <= 0xdf)
+    {
+        length = 2;
+    }
+    else if (lead >= 0xe0 && lead <= 0xef)
+    {
+        length = 3;
+        lo = lead == 0xe0 ? 0xa0 : 0x80;
+        hi = lead == 0xed ? 0x9f : 0xbf;
+    }
+    else if (lead >= 0xf0 && lead <= 0xf4)
+    {
+        length = 4;
+        lo = lead == 0xf0 ? 0x90 : 0x80;
+        hi = lead == 0xf4 ? 0x8f : 0xbf;
+    }
+    else
+    {
+        return 0;
+    }
+    if (!in_range(1, lo, hi))
+    {
+        return 0;
+    }
+    for (std::size_t i = 2; i < length; ++i)
+    {
+        if (!in_range(i, 0x80, 0xbf))
+        {
+            return 0;
+        }
+    }
+    return length;
+}
+
+} // end namespace 'co'
@@ -0,0 +1,66 @@
+#include <codeowners/allocation_counter.hpp>
+#include <codeowners/ruleset.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+
+namespace co
+{
+
+TEST(allocation_counter_test, counts)
+{
+    allocation_scope scope;
+    auto p = std::make_unique<std::int64_t>(1);
+    auto a = std::make_unique<char[]>(100);
+    EXPECT_EQ(scope.counts().allocations, 2);
+    EXPECT_EQ(scope.counts().deallocations, 0);
+    EXPECT_GE(scope.counts().bytes, sizeof(std::int64_t) + 100);
+    p.reset();
+    a.reset();
+    EXPECT_EQ(scope.counts().deallocations, 2);
+};
+
+TEST(allocation_counter_test, per_thread)
+{
+    allocation_scope scope;
+    std::thread{[] { std::make_unique<int>(0); }}.join();
+    // Only allocations for starting the thread are counted, not those made by it.
+    const auto with_thread = scope.counts().allocations;
+    std::thread{[] {
+        for (int i = 0; i < 100; ++i)
+        {
+            std::make_unique<int>(i);
+        }
+    }}.join();
+    EXPECT_EQ(scope.counts().allocations, 2 * with_thread);
+};
+
+/// The hot path of listing owners does not allocate memory per file, once the cursor's
+/// buffers have grown to the depth of the tree.
+TEST(allocation_counter_test, cursor_find_does_not_allocate)
+{
+    rule_source src{"", 0};
+    const ruleset rset{std::vector<annotated_rule>{
+        {src, {pattern{"*"}, {owner{"@everyone"}}}},
+        {src, {pattern{"/src/"}, {owner{"@developers"}}}},
+        {src, {pattern{"*.md"}, {owner{"@writers"}}}},
+        {src, {pattern{"docs/**/*.txt"}, {owner{"@writers"}}}}}};
+    const std::vector<fs::path> paths{"src/a/b/c.cpp", "src/a/b/d.md", "src/a/e/f.cpp",
+                                      "docs/x/y/z.txt", "docs/w.md", "README.md"};
+
+    ruleset::cursor cursor{rset};
+    for (const auto& p : paths)
+    {
+        cursor.find(p);
+    }
+    allocation_scope scope;
+    for (const auto& p : paths)
+    {
+        cursor.find(p);
+    }
+    EXPECT_EQ(scope.counts().allocations, 0);
+};
+
+} // end namespace 'co'
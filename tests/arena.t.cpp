@@ -0,0 +1,36 @@
+#include <src/arena.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+namespace co
+{
+
+TEST(arena_test, allocation_within_capacity)
+{
+    arena a{arena::layout{}.add<char>(3).add<std::uint64_t>(2)};
+    EXPECT_EQ(a.capacity(), 8 + 2 * sizeof(std::uint64_t));
+
+    const std::string_view s = a.copy("abc");
+    EXPECT_EQ(s, "abc");
+
+    std::uint64_t* values = a.allocate<std::uint64_t>(2);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(values) % alignof(std::uint64_t), 0u);
+    values[0] = 1;
+    values[1] = 2;
+    EXPECT_EQ(s, "abc");
+    EXPECT_EQ(a.used(), a.capacity());
+
+    EXPECT_EQ(a.allocate<int>(0), nullptr);
+    EXPECT_THROW(a.allocate<char>(1), std::bad_alloc);
+};
+
+TEST(arena_test, empty)
+{
+    arena a{0};
+    EXPECT_EQ(a.copy(""), "");
+    EXPECT_THROW(a.allocate<char>(1), std::bad_alloc);
+};
+
+} // end namespace 'co'
@@ -0,0 +1,141 @@
+#include <codeowners/codegen.hpp>
+#include <codeowners/errors.hpp>
+#include <codeowners/generator.hpp>
+#include <codeowners/ruleset.hpp>
+
+// Generated at build time by `codeowners-codegen` from the CODEOWNERS file printed by
+// `generate-repo --codeowners-only`, with the specifications below.
+#include <generated_rules.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <sstream>
+
+namespace co
+{
+
+namespace
+{
+    std::string generate(const std::vector<const char*>& patterns,
+                         const codegen_options& options = {})
+    {
+        std::vector<annotated_rule> rules;
+        for (std::size_t i = 0; i < patterns.size(); ++i)
+        {
+            rules.push_back({rule_source{"CODEOWNERS", static_cast<std::int32_t>(i + 1)},
+                             {pattern{patterns[i]}, {owner{"@alice"}}}});
+        }
+        std::ostringstream os;
+        write_static_ruleset(os, rules, options);
+        return os.str();
+    }
+
+    bool contains(const std::string& text, const std::string& part)
+    {
+        return text.find(part) != std::string::npos;
+    }
+
+    constexpr std::size_t generated_file_count = 1000;
+    constexpr std::size_t generated_rule_count = 100;
+} // end anonymous namespace
+
+TEST(codegen_test, specialized_matchers)
+{
+    const std::string header = generate({"*", "*.md", "README*", "docs/", "/src/main.cpp",
+                                         "/src/*.py", "/src/**/*.py", "/a/*/b"});
+    EXPECT_TRUE(contains(header, "rule_0 = co::universal_matcher{}"));
+    EXPECT_TRUE(contains(header, "rule_1 = co::suffix_matcher{\".md\"}"));
+    EXPECT_TRUE(contains(header, "rule_2 = co::name_matcher{\"README*\"}"));
+    EXPECT_TRUE(contains(header, "rule_3 = co::component_matcher{\"docs\", true}"));
+    EXPECT_TRUE(contains(header, "rule_4 = co::prefix_matcher{\"src/main.cpp\", false}"));
+    EXPECT_TRUE(contains(header, "rule_5 = co::child_matcher{\"src\", \"*.py\"}"));
+    EXPECT_TRUE(contains(header, "rule_6 = co::descendant_matcher{\"src\", \"*.py\"}"));
+    EXPECT_TRUE(contains(header, "rule_7 = co::segments_matcher<3>{"));
+
+    // Later rules take precedence, so they are tested first.
+    EXPECT_LT(header.find("matchers::rule_7.matches"), header.find("matchers::rule_0.matches"));
+};
+
+TEST(codegen_test, shadowed_rules_are_not_tested)
+{
+    const std::string header = generate({"*.md", "/docs/", "*"});
+    EXPECT_FALSE(contains(header, "rule_0 ="));
+    EXPECT_FALSE(contains(header, "rule_1 ="));
+    EXPECT_TRUE(contains(header, "rule_2 ="));
+    // Shadowed rules remain in the table of rules.
+    EXPECT_TRUE(contains(header, "co::static_rule, 3> rules"));
+};
+
+TEST(codegen_test, skipped_rules_are_not_tested)
+{
+    // A pattern with more than 63 segments cannot be compiled, so it matches no path.
+    std::string deep;
+    for (int i = 0; i < 64; ++i)
+    {
+        deep += "/d";
+    }
+    const std::string header = generate({"*.md", deep.c_str(), "/src/"});
+    EXPECT_TRUE(contains(header, "rule_0 ="));
+    EXPECT_FALSE(contains(header, "rule_1 ="));
+    EXPECT_FALSE(contains(header, "matchers::rule_1.matches"));
+    EXPECT_TRUE(contains(header, "// Rule 1 (line 2) is omitted"));
+    EXPECT_TRUE(contains(header, "rule_2 ="));
+    // Skipped rules remain in the table of rules.
+    EXPECT_TRUE(contains(header, "co::static_rule, 3> rules"));
+};
+
+TEST(codegen_test, string_literals_are_escaped)
+{
+    const std::string header = generate({"/a\"b/*.md", "/why?/"});
+    EXPECT_TRUE(contains(header, "\"a\\\"b\""));
+    EXPECT_TRUE(contains(header, "\"why\\077\""));
+};
+
+TEST(codegen_test, namespace)
+{
+    codegen_options options;
+    options.namespace_name = "project::owners";
+    const std::string header = generate({"*"}, options);
+    EXPECT_TRUE(contains(header, "namespace project::owners\n"));
+
+    for (const char* name : {"", "1st", "a::", "a b", "::a", "a-b"})
+    {
+        options.namespace_name = name;
+        EXPECT_THROW(generate({"*"}, options), error) << "namespace: " << name;
+    }
+};
+
+TEST(codegen_test, generated_header_agrees_with_ruleset)
+{
+    repository_spec repo_spec;
+    repo_spec.file_count = generated_file_count;
+    const std::vector<fs::path> paths = generate_paths(repo_spec);
+    codeowners_spec co_spec;
+    co_spec.rule_count = generated_rule_count;
+    const std::vector<annotated_rule> rules = generate_rules(co_spec, paths);
+    const ruleset rset{rules};
+
+    ASSERT_EQ(generated_rules::rules.size(), rules.size());
+    for (std::size_t i = 0; i < rules.size(); ++i)
+    {
+        ASSERT_EQ(generated_rules::rules[i].pattern, rules[i].rule.file_pattern.value());
+    }
+
+    // The rules include shadowed rules, which the generated code does not test, and `**` and
+    // directory-only rules, which it tests with specialized matchers.
+    const auto has_pattern = [](auto predicate) {
+        return std::any_of(generated_rules::rules.begin(), generated_rules::rules.end(),
+                           [&](const static_rule& r) { return predicate(r.pattern); });
+    };
+    EXPECT_FALSE(rset.shadowed_rules().empty());
+    EXPECT_TRUE(has_pattern([](std::string_view p) { return p.find("**") != p.npos; }));
+    EXPECT_TRUE(has_pattern([](std::string_view p) { return p.back() == '/'; }));
+
+    for (const auto& p : paths)
+    {
+        EXPECT_EQ(generated_rules::find(p.native()), rset.find(p)) << "path: " << p;
+    }
+};
+
+} // end namespace 'co'
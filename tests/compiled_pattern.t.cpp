@@ -0,0 +1,214 @@
+#include <src/compiled_pattern.hpp>
+
+#include <codeowners/errors.hpp>
+
+#include <gtest/gtest.h>
+
+namespace co
+{
+
+namespace
+{
+    bool matches(const char* pat, const char* path)
+    {
+        return compiled_pattern{pattern{pat}}.matches(path);
+    }
+} // end anonymous namespace
+
+TEST(compiled_pattern_test, bare_star)
+{
+    EXPECT_TRUE(matches("*", "foo"));
+    EXPECT_TRUE(matches("*", "foo/bar"));
+    EXPECT_TRUE(matches("*", "foo/bar/baz"));
+    EXPECT_TRUE(matches("*", ".hidden"));
+};
+
+TEST(compiled_pattern_test, star_extension)
+{
+    EXPECT_TRUE(matches("*.cpp", "file.cpp"));
+    EXPECT_TRUE(matches("*.cpp", "include/file.cpp"));
+    EXPECT_TRUE(matches("*.cpp", "include/utils/file.cpp"));
+
+    EXPECT_FALSE(matches("*.cpp", "include"));
+    EXPECT_FALSE(matches("*.cpp", "file.hpp"));
+    EXPECT_FALSE(matches("*.cpp", "dir.cpp/file.hpp"));
+};
+
+TEST(compiled_pattern_test, leading_slash)
+{
+    EXPECT_TRUE(matches("/build/logs/", "build/logs/log1.txt"));
+    EXPECT_TRUE(matches("/build/logs/", "build/logs/nested/log1.txt"));
+
+    EXPECT_FALSE(matches("/build/logs/", "build/logs"));
+    EXPECT_FALSE(matches("/build/logs/", "parent/build/logs/log1.txt"));
+    EXPECT_FALSE(matches("/README.md", "docs/README.md"));
+    EXPECT_TRUE(matches("/README.md", "README.md"));
+};
+
+TEST(compiled_pattern_test, trailing_star)
+{
+    EXPECT_TRUE(matches("docs/*", "docs/getting-started.md"));
+    EXPECT_FALSE(matches("docs/*", "docs/build-app/troubleshooting.md"));
+    EXPECT_FALSE(matches("docs/*", "other/docs/getting-started.md"));
+};
+
+TEST(compiled_pattern_test, directory_anywhere)
+{
+    EXPECT_TRUE(matches("apps/", "apps/file"));
+    EXPECT_TRUE(matches("apps/", "parent/apps/file"));
+    EXPECT_FALSE(matches("apps/", "apps"));
+    EXPECT_FALSE(matches("apps/", "parent/apps"));
+};
+
+TEST(compiled_pattern_test, literal_matches_contents)
+{
+    EXPECT_TRUE(matches("/apps/github", "apps/github"));
+    EXPECT_TRUE(matches("/apps/github", "apps/github/main.cpp"));
+    EXPECT_FALSE(matches("/apps/github", "apps/githubx"));
+    EXPECT_TRUE(matches("docs", "a/docs/b/c.md"));
+};
+
+TEST(compiled_pattern_test, double_star)
+{
+    EXPECT_TRUE(matches("**/logs", "logs"));
+    EXPECT_TRUE(matches("**/logs", "a/b/logs"));
+    EXPECT_TRUE(matches("**/logs", "a/b/logs/x.log"));
+
+    EXPECT_TRUE(matches("/docs/**", "docs/a.md"));
+    EXPECT_TRUE(matches("/docs/**", "docs/a/b.md"));
+    EXPECT_FALSE(matches("/docs/**", "docs"));
+
+    EXPECT_TRUE(matches("a/**/b.txt", "a/b.txt"));
+    EXPECT_TRUE(matches("a/**/b.txt", "a/x/y/b.txt"));
+    EXPECT_FALSE(matches("a/**/b.txt", "x/a/b.txt"));
+
+    EXPECT_TRUE(matches("**", "anything/at/all"));
+};
+
+TEST(compiled_pattern_test, wildcards)
+{
+    EXPECT_TRUE(matches("file?.txt", "file1.txt"));
+    EXPECT_FALSE(matches("file?.txt", "file10.txt"));
+    EXPECT_TRUE(matches("file[0-9].txt", "file7.txt"));
+    EXPECT_FALSE(matches("file[0-9].txt", "filex.txt"));
+    EXPECT_TRUE(matches("file[!0-9].txt", "filex.txt"));
+    EXPECT_TRUE(matches("file[]x].txt", "file].txt"));
+    EXPECT_TRUE(matches("file[.txt", "file[.txt"));
+    EXPECT_TRUE(matches("\\*.txt", "*.txt"));
+    EXPECT_FALSE(matches("\\*.txt", "a.txt"));
+    EXPECT_TRUE(matches("a*b*c", "aXbYc"));
+    EXPECT_FALSE(matches("a*b*c", "aXbY"));
+    EXPECT_FALSE(matches("src/*.cpp", "src/a/b.cpp"));
+};
+
+/// Patterns with many wildcards, which take exponential time with a naive backtracking
+/// matcher, are matched in time proportional to the product of pattern and path lengths.
+TEST(compiled_pattern_test, pathological_patterns)
+{
+    const std::string run(200, 'a');
+    EXPECT_FALSE(matches("*a*a*a*a*a*a*a*a*a*a*a*a*b", run.c_str()));
+    EXPECT_TRUE(matches("*a*a*a*a*a*a*a*a*a*a*a*a*", run.c_str()));
+    EXPECT_TRUE(matches("*a*a*a*a*a*a*a*a*a*a*a*a*b", (run + "b").c_str()));
+    EXPECT_FALSE(matches("*?*?*?*?*?*?*?*?*?*?*?*?*b", run.c_str()));
+    EXPECT_FALSE(matches("*[a]*[a]*[a]*[a]*[a]*[a]*[a]*b", run.c_str()));
+
+    std::string deep;
+    for (int i = 0; i < 50; ++i)
+    {
+        deep += run + "/";
+    }
+    EXPECT_FALSE(matches("**/a*a*a*a*a*a*a*a*b", (deep + run).c_str()));
+    EXPECT_TRUE(matches("**/a*a*a*a*a*a*a*a*b", (deep + run + "b").c_str()));
+    EXPECT_FALSE(matches("**/**/**/**/**/**/a*a*a*b/**/c", (deep + run).c_str()));
+};
+
+TEST(compiled_pattern_test, matches_all_within)
+{
+    EXPECT_TRUE(compiled_pattern{pattern{"*"}}.matches_all_within("any/dir"));
+    EXPECT_TRUE(compiled_pattern{pattern{"/third_party/"}}.matches_all_within("third_party"));
+    EXPECT_TRUE(compiled_pattern{pattern{"/third_party/"}}.matches_all_within("third_party/x"));
+    EXPECT_TRUE(compiled_pattern{pattern{"/third_party/**"}}.matches_all_within("third_party"));
+    EXPECT_TRUE(compiled_pattern{pattern{"docs/*/"}}.matches_all_within("docs/a"));
+    EXPECT_TRUE(compiled_pattern{pattern{"/src/**/*"}}.matches_all_within("src/a"));
+
+    EXPECT_FALSE(compiled_pattern{pattern{"/third_party/"}}.matches_all_within("."));
+    EXPECT_FALSE(compiled_pattern{pattern{"/third_party/"}}.matches_all_within("src"));
+    EXPECT_FALSE(compiled_pattern{pattern{"*.cpp"}}.matches_all_within("src"));
+    EXPECT_FALSE(compiled_pattern{pattern{"docs/*"}}.matches_all_within("docs"));
+};
+
+TEST(compiled_pattern_test, may_match_within)
+{
+    EXPECT_TRUE(compiled_pattern{pattern{"*.cpp"}}.may_match_within("src/a"));
+    EXPECT_TRUE(compiled_pattern{pattern{"/src/a.cpp"}}.may_match_within("src"));
+    EXPECT_TRUE(compiled_pattern{pattern{"/src/"}}.may_match_within("src/x"));
+    EXPECT_TRUE(compiled_pattern{pattern{"/src/"}}.may_match_within("."));
+
+    EXPECT_FALSE(compiled_pattern{pattern{"/src/a.cpp"}}.may_match_within("docs"));
+    EXPECT_FALSE(compiled_pattern{pattern{"/src/*.cpp"}}.may_match_within("src/a.cpp"));
+    EXPECT_FALSE(compiled_pattern{pattern{"docs/*"}}.may_match_within("docs/build"));
+};
+
+TEST(compiled_pattern_test, subsumes)
+{
+    const auto subsumes = [](const char* a, const char* b) {
+        return compiled_pattern{pattern{a}}.subsumes(compiled_pattern{pattern{b}});
+    };
+    EXPECT_TRUE(subsumes("*", "/docs/*.md"));
+    EXPECT_TRUE(subsumes("**", "*.md"));
+    EXPECT_TRUE(subsumes("*.md", "*.md"));
+    EXPECT_TRUE(subsumes("**/*.md", "*.md"));
+    EXPECT_TRUE(subsumes("/docs/", "/docs/*.md"));
+    EXPECT_TRUE(subsumes("/docs/", "/docs/a/**/b"));
+    EXPECT_TRUE(subsumes("/docs/**", "/docs/"));
+    EXPECT_TRUE(subsumes("/docs", "/docs"));
+    EXPECT_TRUE(subsumes("/docs", "/docs/"));
+
+    EXPECT_FALSE(subsumes("/docs/", "/docs"));
+    EXPECT_FALSE(subsumes("/docs/*.md", "/docs/"));
+    EXPECT_FALSE(subsumes("/docs/*", "/docs/a/b"));
+    EXPECT_FALSE(subsumes("*.md", "*.txt"));
+    EXPECT_FALSE(subsumes("/src/", "/docs/a"));
+    EXPECT_FALSE(subsumes("/docs/", "docs/"));
+};
+
+TEST(compiled_pattern_test, overlaps)
+{
+    const auto overlaps = [](const char* a, const char* b) {
+        const compiled_pattern pa{pattern{a}};
+        const compiled_pattern pb{pattern{b}};
+        EXPECT_EQ(pa.overlaps(pb), pb.overlaps(pa)) << a << " and " << b;
+        return pa.overlaps(pb);
+    };
+    EXPECT_TRUE(overlaps("*", "/docs/*.md"));
+    EXPECT_TRUE(overlaps("*.md", "/docs/"));
+    EXPECT_TRUE(overlaps("/services/*/api/**", "/services/billing/"));
+    EXPECT_TRUE(overlaps("/services/*/api/**", "api/"));
+    EXPECT_TRUE(overlaps("/services/*/api/**", "*.py"));
+    EXPECT_TRUE(overlaps("/services/*/api/**", "/services/**/handler.py"));
+    EXPECT_TRUE(overlaps("a*b", "*ab*"));
+    EXPECT_TRUE(overlaps("[a-c]x", "?x"));
+    EXPECT_TRUE(overlaps("/docs", "/docs/"));
+    EXPECT_TRUE(overlaps("/a/b", "/a/*/c"));
+
+    EXPECT_FALSE(overlaps("/services/*/api/**", "/docs/"));
+    EXPECT_FALSE(overlaps("/services/*/api/**", "/services/*"));
+    EXPECT_FALSE(overlaps("/services/*/api/**", "/services/*/web/"));
+    EXPECT_FALSE(overlaps("*.md", "*.txt"));
+    EXPECT_FALSE(overlaps("[a-c]x", "[d-f]x"));
+    EXPECT_FALSE(overlaps("/docs/", "/doc"));
+    EXPECT_FALSE(overlaps("/docs/*", "/docs/a/b"));
+    EXPECT_FALSE(overlaps("/a/*.md", "/a/b/"));
+};
+
+TEST(compiled_pattern_test, too_many_segments)
+{
+    std::string text;
+    for (int i = 0; i < 100; ++i)
+    {
+        text += "/a";
+    }
+    EXPECT_THROW(compiled_pattern{pattern{text}}, co::error);
+};
+
+} // end namespace 'co'
@@ -117,4 +117,31 @@ TEST(temporary_directory_handle_test, path_str)
     EXPECT_EQ(temp_dir.path_str(), temp_dir.path().string());
 };
 
-} /* end namespace 'co' */
\ No newline at end of file
+TEST(relative_path_builder_test, paths_within_start)
+{
+    temporary_directory_handle temp_dir;
+    fs::create_directories(temp_dir / "src/a");
+
+    relative_path_builder from_base{temp_dir, temp_dir.path()};
+    EXPECT_EQ(from_base(temp_dir.path()), ".");
+    EXPECT_EQ(from_base(temp_dir / "README.md"), "README.md");
+    EXPECT_EQ(from_base(temp_dir / "src/a/b.cpp"), "src/a/b.cpp");
+
+    relative_path_builder from_subdirectory{temp_dir, temp_dir / "src/"};
+    EXPECT_EQ(from_subdirectory(temp_dir / "src/"), "src");
+    EXPECT_EQ(from_subdirectory(temp_dir / "src/" / "a"), "src/a");
+    EXPECT_EQ(from_subdirectory(temp_dir / "src/" / "a/b.cpp"), "src/a/b.cpp");
+};
+
+TEST(relative_path_builder_test, start_spelled_differently)
+{
+    temporary_directory_handle temp_dir;
+    fs::create_directories(temp_dir / "src/a");
+
+    // The start is resolved once, and entries keep the spelling of the start.
+    relative_path_builder builder{temp_dir, temp_dir / "src/a/.."};
+    EXPECT_EQ(builder(temp_dir / "src/a/.." / "a/b.cpp"), "src/a/b.cpp");
+    EXPECT_EQ(builder(temp_dir / "src/a/.." / "main.cpp"), "src/main.cpp");
+};
+
+} /* end namespace 'co' */
@@ -0,0 +1,127 @@
+#include <codeowners/generator.hpp>
+
+#include <codeowners/index.hpp>
+#include <codeowners/mapped_parser.hpp>
+#include <codeowners/repository.hpp>
+#include <codeowners/ruleset.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <set>
+#include <sstream>
+
+namespace co
+{
+
+TEST(generator_test, paths_follow_spec)
+{
+    repository_spec spec;
+    spec.seed = 3;
+    spec.file_count = 2000;
+    spec.depth = 3;
+    spec.fan_out = 5;
+
+    const auto paths = generate_paths(spec);
+    ASSERT_EQ(paths.size(), spec.file_count);
+    EXPECT_TRUE(std::is_sorted(paths.begin(), paths.end()));
+    EXPECT_EQ(std::set<fs::path>(paths.begin(), paths.end()).size(), paths.size());
+
+    std::map<fs::path, std::set<fs::path>> subdirectories;
+    std::size_t max_depth = 0;
+    for (const auto& p : paths)
+    {
+        const auto depth = static_cast<std::size_t>(std::distance(p.begin(), p.end())) - 1;
+        max_depth = std::max(max_depth, depth);
+        for (fs::path dir = p.parent_path(); !dir.empty(); dir = dir.parent_path())
+        {
+            subdirectories[dir.parent_path()].insert(dir);
+        }
+    }
+    EXPECT_EQ(max_depth, spec.depth);
+    for (const auto& [dir, subdirs] : subdirectories)
+    {
+        EXPECT_LE(subdirs.size(), spec.fan_out) << dir;
+    }
+};
+
+TEST(generator_test, output_is_determined_by_seed)
+{
+    repository_spec repo_spec;
+    codeowners_spec co_spec;
+    const auto paths = generate_paths(repo_spec);
+    const auto rules = generate_rules(co_spec, paths);
+    EXPECT_EQ(generate_paths(repo_spec), paths);
+    EXPECT_EQ(generate_rules(co_spec, paths), rules);
+
+    repo_spec.seed = 1;
+    co_spec.seed = 1;
+    EXPECT_NE(generate_paths(repo_spec), paths);
+    EXPECT_NE(generate_rules(co_spec, paths), rules);
+};
+
+TEST(generator_test, rules_match_generated_paths)
+{
+    repository_spec repo_spec;
+    repo_spec.file_count = 5000;
+    codeowners_spec co_spec;
+    co_spec.rule_count = 500;
+    co_spec.owner_count = 20;
+
+    const auto paths = generate_paths(repo_spec);
+    const auto rules = generate_rules(co_spec, paths);
+    ASSERT_EQ(rules.size(), co_spec.rule_count);
+    EXPECT_EQ(rules.front().rule.file_pattern, pattern{"*"});
+
+    // Every file is owned, and most rules are the last match for some file.
+    const ruleset rset{rules};
+    std::set<ruleset::rule_id> winners;
+    for (const auto& p : paths)
+    {
+        const auto id = rset.find(p);
+        ASSERT_TRUE(id) << p;
+        winners.insert(*id);
+    }
+    EXPECT_GT(winners.size(), rules.size() / 2);
+
+    // Written rules read back unchanged.
+    std::ostringstream oss;
+    write_codeowners(oss, rules);
+    const std::string content = oss.str();
+    EXPECT_EQ(codeowners_view(content, "CODEOWNERS").to_annotated_rules(), rules);
+};
+
+TEST(generator_test, generate_repository)
+{
+    temporary_directory_handle temp_dir;
+    repository_spec repo_spec;
+    repo_spec.file_count = 200;
+    repo_spec.submodule_count = 2;
+    repo_spec.submodule_file_count = 10;
+    repo_spec.max_file_size = 64;
+    codeowners_spec co_spec;
+    co_spec.rule_count = 20;
+
+    const auto generated = generate_repository(temp_dir, repo_spec, co_spec);
+    EXPECT_EQ(generated.paths, generate_paths(repo_spec));
+    for (const auto& p : generated.paths)
+    {
+        EXPECT_TRUE(fs::is_regular_file(temp_dir / p)) << p;
+        EXPECT_LE(fs::file_size(temp_dir / p), repo_spec.max_file_size) << p;
+    }
+    EXPECT_EQ(parse_mapped(temp_dir / "CODEOWNERS", "CODEOWNERS"), generated.rules);
+
+    repository repo = repository::open(temp_dir);
+    auto submodule_paths = repo.submodule_paths();
+    std::sort(submodule_paths.begin(), submodule_paths.end());
+    EXPECT_EQ(submodule_paths, generated.submodule_paths);
+
+    // The index holds the files, the CODEOWNERS file, .gitmodules and one entry per submodule.
+    index idx{repo};
+    const auto entries = std::distance(idx.begin(), idx.end());
+    EXPECT_EQ(static_cast<std::size_t>(entries), generated.paths.size() + 2 + 2);
+};
+
+} // end namespace 'co'
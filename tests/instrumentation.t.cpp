@@ -0,0 +1,108 @@
+#include <codeowners/instrumentation.hpp>
+#include <codeowners/ruleset.hpp>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <thread>
+
+namespace co
+{
+
+namespace
+{
+    /// Enables instrumentation, with zeroed timers and counters, for its lifetime.
+    struct enabled_instrumentation
+    {
+        enabled_instrumentation()
+        {
+            instrumentation::reset();
+            instrumentation::enable();
+        }
+        ~enabled_instrumentation()
+        {
+            instrumentation::enable(false);
+            instrumentation::reset();
+        }
+    };
+} // end anonymous namespace
+
+#if CODEOWNERS_INSTRUMENTATION
+
+TEST(instrumentation_test, disabled_by_default)
+{
+    EXPECT_FALSE(instrumentation::enabled());
+    instrumentation::add(counter::FILES_VISITED);
+    {
+        phase_timer timer{phase::MATCH};
+    }
+    EXPECT_EQ(instrumentation::count(counter::FILES_VISITED), 0u);
+    EXPECT_EQ(instrumentation::time(phase::MATCH).count(), 0);
+};
+
+TEST(instrumentation_test, counters)
+{
+    enabled_instrumentation enabled;
+    rule_source src{"", 0};
+    const ruleset rset{std::vector<annotated_rule>{
+        {src, {pattern{"*.md"}, {owner{"@writers"}}}},
+        {src, {pattern{"/src/"}, {owner{"@developers"}}}}}};
+
+    EXPECT_GT(instrumentation::time(phase::COMPILE).count(), 0);
+
+    ruleset::cursor cursor{rset};
+    EXPECT_EQ(cursor.find("src/a/b.cpp"), std::optional<ruleset::rule_id>{1});
+    EXPECT_EQ(cursor.find("README.md"), std::optional<ruleset::rule_id>{0});
+    EXPECT_GT(instrumentation::count(counter::RULES_EVALUATED), 0u);
+    EXPECT_GT(instrumentation::time(phase::MATCH).count(), 0);
+
+    rset.find("docs/a.md");
+    rset.find("docs/b.md");
+    EXPECT_EQ(instrumentation::count(counter::DIRECTORY_CACHE_MISSES), 1u);
+    EXPECT_EQ(instrumentation::count(counter::DIRECTORY_CACHE_HITS), 1u);
+
+    std::ostringstream oss;
+    instrumentation::report(oss);
+    EXPECT_NE(oss.str().find("directory_cache_hits"), std::string::npos);
+    EXPECT_NE(oss.str().find("compile"), std::string::npos);
+
+    // The formatting state of the stream is unchanged.
+    std::ostringstream formatted;
+    const auto flags = formatted.flags();
+    const auto precision = formatted.precision();
+    instrumentation::report(formatted);
+    EXPECT_EQ(formatted.flags(), flags);
+    EXPECT_EQ(formatted.precision(), precision);
+    formatted.str("");
+    formatted << 1.5;
+    EXPECT_EQ(formatted.str(), "1.5");
+};
+
+TEST(instrumentation_test, nested_timers_are_exclusive)
+{
+    enabled_instrumentation enabled;
+    const auto pause = std::chrono::milliseconds{20};
+    {
+        phase_timer outer{phase::TRAVERSAL};
+        std::this_thread::sleep_for(pause);
+        {
+            phase_timer inner{phase::OUTPUT};
+            std::this_thread::sleep_for(pause);
+        }
+    }
+    EXPECT_GE(instrumentation::time(phase::TRAVERSAL), pause);
+    EXPECT_GE(instrumentation::time(phase::OUTPUT), pause);
+    EXPECT_LT(instrumentation::time(phase::TRAVERSAL), 2 * pause);
+};
+
+#else
+
+TEST(instrumentation_test, not_compiled)
+{
+    EXPECT_FALSE(instrumentation::enable());
+    EXPECT_FALSE(instrumentation::enabled());
+};
+
+#endif
+
+} // end namespace 'co'
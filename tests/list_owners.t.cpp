@@ -0,0 +1,159 @@
+#include <codeowners/list_owners.hpp>
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <sstream>
+
+namespace co
+{
+
+TEST(list_owners_test, for_each_owned_file)
+{
+    temporary_directory_handle temp_dir;
+    for (const auto& dir : {"src/a", "docs/guide", "external/module"})
+    {
+        fs::create_directories(temp_dir / dir);
+    }
+    for (const auto& file : {"README.md", "src/main.cpp", "src/a/b.cpp", "src/a/c.md",
+                             "docs/index.md", "docs/guide/intro.txt", "external/module/x.cpp"})
+    {
+        ensure_exists(temp_dir / file);
+    }
+
+    rule_source src{"", 0};
+    const ruleset rset{std::vector<annotated_rule>{
+        {src, {pattern{"*.md"}, {owner{"@writers"}}}},
+        {src, {pattern{"/src/"}, {owner{"@developers"}}}},
+        {src, {pattern{"/docs/"}, {owner{"@docs"}}}}}};
+    const std::vector<fs::path> to_skip{temp_dir / "external/module"};
+
+    std::map<fs::path, std::optional<ruleset::rule_id>> visited;
+    const auto visit = [&](const fs::directory_entry& entry, std::string_view relative_path,
+                           std::optional<ruleset::rule_id> rule_id) {
+        const fs::path path{relative_path.begin(), relative_path.end()};
+        EXPECT_EQ(path, fs::relative(entry.path(), temp_dir));
+        EXPECT_TRUE(visited.emplace(path, rule_id).second);
+    };
+
+    ruleset::cursor cursor{rset};
+    for_each_owned_file(cursor, temp_dir, temp_dir, to_skip, visit);
+    const std::map<fs::path, std::optional<ruleset::rule_id>> expected{
+        {"README.md", 0},     {"src/main.cpp", 1},         {"src/a/b.cpp", 1},
+        {"src/a/c.md", 1},    {"docs/index.md", 2},        {"docs/guide/intro.txt", 2}};
+    EXPECT_EQ(visited, expected);
+
+    // Traversal may start within the work directory.
+    visited.clear();
+    for_each_owned_file(cursor, temp_dir, temp_dir / "src", to_skip, visit);
+    EXPECT_EQ(visited, (std::map<fs::path, std::optional<ruleset::rule_id>>{
+                           {"src/main.cpp", 1}, {"src/a/b.cpp", 1}, {"src/a/c.md", 1}}));
+
+    // Only the files of wanted rules are visited.
+    visited.clear();
+    const auto wanted = [](std::optional<ruleset::rule_id> id) { return id != 1; };
+    for_each_owned_file(cursor, temp_dir, temp_dir, to_skip, visit, wanted);
+    EXPECT_EQ(visited, (std::map<fs::path, std::optional<ruleset::rule_id>>{
+                           {"README.md", 0},
+                           {"docs/index.md", 2},
+                           {"docs/guide/intro.txt", 2}}));
+    visited.clear();
+    for_each_owned_file(cursor, temp_dir, temp_dir / "src", to_skip, visit, wanted);
+    EXPECT_TRUE(visited.empty());
+};
+
+TEST(list_owners_test, for_each_matched_file)
+{
+    temporary_directory_handle temp_dir;
+    for (const auto& dir : {"src/a", "docs", "tools", "external/module"})
+    {
+        fs::create_directories(temp_dir / dir);
+    }
+    for (const auto& file : {"README.md", "src/main.cpp", "src/a/c.md", "docs/index.md",
+                             "docs/x.txt", "tools/run.sh", "external/module/x.cpp"})
+    {
+        ensure_exists(temp_dir / file);
+    }
+
+    rule_source src{"", 0};
+    const ruleset rset{std::vector<annotated_rule>{
+        {src, {pattern{"*.md"}, {owner{"@writers"}}}},
+        {src, {pattern{"/src/"}, {owner{"@developers"}}}},
+        {src, {pattern{"/docs/"}, {owner{"@docs"}}}}}};
+    const std::vector<fs::path> to_skip{temp_dir / "external/module"};
+
+    std::map<fs::path, std::vector<ruleset::rule_id>> visited;
+    const auto visit = [&](const fs::directory_entry& entry,
+                           const std::vector<ruleset::rule_id>& matching,
+                           std::optional<ruleset::rule_id> rule_id) {
+        EXPECT_EQ(rule_id, matching.empty() ? std::nullopt
+                                            : std::optional<ruleset::rule_id>{matching.back()});
+        EXPECT_TRUE(visited.emplace(fs::relative(entry.path(), temp_dir), matching).second);
+    };
+
+    ruleset::cursor cursor{rset, ruleset::match_mode::ALL};
+    for_each_matched_file(cursor, temp_dir, temp_dir, to_skip, visit);
+    const std::map<fs::path, std::vector<ruleset::rule_id>> expected{
+        {"README.md", {0}},        {"src/main.cpp", {1}}, {"src/a/c.md", {0, 1}},
+        {"docs/index.md", {0, 2}}, {"docs/x.txt", {2}},    {"tools/run.sh", {}}};
+    EXPECT_EQ(visited, expected);
+};
+
+TEST(rule_coverage_test, add)
+{
+    const ruleset rules{std::vector<annotated_rule>{
+        {rule_source{"CODEOWNERS", 1}, {pattern{"*"}, {owner{"@everyone"}}}},
+        {rule_source{"CODEOWNERS", 2}, {pattern{"*.md"}, {owner{"@writers"}}}},
+        {rule_source{"CODEOWNERS", 3}, {pattern{"/docs/"}, {owner{"@docs"}}}}}};
+
+    rule_coverage coverage{rules};
+    rule_coverage other{rules};
+    coverage.add({0, 1}, 1);
+    coverage.add({0, 1, 2}, 2);
+    other.add({0}, 0);
+    other.add({}, std::nullopt);
+    coverage.merge(other);
+
+    EXPECT_EQ(coverage.counts(0).matches, 3);
+    EXPECT_EQ(coverage.counts(0).wins, 1);
+    EXPECT_EQ(coverage.counts(1).matches, 2);
+    EXPECT_EQ(coverage.counts(1).wins, 1);
+    EXPECT_EQ(coverage.counts(2).wins, 1);
+    EXPECT_EQ(coverage.unmatched_files(), 1);
+    EXPECT_EQ(coverage.files(), 4);
+
+    std::ostringstream oss;
+    oss << coverage;
+    EXPECT_EQ(oss.str(), "line\tpattern\tmatches\twins\n"
+                         "1\t*\t3\t1\n"
+                         "2\t*.md\t2\t1\n"
+                         "3\t/docs/\t1\t1\n"
+                         "\t[NO_RULE]\t1\t1\n"
+                         "\t[TOTAL]\t4\t4\n");
+};
+
+TEST(rule_coverage_test, shadowed_rules)
+{
+    // Rule 0 is shadowed by rule 1:  it matches files, but applies to none.
+    const ruleset rules{std::vector<annotated_rule>{
+        {rule_source{"CODEOWNERS", 1}, {pattern{"/docs/*.md"}, {owner{"@writers"}}}},
+        {rule_source{"CODEOWNERS", 2}, {pattern{"/docs/"}, {owner{"@docs"}}}},
+        {rule_source{"CODEOWNERS", 3}, {pattern{"*.md"}, {owner{"@everyone"}}}}}};
+    ASSERT_EQ(rules.shadowed_rules().size(), 1);
+
+    ruleset::cursor cursor{rules, ruleset::match_mode::ALL};
+    rule_coverage coverage{rules};
+    std::vector<ruleset::rule_id> matching;
+    for (const char* path : {"docs/a.md", "docs/b.md", "docs/c.txt", "README.md"})
+    {
+        const auto rule_id = cursor.find_all(path, matching);
+        coverage.add(matching, rule_id);
+    }
+    EXPECT_EQ(coverage.counts(0).matches, 2);
+    EXPECT_EQ(coverage.counts(0).wins, 0);
+    EXPECT_EQ(coverage.counts(1).matches, 3);
+    EXPECT_EQ(coverage.counts(1).wins, 1);
+    EXPECT_EQ(coverage.counts(2).wins, 3);
+};
+
+} // end namespace 'co'
@@ -0,0 +1,75 @@
+#include <codeowners/errors.hpp>
+#include <codeowners/mapped_parser.hpp>
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+
+namespace co
+{
+
+namespace
+{
+    const char* content = R"(# Comment
+        docs/*  docs@example.com
+
+        # Comment
+        apps/  @octocat	@doctocat
+    )";
+
+    std::vector<annotated_rule> expected_rules(const std::string& source_name)
+    {
+        return {annotated_rule{rule_source{source_name, 2},
+                               ownership_rule{pattern{"docs/*"}, {owner{"docs@example.com"}}}},
+                annotated_rule{rule_source{source_name, 5},
+                               ownership_rule{pattern{"apps/"},
+                                              {owner{"@octocat"}, owner{"@doctocat"}}}}};
+    }
+} // end anonymous namespace
+
+TEST(mapped_parser, tokens_are_views)
+{
+    const std::string_view text = content;
+    codeowners_view view{text, ".github/CODEOWNERS"};
+
+    ASSERT_EQ(view.rules().size(), 2u);
+    const auto& rule = view.rules()[1];
+    EXPECT_EQ(rule.line(), 5);
+    EXPECT_EQ(rule.file_pattern(), "apps/");
+    ASSERT_EQ(rule.owner_count(), 2u);
+    EXPECT_EQ(rule.owners_begin()[1], "@doctocat");
+
+    // Tokens refer to the parsed content.
+    EXPECT_GE(rule.file_pattern().data(), text.data());
+    EXPECT_LT(rule.file_pattern().data(), text.data() + text.size());
+
+    EXPECT_EQ(view.to_annotated_rules(), expected_rules(".github/CODEOWNERS"));
+};
+
+TEST(mapped_parser, no_rules)
+{
+    for (const auto text : {"", "\n", "\t\r\n", "  # comment", "#a b\n\n# c"})
+    {
+        EXPECT_TRUE(codeowners_view{text}.rules().empty());
+    }
+};
+
+TEST(mapped_parser, parse_mapped)
+{
+    const fs::path path = fs::temp_directory_path() / fs::unique_path();
+    {
+        std::ofstream ofs{path.c_str()};
+        ofs << content;
+    }
+    EXPECT_EQ(parse_mapped(path, "CODEOWNERS"), expected_rules("CODEOWNERS"));
+    EXPECT_EQ(parse_mapped(path), expected_rules(path.string()));
+
+    // Empty files cannot be mapped, but have no rules.
+    std::ofstream{path.c_str()};
+    EXPECT_TRUE(parse_mapped(path).empty());
+
+    fs::remove(path);
+    EXPECT_THROW(parse_mapped(path), co::file_not_found_error);
+};
+
+} // end namespace 'co'
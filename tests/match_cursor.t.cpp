@@ -0,0 +1,137 @@
+#include <src/match_cursor.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+namespace co
+{
+
+namespace
+{
+    std::vector<compiled_pattern> compile(const std::vector<std::string>& texts)
+    {
+        std::vector<compiled_pattern> patterns;
+        for (const auto& text : texts)
+        {
+            patterns.emplace_back(pattern{text});
+        }
+        return patterns;
+    }
+
+    /// Return the position of the last pattern matching `path`, without a cursor.
+    std::size_t find_last(const std::vector<compiled_pattern>& patterns, std::string_view path)
+    {
+        for (std::size_t pos = patterns.size(); pos-- > 0;)
+        {
+            if (patterns[pos].matches(path))
+            {
+                return pos;
+            }
+        }
+        return match_cursor::npos;
+    }
+
+    const std::vector<std::string> sample_patterns{
+        "*",       "/src/",   "*.md",       "/src/**/test_*.cpp", "docs/*", "/third_party/",
+        "build/",  "/src/a/", "/src/a/b.c", "**/gen/*.h",         "x?z/",   "[ab]*.txt"};
+
+    const std::vector<std::string> sample_paths{
+        "README.md",
+        "a.txt",
+        "docs/index.md",
+        "docs/api/ref.html",
+        "src/a/b.c",
+        "src/a/b.cpp",
+        "src/a/deep/gen/x.h",
+        "src/a/deep/test_x.cpp",
+        "src/b/build/out.o",
+        "src/b/test_y.cpp",
+        "src/main.cpp",
+        "third_party/lib/x.c",
+        "third_party/lib/x.md",
+        "xyz/file",
+        "xyz/sub/b.txt",
+    };
+
+} // end anonymous namespace
+
+TEST(match_cursor_test, agrees_with_patterns)
+{
+    const auto patterns = compile(sample_patterns);
+
+    // The cursor must give the same results for sorted, reversed and repeated sequences.
+    std::vector<std::string> paths = sample_paths;
+    for (int pass = 0; pass < 3; ++pass)
+    {
+        match_cursor cursor{patterns};
+        for (const auto& path : paths)
+        {
+            EXPECT_EQ(cursor.find(path), find_last(patterns, path)) << "path: " << path;
+        }
+        std::reverse(paths.begin(), paths.end());
+        if (pass == 1)
+        {
+            paths.insert(paths.end(), sample_paths.begin(), sample_paths.end());
+        }
+    }
+};
+
+TEST(match_cursor_test, find_all)
+{
+    const auto patterns = compile(sample_patterns);
+
+    std::vector<std::string> paths = sample_paths;
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        match_cursor cursor{patterns, nullptr, true};
+        std::vector<std::size_t> positions;
+        for (const auto& path : paths)
+        {
+            std::vector<std::size_t> expected;
+            for (std::size_t pos = 0; pos < patterns.size(); ++pos)
+            {
+                if (patterns[pos].matches(path))
+                {
+                    expected.push_back(pos);
+                }
+            }
+            EXPECT_EQ(cursor.find_all(path, positions), find_last(patterns, path))
+                << "path: " << path;
+            EXPECT_EQ(positions, expected) << "path: " << path;
+            // Patterns kept only to find all matches do not change the results of `find`.
+            EXPECT_EQ(cursor.find(path), find_last(patterns, path)) << "path: " << path;
+        }
+        std::reverse(paths.begin(), paths.end());
+    }
+};
+
+TEST(match_cursor_test, no_patterns)
+{
+    const std::vector<compiled_pattern> patterns;
+    match_cursor cursor{patterns};
+    EXPECT_EQ(cursor.find("a/b"), match_cursor::npos);
+    EXPECT_EQ(cursor.find_within("a"), std::optional<std::size_t>{match_cursor::npos});
+};
+
+TEST(match_cursor_test, find_within)
+{
+    const auto patterns = compile(sample_patterns);
+    match_cursor cursor{patterns};
+
+    // `*.md` and others may match within `src/b`.
+    EXPECT_FALSE(cursor.find_within("src/b"));
+    EXPECT_EQ(cursor.find("src/b/x.md"), 2);
+
+    // Unanchored patterns after `/third_party/`, such as `*.md`, may match within it.
+    EXPECT_FALSE(cursor.find_within("third_party"));
+
+    const auto only_anchored = compile({"*", "/third_party/", "/src/*.md"});
+    match_cursor anchored_cursor{only_anchored};
+    EXPECT_EQ(anchored_cursor.find_within("third_party/lib"), std::optional<std::size_t>{1});
+    EXPECT_EQ(anchored_cursor.find_within("docs"), std::optional<std::size_t>{0});
+    EXPECT_FALSE(anchored_cursor.find_within("src"));
+    EXPECT_EQ(anchored_cursor.find_within("src/a"), std::optional<std::size_t>{0});
+};
+
+} // end namespace 'co'
@@ -0,0 +1,150 @@
+#include <codeowners/output.hpp>
+
+#include <codeowners/errors.hpp>
+#include <codeowners/filesystem.hpp>
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <sstream>
+
+namespace co
+{
+
+namespace
+{
+    using record = std::pair<std::string, std::vector<owner>>;
+
+    /// Write `records` using an `output_writer`, and return the bytes written.
+    std::string written_output(output_format format, const std::vector<record>& records,
+                               std::size_t capacity = output_writer::default_capacity)
+    {
+        temporary_directory_handle temp_dir;
+        const fs::path path = temp_dir / "output";
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        EXPECT_GE(fd, 0);
+        {
+            output_writer writer{fd, format, capacity};
+            for (const auto& [p, owners] : records)
+            {
+                writer.write(p, owners);
+            }
+            writer.flush();
+        }
+        ::close(fd);
+
+        std::ifstream ifs{path.string(), std::ios::binary};
+        std::ostringstream oss;
+        oss << ifs.rdbuf();
+        return oss.str();
+    }
+
+    const std::vector<record> sample_records{
+        {"src/a.cpp", {owner{"@alice"}, owner{"@bob"}}},
+        {"README.md", {}},
+    };
+
+} // end anonymous namespace
+
+TEST(output_format_test, parse_output_format)
+{
+    EXPECT_EQ(parse_output_format("text"), output_format::TEXT);
+    EXPECT_EQ(parse_output_format("tsv"), output_format::TSV);
+    EXPECT_EQ(parse_output_format("jsonl"), output_format::JSONL);
+    EXPECT_EQ(parse_output_format("nul"), output_format::NUL);
+    EXPECT_THROW(parse_output_format("xml"), co::error);
+};
+
+TEST(output_writer_test, text)
+{
+    EXPECT_EQ(written_output(output_format::TEXT, sample_records),
+              "src/a.cpp:    @alice @bob\nREADME.md:    [NO_OWNER]\n");
+};
+
+TEST(output_writer_test, tsv)
+{
+    EXPECT_EQ(written_output(output_format::TSV, sample_records),
+              "src/a.cpp\t@alice @bob\nREADME.md\t\n");
+    EXPECT_EQ(written_output(output_format::TSV, {{"a\tb\\c\n", {owner{"@x"}}}}),
+              "a\\tb\\\\c\\n\t@x\n");
+};
+
+TEST(output_writer_test, jsonl)
+{
+    EXPECT_EQ(written_output(output_format::JSONL, sample_records),
+              "{\"path\":\"src/a.cpp\",\"owners\":[\"@alice\",\"@bob\"]}\n"
+              "{\"path\":\"README.md\",\"owners\":[]}\n");
+    EXPECT_EQ(written_output(output_format::JSONL, {{"q\"\x01.txt", {}}}),
+              "{\"path\":\"q\\\"\\u0001.txt\",\"owners\":[]}\n");
+    // Well-formed UTF-8 is copied, and other bytes are escaped, so the output is valid.
+    const std::string valid = "\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80";
+    EXPECT_EQ(written_output(output_format::JSONL, {{valid, {}}}),
+              "{\"path\":\"" + valid + "\",\"owners\":[]}\n");
+    const std::string invalid = "a\xff\xc3(\xe2\x82\xc0\x80\xed\xa0\x80";
+    EXPECT_EQ(written_output(output_format::JSONL, {{invalid, {}}}),
+              "{\"path\":\"a\\u00ff\\u00c3(\\u00e2\\u0082\\u00c0\\u0080"
+              "\\u00ed\\u00a0\\u0080\",\"owners\":[]}\n");
+};
+
+TEST(output_writer_test, nul)
+{
+    using namespace std::string_literals;
+    EXPECT_EQ(written_output(output_format::NUL, sample_records),
+              "src/a.cpp\0@alice @bob\0README.md\0\0"s);
+};
+
+TEST(output_writer_test, small_buffer)
+{
+    // Records larger than the buffer are written in several pieces.
+    const std::string long_path(1000, 'x');
+    EXPECT_EQ(written_output(output_format::TEXT, {{long_path, {owner{"@alice"}}}},
+                             /*capacity*/ 7),
+              long_path + ":    @alice\n");
+};
+
+TEST(output_writer_test, owner_names)
+{
+    temporary_directory_handle temp_dir;
+    const fs::path path = temp_dir / "output";
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ASSERT_GE(fd, 0);
+    {
+        const std::string_view names[] = {"@alice", "@bob"};
+        output_writer writer{fd, output_format::TEXT};
+        writer.write("src/a.cpp", array_view<std::string_view>{names, 2});
+        writer.write("README.md", array_view<std::string_view>{});
+    }
+    ::close(fd);
+
+    std::ifstream ifs{path.string()};
+    std::ostringstream oss;
+    oss << ifs.rdbuf();
+    EXPECT_EQ(oss.str(), written_output(output_format::TEXT, sample_records));
+};
+
+TEST(output_writer_test, write_error)
+{
+    output_writer writer{-1, output_format::TEXT};
+    writer.write("a", std::vector<owner>{});
+    EXPECT_THROW(writer.flush(), co::error);
+};
+
+TEST(output_writer_test, write_error_on_read_only_descriptor)
+{
+    temporary_directory_handle temp_dir;
+    const fs::path path = temp_dir / "output";
+    ensure_exists(path);
+    int fd = ::open(path.c_str(), O_RDONLY);
+    ASSERT_GE(fd, 0);
+    {
+        // Records that do not fit in the buffer are written while being added.
+        output_writer writer{fd, output_format::TEXT, /*capacity*/ 4};
+        EXPECT_THROW(writer.write("src/a.cpp", std::vector<owner>{}), co::error);
+    }
+    ::close(fd);
+    EXPECT_EQ(fs::file_size(path), 0);
+};
+
+} // end namespace 'co'
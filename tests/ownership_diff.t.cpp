@@ -0,0 +1,225 @@
+#include <codeowners/ownership_diff.hpp>
+
+#include <codeowners/generator.hpp>
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <numeric>
+#include <sstream>
+
+namespace co
+{
+
+namespace
+{
+    annotated_rule make_rule(const char* pat, std::vector<owner> owners)
+    {
+        return annotated_rule{rule_source{"", 0}, {pattern{pat}, std::move(owners)}};
+    }
+
+    ruleset old_ruleset()
+    {
+        return ruleset{std::vector<annotated_rule>{
+            make_rule("*", {owner{"@everyone"}}),
+            make_rule("*.md", {owner{"@writers"}}),
+            make_rule("/src/", {owner{"@developers"}}),
+            make_rule("/docs/", {owner{"@docs"}}),
+            make_rule("/build/", {owner{"@build"}, owner{"@developers"}})}};
+    }
+
+    ruleset new_ruleset()
+    {
+        return ruleset{std::vector<annotated_rule>{
+            make_rule("*", {owner{"@everyone"}}),
+            make_rule("*.md", {owner{"@writers"}}),
+            make_rule("/src/", {owner{"@developers"}}),
+            make_rule("/src/api/", {owner{"@api"}}),                      // added
+            make_rule("/build/", {owner{"@developers"}, owner{"@build"}}), // reordered owners
+            make_rule("/docs/", {owner{"@writers"}})}};                     // changed owners
+    }
+
+    /// Return the paths whose owners differ, found by matching every path against both.
+    std::map<std::string, std::pair<std::optional<ruleset::rule_id>,
+                                    std::optional<ruleset::rule_id>>>
+    naive_changes(const ruleset& old_rules, const ruleset& new_rules,
+                  const std::vector<fs::path>& paths)
+    {
+        const auto owners = [](const ruleset& rules, std::optional<ruleset::rule_id> id) {
+            std::vector<std::string_view> names;
+            if (id)
+            {
+                names = rules.owner_names(*id).to_vector();
+            }
+            std::sort(names.begin(), names.end());
+            names.erase(std::unique(names.begin(), names.end()), names.end());
+            return names;
+        };
+        std::map<std::string, std::pair<std::optional<ruleset::rule_id>,
+                                        std::optional<ruleset::rule_id>>>
+            changes;
+        for (const auto& p : paths)
+        {
+            const auto old_rule = old_rules.find(p);
+            const auto new_rule = new_rules.find(p);
+            if (owners(old_rules, old_rule) != owners(new_rules, new_rule))
+            {
+                changes[p.string()] = {old_rule, new_rule};
+            }
+        }
+        return changes;
+    }
+} // end anonymous namespace
+
+TEST(ownership_diff_test, diff_rules)
+{
+    const rule_diff diff = diff_rules(old_ruleset(), new_ruleset());
+    EXPECT_EQ(diff.removed, (std::vector<ruleset::rule_id>{3, 4}));
+    EXPECT_EQ(diff.added, (std::vector<ruleset::rule_id>{3, 4, 5}));
+
+    const rule_diff same = diff_rules(old_ruleset(), old_ruleset());
+    EXPECT_TRUE(same.removed.empty());
+    EXPECT_TRUE(same.added.empty());
+
+    // Rules that move are removed from their old position and added at their new one.
+    const ruleset a{std::vector<annotated_rule>{make_rule("/a/", {owner{"@a"}}),
+                                                make_rule("/b/", {owner{"@b"}}),
+                                                make_rule("/c/", {owner{"@c"}})}};
+    const ruleset b{std::vector<annotated_rule>{make_rule("/b/", {owner{"@b"}}),
+                                                make_rule("/c/", {owner{"@c"}}),
+                                                make_rule("/a/", {owner{"@a"}})}};
+    const rule_diff moved = diff_rules(a, b);
+    EXPECT_EQ(moved.removed, (std::vector<ruleset::rule_id>{0}));
+    EXPECT_EQ(moved.added, (std::vector<ruleset::rule_id>{2}));
+};
+
+TEST(ownership_diff_test, diff_rules_beyond_edit_limit)
+{
+    // Replacing two large blocks of rules around a common one needs more edits than a
+    // minimal diff is searched for, so every rule between the common leading and trailing
+    // rules is reported, including the common rule in the middle.
+    const auto make_rules = [](const char* prefix) {
+        std::vector<annotated_rule> rules{make_rule("/first/", {owner{"@a"}})};
+        for (int block = 0; block < 2; ++block)
+        {
+            for (int i = 0; i < 400; ++i)
+            {
+                const std::string pat
+                    = "/" + std::string{prefix} + std::to_string(block) + "/" + std::to_string(i);
+                rules.push_back(make_rule(pat.c_str(), {owner{"@a"}}));
+            }
+            if (block == 0)
+            {
+                rules.push_back(make_rule("/middle/", {owner{"@a"}}));
+            }
+        }
+        rules.push_back(make_rule("/last/", {owner{"@a"}}));
+        return rules;
+    };
+    const ruleset old_rules{make_rules("old")};
+    const ruleset new_rules{make_rules("new")};
+
+    const rule_diff diff = diff_rules(old_rules, new_rules);
+    std::vector<ruleset::rule_id> expected(801);
+    std::iota(expected.begin(), expected.end(), ruleset::rule_id{1});
+    EXPECT_EQ(diff.removed, expected);
+    EXPECT_EQ(diff.added, expected);
+};
+
+TEST(ownership_diff_test, compare)
+{
+    const ruleset old_rules = old_ruleset();
+    const ruleset new_rules = new_ruleset();
+    ownership_diff diff{old_rules, new_rules};
+
+    const std::vector<fs::path> paths{"README.md",      "docs/guide.md",  "docs/index.html",
+                                      "src/main.cpp",   "src/api/api.cpp", "build/Makefile",
+                                      "tools/run.sh"};
+    const auto changes = diff.compare(paths.begin(), paths.end());
+    ASSERT_EQ(changes.size(), 3);
+    EXPECT_EQ(changes[0].path, "docs/guide.md");
+    EXPECT_EQ(changes[0].old_rule, std::optional<ruleset::rule_id>{3});
+    EXPECT_EQ(changes[0].new_rule, std::optional<ruleset::rule_id>{5});
+    EXPECT_EQ(changes[1].path, "docs/index.html");
+    EXPECT_EQ(changes[2].path, "src/api/api.cpp");
+
+    // Only the paths matched by a removed or added rule are matched against both versions.
+    EXPECT_EQ(diff.counts().paths, paths.size());
+    EXPECT_EQ(diff.counts().candidates, 4);
+
+    EXPECT_FALSE(diff.may_change_within("tools"));
+    EXPECT_TRUE(diff.may_change_within("src"));
+    EXPECT_TRUE(diff.may_change_within("docs"));
+
+    std::ostringstream oss;
+    write_ownership_changes(oss, diff, changes);
+    EXPECT_EQ(oss.str(), "path\told_owners\tnew_owners\n"
+                         "docs/guide.md\t@docs\t@writers\n"
+                         "docs/index.html\t@docs\t@writers\n"
+                         "src/api/api.cpp\t@developers\t@api\n");
+};
+
+TEST(ownership_diff_test, agrees_with_full_comparison)
+{
+    repository_spec repo_spec;
+    repo_spec.file_count = 5000;
+    codeowners_spec co_spec;
+    co_spec.rule_count = 300;
+    const auto paths = generate_paths(repo_spec);
+    const auto rules = generate_rules(co_spec, paths);
+
+    // Remove, add, and change the owners of rules, in several places.
+    auto edited = rules;
+    edited.erase(edited.begin() + 250);
+    edited.erase(edited.begin() + 40, edited.begin() + 43);
+    edited.insert(edited.begin() + 100, rules[10]);
+    edited[150].rule.owners = {owner{"@new-team"}};
+    edited.push_back(rules[5]);
+
+    const ruleset old_rules{rules};
+    const ruleset new_rules{edited};
+    ownership_diff diff{old_rules, new_rules};
+    const auto changes = diff.compare(paths.begin(), paths.end());
+
+    const auto expected = naive_changes(old_rules, new_rules, paths);
+    ASSERT_EQ(changes.size(), expected.size());
+    for (const auto& change : changes)
+    {
+        const auto it = expected.find(change.path);
+        ASSERT_NE(it, expected.end()) << change.path;
+        EXPECT_EQ(change.old_rule, it->second.first) << change.path;
+        EXPECT_EQ(change.new_rule, it->second.second) << change.path;
+    }
+    EXPECT_LT(diff.counts().candidates, paths.size());
+};
+
+TEST(ownership_diff_test, find_ownership_changes)
+{
+    temporary_directory_handle temp_dir;
+    for (const auto& dir : {"src/api", "docs", "tools", "external/module"})
+    {
+        fs::create_directories(temp_dir / dir);
+    }
+    for (const auto& file : {"README.md", "src/main.cpp", "src/api/api.cpp", "docs/index.md",
+                             "tools/run.sh", "external/module/x.md"})
+    {
+        ensure_exists(temp_dir / file);
+    }
+    const ruleset old_rules = old_ruleset();
+    const ruleset new_rules = new_ruleset();
+    ownership_diff diff{old_rules, new_rules};
+    const std::vector<fs::path> to_skip{temp_dir / "external/module"};
+
+    const auto changes = find_ownership_changes(diff, temp_dir, temp_dir, to_skip);
+    std::vector<std::string> changed;
+    for (const auto& change : changes)
+    {
+        changed.push_back(change.path);
+    }
+    std::sort(changed.begin(), changed.end());
+    EXPECT_EQ(changed, (std::vector<std::string>{"docs/index.md", "src/api/api.cpp"}));
+    // Files in directories where no changed rule can match are not compared.
+    EXPECT_LT(diff.counts().paths, 5);
+};
+
+} // end namespace 'co'
@@ -0,0 +1,107 @@
+#include <codeowners/ownership_index.hpp>
+
+#include <codeowners/errors.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace co
+{
+
+namespace
+{
+    ruleset sample_ruleset()
+    {
+        rule_source src{"", 0};
+        return ruleset{std::vector<annotated_rule>{
+            {src, {pattern{"*.cpp"}, {owner{"@alice"}}}},
+            {src, {pattern{"/docs/"}, {owner{"@bob"}}}},
+            {src, {pattern{"*.md"}, {owner{"@alice"}, owner{"@bob"}}}},
+            {src, {pattern{"/third_party/"}, {}}}}};
+    }
+
+    std::vector<std::string> paths_of(const ownership_index& index,
+                                      const std::vector<ownership_index::path_id>& ids)
+    {
+        std::vector<std::string> paths;
+        for (const auto id : ids)
+        {
+            paths.emplace_back(index.path(id));
+        }
+        return paths;
+    }
+
+    const std::vector<fs::path> sample_paths{
+        "README.md",
+        "docs/guide.md",
+        "docs/index.html",
+        "src/main.cpp",
+        "src/util.cpp",
+        "src/util.hpp",
+        "third_party/lib.cpp",
+    };
+} // end anonymous namespace
+
+TEST(ownership_index_test, rule_files)
+{
+    const ruleset rules = sample_ruleset();
+    const ownership_index index{rules, sample_paths.begin(), sample_paths.end()};
+    ASSERT_EQ(index.size(), sample_paths.size());
+
+    EXPECT_EQ(index.rule_files(0), (std::vector<ownership_index::path_id>{3, 4}));
+    EXPECT_EQ(index.rule_files(1), (std::vector<ownership_index::path_id>{2}));
+    EXPECT_EQ(index.rule_files(2), (std::vector<ownership_index::path_id>{0, 1}));
+    EXPECT_EQ(index.rule_files(3), (std::vector<ownership_index::path_id>{6}));
+    EXPECT_EQ(index.path(1), "docs/guide.md");
+    EXPECT_EQ(index.rule(1), std::optional<ruleset::rule_id>{2});
+    EXPECT_EQ(index.rule(5), std::nullopt);
+};
+
+TEST(ownership_index_test, files_owned_by)
+{
+    const ruleset rules = sample_ruleset();
+    const ownership_index index{rules, sample_paths.begin(), sample_paths.end()};
+
+    EXPECT_EQ(paths_of(index, index.files_owned_by("@alice")),
+              (std::vector<std::string>{"README.md", "docs/guide.md", "src/main.cpp",
+                                        "src/util.cpp"}));
+    EXPECT_EQ(paths_of(index, index.files_owned_by("@bob")),
+              (std::vector<std::string>{"README.md", "docs/guide.md", "docs/index.html"}));
+    EXPECT_EQ(index.files_owned_by("@bob"), index.files_owned_by(ruleset::owner_id{1}));
+    EXPECT_TRUE(index.files_owned_by("@carol").empty());
+    EXPECT_EQ(paths_of(index, index.unowned_files()),
+              (std::vector<std::string>{"src/util.hpp", "third_party/lib.cpp"}));
+};
+
+TEST(ownership_index_test, files_owned_by_any)
+{
+    const ruleset rules = sample_ruleset();
+    const ownership_index index{rules, sample_paths.begin(), sample_paths.end()};
+
+    // Files of rules naming both owners, or an owner named twice, are returned once.
+    EXPECT_EQ(paths_of(index, index.files_owned_by_any({"@bob", "@alice", "@alice"})),
+              (std::vector<std::string>{"README.md", "docs/guide.md", "docs/index.html",
+                                        "src/main.cpp", "src/util.cpp"}));
+    EXPECT_EQ(index.files_owned_by_any({"@bob", "@carol"}), index.files_owned_by("@bob"));
+    EXPECT_TRUE(index.files_owned_by_any({}).empty());
+};
+
+TEST(ownership_index_test, incremental)
+{
+    const ruleset rules = sample_ruleset();
+    ownership_index index{rules};
+    for (const auto& p : sample_paths)
+    {
+        index.add(p.native(), rules.find(p));
+    }
+    const ownership_index expected{rules, sample_paths.begin(), sample_paths.end()};
+    for (ruleset::rule_id id = 0; id < rules.size(); ++id)
+    {
+        EXPECT_EQ(index.rule_files(id), expected.rule_files(id));
+    }
+    EXPECT_THROW(index.rule_files(rules.size()), std::out_of_range);
+};
+
+} // end namespace 'co'
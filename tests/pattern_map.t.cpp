@@ -1,5 +1,7 @@
 #include <src/pattern_map.hpp>
 
+#include <codeowners/errors.hpp>
+
 #include <gtest/gtest.h>
 
 namespace co
@@ -16,6 +18,23 @@ TEST(pattern_map_test, construction)
     EXPECT_EQ(p_map.size(), 2);
 }
 
+TEST(pattern_map_test, construction_from_compiled_patterns)
+{
+    const std::vector<std::pair<const pattern, int>> items{
+        {pattern{"*"}, 0}, {pattern{"*.cpp"}, 1}, {pattern{"*"}, 2}};
+    std::vector<compiled_pattern> compiled;
+    for (const auto& item : items)
+    {
+        compiled.emplace_back(item.first);
+    }
+    pattern_map<int> p_map{items, std::move(compiled)};
+    EXPECT_EQ(p_map.size(), 2);
+    EXPECT_EQ(p_map["a.cpp"], 1);
+    EXPECT_EQ(p_map["a.hpp"], 0);
+
+    EXPECT_THROW((pattern_map<int>{items, {}}), std::invalid_argument);
+};
+
 TEST(pattern_map_test, repeated_insert)
 {
     pattern_map<int> p_map;
@@ -76,4 +95,114 @@ TEST(pattern_map_test, contains)
     EXPECT_FALSE(p_map.contains("nonmatching.cpp"));
 };
 
+TEST(pattern_map_test, last_match_takes_precedence)
+{
+    pattern_map<int> p_map{{pattern{"*"}, 0}, {pattern{"/src/"}, 1}, {pattern{"*.cpp"}, 2}};
+    EXPECT_EQ(p_map["README.md"], 0);
+    EXPECT_EQ(p_map["src/README.md"], 1);
+    EXPECT_EQ(p_map["src/a.cpp"], 2);
+    EXPECT_EQ(p_map["a.cpp"], 2);
+};
+
+TEST(pattern_map_test, find_within)
+{
+    pattern_map<int> p_map{{pattern{"*.md"}, 0}, {pattern{"/third_party/"}, 1}};
+
+    auto result = p_map.find_within("third_party/lib");
+    ASSERT_TRUE(result);
+    ASSERT_NE(*result, p_map.end());
+    EXPECT_EQ((*result)->second, 1);
+
+    // Files in `src` may or may not match `*.md`.
+    EXPECT_FALSE(p_map.find_within("src"));
+
+    pattern_map<int> anchored_map{{pattern{"/docs/*.md"}, 0}};
+    auto unmatched = anchored_map.find_within("src");
+    ASSERT_TRUE(unmatched);
+    EXPECT_EQ(*unmatched, anchored_map.end());
+};
+
+TEST(pattern_map_test, directory_cache)
+{
+    pattern_map<int> p_map{{pattern{"/src/"}, 0}, {pattern{"*.cpp"}, 1}, {pattern{"/src/gen/"}, 2}};
+
+    EXPECT_EQ(p_map["src/a.hpp"], 0);
+    EXPECT_EQ(p_map["src/a.cpp"], 1);
+    EXPECT_EQ(p_map["src/gen/a.cpp"], 2);
+    EXPECT_EQ(p_map["src/gen/b.cpp"], 2);
+    EXPECT_EQ(p_map["src/b.hpp"], 0);
+    EXPECT_FALSE(p_map.contains("a.hpp"));
+    EXPECT_EQ(p_map["a.cpp"], 1);
+
+    auto stats = p_map.directory_cache_statistics();
+    EXPECT_EQ(stats.misses, 3u); // `src`, `src/gen` and the root directory
+    EXPECT_EQ(stats.hits, 4u);
+
+    // Inserting a pattern invalidates cached results.
+    p_map.insert({pattern{"/src/*/"}, 3});
+    EXPECT_EQ(p_map["src/gen/a.cpp"], 3);
+    EXPECT_EQ(p_map.directory_cache_statistics().misses, 4u);
+
+    // A copy shares the patterns but has its own, empty cache.
+    const pattern_map<int> copy{p_map};
+    EXPECT_EQ(copy.directory_cache_statistics().misses, 0u);
+    EXPECT_EQ(copy["src/gen/a.cpp"], 3);
+    EXPECT_EQ(copy.directory_cache_statistics().misses, 1u);
+    EXPECT_EQ(p_map.directory_cache_statistics().misses, 4u);
+};
+
+TEST(pattern_map_test, iteration_in_pattern_order)
+{
+    pattern_map<int> p_map{
+        {pattern{"b"}, 0}, {pattern{"c"}, 1}, {pattern{"a"}, 2}, {pattern{"b"}, 3}};
+    ASSERT_EQ(p_map.size(), 3u);
+
+    std::vector<std::pair<std::string, int>> entries;
+    for (const auto& [pat, value] : p_map)
+    {
+        entries.emplace_back(pat.value(), value);
+    }
+    EXPECT_EQ(entries, (std::vector<std::pair<std::string, int>>{{"a", 2}, {"b", 0}, {"c", 1}}));
+
+    // Precedence follows insertion order, not pattern order.
+    EXPECT_EQ(p_map["x/a"], 2);
+};
+
+TEST(pattern_map_test, copies_are_independent)
+{
+    pattern_map<int> original{{pattern{"*.hpp"}, 0}};
+    pattern_map<int> copy{original};
+    EXPECT_EQ(copy["a.hpp"], 0);
+
+    copy[pattern{"*.hpp"}] = 1;
+    copy.insert({pattern{"*.cpp"}, 2});
+    EXPECT_EQ(copy["a.hpp"], 1);
+    EXPECT_EQ(copy["a.cpp"], 2);
+
+    EXPECT_EQ(original.size(), 1u);
+    EXPECT_EQ(original["a.hpp"], 0);
+    EXPECT_FALSE(original.contains("a.cpp"));
+};
+
+TEST(pattern_map_test, invalid_pattern_in_range)
+{
+    std::string too_long;
+    for (int i = 0; i < 100; ++i)
+    {
+        too_long += "/a";
+    }
+    const std::vector<std::pair<const pattern, int>> items{{pattern{"*.hpp"}, 0},
+                                                           {pattern{"*.hpp"}, 1},
+                                                           {pattern{too_long}, 2},
+                                                           {pattern{"*.cpp"}, 3}};
+
+    pattern_map<int> p_map;
+    EXPECT_THROW(p_map.insert(items.begin(), items.end()), co::error);
+
+    // Entries before the invalid pattern are retained.
+    EXPECT_EQ(p_map.size(), 1u);
+    EXPECT_EQ(p_map["a.hpp"], 0);
+    EXPECT_FALSE(p_map.contains("a.cpp"));
+};
+
 } // end namespace 'co'
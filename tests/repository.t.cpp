@@ -9,6 +9,8 @@
 
 #include <boost/process.hpp>
 
+#include <fstream>
+
 namespace co
 {
 
@@ -91,6 +93,33 @@ TEST(repository_submodule_paths, submodule_paths)
     EXPECT_PATHS_EQUIVALENT(nonwork_paths[1], temp_dir / "external/sanitizers-cmake");
 };
 
+TEST(read_blob_test, revisions)
+{
+    temporary_directory_handle temp_dir;
+    auto git = git_invoker(temp_dir);
+    git("init");
+    const auto write = [&](const char* text) {
+        std::ofstream os{(temp_dir / "CODEOWNERS").string()};
+        os << text;
+    };
+    // Commits need an identity, which the environment may not configure.
+    const auto commit = [&](auto... args) {
+        git("-c", "user.name=codeowners", "-c", "user.email=codeowners@example.com", "commit",
+            args...);
+    };
+    write("* @old\n");
+    git("add", "CODEOWNERS");
+    commit("-m", "Add CODEOWNERS");
+    write("* @new\n");
+    commit("-a", "-m", "Change CODEOWNERS");
+
+    repository repo = repository::open(temp_dir);
+    EXPECT_EQ(repo.read_blob("HEAD:CODEOWNERS"), "* @new\n");
+    EXPECT_EQ(repo.read_blob("HEAD~1:CODEOWNERS"), "* @old\n");
+    EXPECT_THROW(repo.read_blob("HEAD:missing"), error);
+    EXPECT_THROW(repo.read_blob("HEAD"), error);
+};
+
 TEST(repository_submodule_paths, codeowners_path)
 {
     temporary_directory_handle temp_dir;
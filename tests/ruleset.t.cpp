@@ -1,7 +1,12 @@
 #include <codeowners/ruleset.hpp>
+#include <codeowners/errors.hpp>
+#include <codeowners/generator.hpp>
+#include <codeowners/instrumentation.hpp>
 
 #include <gtest/gtest.h>
 
+#include <sstream>
+
 namespace co
 {
 
@@ -20,4 +25,413 @@ TEST(parser, ruleset)
     EXPECT_EQ(*result, arules.front());
 };
 
+TEST(ruleset_test, rule_and_owner_ids)
+{
+    rule_source src{"", 0};
+    std::vector<annotated_rule> arules{
+        {src, {pattern{"*.hpp"}, {owner{"@alice"}, owner{"@bob"}}}},
+        {src, {pattern{"*.cpp"}, {owner{"@bob"}}}},
+        {src, {pattern{"*.hpp"}, {owner{"@carol"}}}}};
+
+    ruleset rset{arules};
+    EXPECT_EQ(rset.size(), 3);
+    EXPECT_EQ(rset.find("hello.cpp"), std::optional<ruleset::rule_id>{1});
+    EXPECT_EQ(rset.rule(1), arules[1]);
+    EXPECT_FALSE(rset.find("hello.txt"));
+
+    // The last occurrence of a repeated pattern takes precedence.
+    EXPECT_EQ(rset.find("hello.hpp"), std::optional<ruleset::rule_id>{2});
+    // Shadowed rules, whose patterns are not matched, are kept too.
+    EXPECT_EQ(rset.rule(0), arules[0]);
+    EXPECT_EQ(rset.rule(2), arules[2]);
+
+    EXPECT_EQ(rset.owners().to_vector(),
+              (std::vector<std::string_view>{"@alice", "@bob", "@carol"}));
+    EXPECT_EQ(rset.owner_ids(0).to_vector(), (std::vector<ruleset::owner_id>{0, 1}));
+    EXPECT_EQ(rset.owner_ids(1).to_vector(), (std::vector<ruleset::owner_id>{1}));
+    EXPECT_EQ(rset.owner_ids(2).to_vector(), (std::vector<ruleset::owner_id>{2}));
+    EXPECT_EQ(rset.owner_names(0).to_vector(),
+              (std::vector<std::string_view>{"@alice", "@bob"}));
+    EXPECT_THROW(rset.rule(3), std::out_of_range);
+};
+
+TEST(ruleset_test, move)
+{
+    rule_source src{"", 0};
+    std::vector<annotated_rule> arules{{src, {pattern{"*.hpp"}, {owner{"@alice"}}}}};
+
+    ruleset rset{arules};
+    ruleset moved{std::move(rset)};
+    EXPECT_EQ(moved.find("hello.hpp"), std::optional<ruleset::rule_id>{0});
+    EXPECT_EQ(moved.owner_names(0).to_vector(), (std::vector<std::string_view>{"@alice"}));
+
+    ruleset assigned{std::vector<annotated_rule>{}};
+    assigned = std::move(moved);
+    EXPECT_EQ(assigned.size(), 1);
+    EXPECT_EQ(assigned.rule(0), arules[0]);
+};
+
+TEST(ruleset_test, find_subtree)
+{
+    rule_source src{"", 0};
+    std::vector<annotated_rule> arules{
+        {src, {pattern{"*"}, {owner{"@everyone"}}}},
+        {src, {pattern{"/src/"}, {owner{"@developers"}}}},
+        {src, {pattern{"/src/*.md"}, {owner{"@writers"}}}},
+        {src, {pattern{"/third_party/"}, {owner{"@legal"}}}}};
+    ruleset rset{arules};
+
+    auto third_party = rset.find_subtree("third_party/lib");
+    EXPECT_TRUE(third_party.determined);
+    EXPECT_EQ(third_party.rule, std::optional<ruleset::rule_id>{3});
+
+    // Files directly within `src` may match `/src/*.md`, but files in subdirectories cannot.
+    EXPECT_FALSE(rset.find_subtree("src").determined);
+    auto src_lib = rset.find_subtree("src/lib");
+    EXPECT_TRUE(src_lib.determined);
+    EXPECT_EQ(src_lib.rule, std::optional<ruleset::rule_id>{1});
+
+    auto docs = rset.find_subtree("docs");
+    EXPECT_TRUE(docs.determined);
+    EXPECT_EQ(docs.rule, std::optional<ruleset::rule_id>{0});
+
+    ruleset partial{std::vector<annotated_rule>{arules.begin() + 1, arules.end()}};
+    auto unowned = partial.find_subtree("docs");
+    EXPECT_TRUE(unowned.determined);
+    EXPECT_FALSE(unowned.rule);
+};
+
+TEST(ruleset_test, cursor)
+{
+    rule_source src{"", 0};
+    std::vector<annotated_rule> arules{
+        {src, {pattern{"*"}, {owner{"@everyone"}}}},
+        {src, {pattern{"/src/"}, {owner{"@developers"}}}},
+        {src, {pattern{"*.md"}, {owner{"@writers"}}}},
+        {src, {pattern{"/third_party/"}, {owner{"@legal"}}}}};
+    ruleset rset{arules};
+
+    ruleset::cursor cursor{rset};
+    for (const char* path : {"README.md", "src/a/b.cpp", "src/a/c.md", "src/a/d.cpp",
+                             "src/e.cpp", "third_party/x/y.md", "third_party/z.c"})
+    {
+        EXPECT_EQ(cursor.find(path), rset.find(path)) << "path: " << path;
+    }
+
+    auto third_party = cursor.find_subtree("third_party/x");
+    EXPECT_TRUE(third_party.determined);
+    EXPECT_EQ(third_party.rule, std::optional<ruleset::rule_id>{3});
+    EXPECT_FALSE(cursor.find_subtree("src").determined);
+};
+
+TEST(ruleset_test, cursor_find_all)
+{
+    rule_source src{"", 0};
+    const ruleset rset{std::vector<annotated_rule>{
+        {src, {pattern{"*"}, {owner{"@everyone"}}}},
+        {src, {pattern{"/src/"}, {owner{"@developers"}}}},
+        {src, {pattern{"*.md"}, {owner{"@writers"}}}},
+        {src, {pattern{"/third_party/"}, {owner{"@legal"}}}},
+        {src, {pattern{"/third_party/*.c"}, {owner{"@legal"}}}}}};
+
+    ruleset::cursor cursor{rset, ruleset::match_mode::ALL};
+    std::vector<ruleset::rule_id> matching;
+    EXPECT_EQ(cursor.find_all("src/a/c.md", matching), std::optional<ruleset::rule_id>{2});
+    EXPECT_EQ(matching, (std::vector<ruleset::rule_id>{0, 1, 2}));
+    EXPECT_EQ(cursor.find_all("src/a/d.cpp", matching), std::optional<ruleset::rule_id>{1});
+    EXPECT_EQ(matching, (std::vector<ruleset::rule_id>{0, 1}));
+    EXPECT_EQ(cursor.find_all("third_party/z.c", matching), std::optional<ruleset::rule_id>{4});
+    EXPECT_EQ(matching, (std::vector<ruleset::rule_id>{0, 3, 4}));
+    // Other lookups give the same results as with a default cursor.
+    EXPECT_EQ(cursor.find("third_party/x/y.md"), std::optional<ruleset::rule_id>{3});
+    EXPECT_FALSE(cursor.find_subtree("third_party/x").determined);
+
+    ruleset::cursor last_cursor{rset};
+    EXPECT_THROW(last_cursor.find_all("README.md", matching), error);
+};
+
+TEST(ruleset_test, cursor_find_all_nested_directories)
+{
+    // Unanchored directory patterns, which are kept below later anchored ones, must not take
+    // precedence over them in deeper directories.
+    rule_source src{"", 0};
+    const ruleset rset{std::vector<annotated_rule>{
+        {src, {pattern{"b/"}, {owner{"@b"}}}},
+        {src, {pattern{"/a/"}, {owner{"@a"}}}},
+        {src, {pattern{"c/"}, {owner{"@c"}}}},
+        {src, {pattern{"/a/b/c/d/"}, {owner{"@d"}}}}}};
+
+    ruleset::cursor all_cursor{rset, ruleset::match_mode::ALL};
+    std::vector<ruleset::rule_id> matching;
+    for (const char* dir : {"a", "a/b", "a/b/c", "a/b/c/d", "a/b/c/d/b", "b", "b/a", "x/b/c"})
+    {
+        const std::string path = std::string{dir} + "/x.txt";
+        EXPECT_EQ(all_cursor.find(path), rset.find(path)) << "path: " << path;
+        EXPECT_EQ(all_cursor.find_all(path, matching), rset.find(path)) << "path: " << path;
+        const ruleset::subtree_match subtree = all_cursor.find_subtree(dir);
+        if (subtree.determined)
+        {
+            EXPECT_EQ(subtree.rule, rset.find(path)) << "dir: " << dir;
+        }
+    }
+};
+
+TEST(ruleset_test, cursor_find_all_generated)
+{
+    repository_spec repo_spec;
+    repo_spec.file_count = 2000;
+    codeowners_spec co_spec;
+    co_spec.rule_count = 200;
+    const auto paths = generate_paths(repo_spec);
+    const auto rules = generate_rules(co_spec, paths);
+    const ruleset rset{rules};
+
+    ASSERT_FALSE(rset.shadowed_rules().empty());
+    // Each rule is matched alone, by a ruleset holding only that rule.
+    std::vector<ruleset> single_rules;
+    for (const annotated_rule& rule : rules)
+    {
+        single_rules.emplace_back(std::vector<annotated_rule>{rule});
+    }
+
+    ruleset::cursor cursor{rset, ruleset::match_mode::ALL};
+    std::vector<ruleset::rule_id> matching;
+    for (const auto& path : paths)
+    {
+        std::vector<ruleset::rule_id> expected;
+        for (ruleset::rule_id id = 0; id < rset.size(); ++id)
+        {
+            if (single_rules[id].find(path))
+            {
+                expected.push_back(id);
+            }
+        }
+        EXPECT_EQ(cursor.find_all(path, matching), rset.find(path)) << "path: " << path;
+        EXPECT_EQ(matching, expected) << "path: " << path;
+    }
+};
+
+TEST(ruleset_test, overlapping_rules)
+{
+    rule_source src{"", 0};
+    const ruleset rset{std::vector<annotated_rule>{
+        {src, {pattern{"*"}, {owner{"@everyone"}}}},                 // 0
+        {src, {pattern{"/services/billing/"}, {owner{"@billing"}}}}, // 1
+        {src, {pattern{"/services/*/web/"}, {owner{"@web"}}}},       // 2
+        {src, {pattern{"*.md"}, {owner{"@writers"}}}},               // 3
+        {src, {pattern{"/docs/"}, {owner{"@docs"}}}}}};              // 4
+
+    EXPECT_EQ(rset.overlapping_rules(pattern{"/services/*/api/**"}),
+              (std::vector<ruleset::rule_id>{0, 1, 3}));
+    EXPECT_EQ(rset.overlapping_rules(pattern{"/docs/*.txt"}),
+              (std::vector<ruleset::rule_id>{0, 4}));
+    EXPECT_EQ(rset.overlapping_rules(pattern{"README.md"}),
+              (std::vector<ruleset::rule_id>{0, 1, 2, 3, 4}));
+};
+
+TEST(ruleset_test, shadowed_rules)
+{
+    rule_source src{"", 0};
+    std::vector<annotated_rule> arules{
+        {src, {pattern{"/docs/*.md"}, {owner{"@writers"}}}},    // 0: shadowed by 3
+        {src, {pattern{"*.md"}, {owner{"@writers"}}}},          // 1: shadowed by 5
+        {src, {pattern{"/docs/a/"}, {owner{"@a"}}}},            // 2: shadowed by 3
+        {src, {pattern{"/docs/"}, {owner{"@docs"}}}},           // 3
+        {src, {pattern{"/docs/b"}, {owner{"@b"}}}},             // 4
+        {src, {pattern{"*.md"}, {owner{"@editors"}}}},          // 5
+        {src, {pattern{"/src/"}, {owner{"@developers"}}}},      // 6: shadowed by 8
+        {src, {pattern{"/src/*.cpp"}, {owner{"@developers"}}}}, // 7: shadowed by 8
+        {src, {pattern{"*"}, {owner{"@everyone"}}}},            // 8
+        {src, {pattern{"/third_party/"}, {owner{"@vendors"}}}}, // 9
+        {src, {pattern{"/third_party/**"}, {owner{"@legal"}}}}, // 10
+        {src, {pattern{"third_party/x"}, {owner{"@x"}}}},       // 11
+        {src, {pattern{"/tools/"}, {owner{"@tools"}}}},         // 12
+        {src, {pattern{"/tools"}, {owner{"@tools"}}}}};         // 13
+
+    ruleset rset{arules};
+    const auto& shadowed = rset.shadowed_rules();
+    std::vector<std::pair<ruleset::rule_id, ruleset::rule_id>> pairs;
+    for (const auto& s : shadowed)
+    {
+        pairs.emplace_back(s.id, s.shadowed_by);
+    }
+    EXPECT_EQ(pairs, (std::vector<std::pair<ruleset::rule_id, ruleset::rule_id>>{
+                         {0, 3}, {1, 5}, {2, 3}, {3, 8}, {4, 8}, {5, 8}, {6, 8}, {7, 8},
+                         {9, 10}, {12, 13}}));
+
+    // Shadowed rules remain accessible, and lookups are unchanged.
+    EXPECT_EQ(rset.size(), arules.size());
+    EXPECT_EQ(rset.rule(0), arules[0]);
+    EXPECT_EQ(rset.find("docs/a/b.md"), std::optional<ruleset::rule_id>{8});
+    EXPECT_EQ(rset.find("third_party/y"), std::optional<ruleset::rule_id>{10});
+    EXPECT_EQ(rset.find("third_party/x"), std::optional<ruleset::rule_id>{11});
+    EXPECT_EQ(rset.find("tools"), std::optional<ruleset::rule_id>{13});
+};
+
+/// A directory-only rule does not shadow an earlier rule that matches a file of the same
+/// name, and rules are not shadowed by earlier rules.
+TEST(ruleset_test, rules_not_shadowed)
+{
+    rule_source src{"", 0};
+    std::vector<annotated_rule> arules{{src, {pattern{"/docs/"}, {owner{"@docs"}}}},
+                                       {src, {pattern{"/docs/*.md"}, {owner{"@writers"}}}},
+                                       {src, {pattern{"/tools"}, {owner{"@tools"}}}},
+                                       {src, {pattern{"/tools/"}, {owner{"@tools"}}}},
+                                       {src, {pattern{"docs/*.txt"}, {owner{"@writers"}}}},
+                                       {src, {pattern{"/a/*/b"}, {owner{"@a"}}}},
+                                       {src, {pattern{"/a/*"}, {owner{"@a"}}}}};
+    ruleset rset{arules};
+    EXPECT_TRUE(rset.shadowed_rules().empty());
+    EXPECT_EQ(rset.find("tools"), std::optional<ruleset::rule_id>{2});
+};
+
+/// Rules whose patterns have too many segments to be compiled are skipped, and reported,
+/// instead of failing the whole ruleset.
+TEST(ruleset_test, skipped_rules)
+{
+    std::string deep;
+    for (int i = 0; i < 64; ++i)
+    {
+        deep += "/d";
+    }
+    rule_source src{"CODEOWNERS", 0};
+    std::vector<annotated_rule> arules{{src, {pattern{"/d/"}, {owner{"@d"}}}},
+                                       {src, {pattern{deep}, {owner{"@deep"}}}},
+                                       {src, {pattern{"*.md"}, {owner{"@writers"}}}}};
+    ruleset rset{arules};
+    const auto& skipped = rset.skipped_rules();
+    ASSERT_EQ(skipped.size(), 1);
+    EXPECT_EQ(skipped[0].id, 1);
+    EXPECT_NE(skipped[0].reason.find("too many path segments"), std::string::npos);
+
+    // The skipped rule remains accessible, and matches nothing.
+    EXPECT_EQ(rset.rule(1), arules[1]);
+    EXPECT_EQ(rset.find(deep.substr(1)), std::optional<ruleset::rule_id>{0});
+    EXPECT_EQ(rset.find(deep.substr(1) + "/x"), std::optional<ruleset::rule_id>{0});
+    EXPECT_EQ(rset.find(deep.substr(1) + "/x.md"), std::optional<ruleset::rule_id>{2});
+    EXPECT_EQ(rset.find_subtree("d").determined, false);
+};
+
+/// Rulesets compiled in shards on several threads give the same results as rulesets
+/// compiled on one thread.
+TEST(ruleset_test, compile_threads)
+{
+    repository_spec repo_spec;
+    repo_spec.file_count = 2000;
+    codeowners_spec co_spec;
+    co_spec.rule_count = 20000;
+    const auto paths = generate_paths(repo_spec);
+    std::vector<annotated_rule> rules = generate_rules(co_spec, paths);
+
+    const ruleset serial{rules, 1};
+    const ruleset sharded{rules, 4};
+    ASSERT_EQ(sharded.size(), serial.size());
+    ASSERT_EQ(sharded.shadowed_rules().size(), serial.shadowed_rules().size());
+    for (std::size_t i = 0; i < serial.shadowed_rules().size(); ++i)
+    {
+        EXPECT_EQ(sharded.shadowed_rules()[i].id, serial.shadowed_rules()[i].id);
+    }
+    for (const auto& p : paths)
+    {
+        EXPECT_EQ(sharded.find(p), serial.find(p)) << p;
+    }
+
+    // A pattern that cannot be compiled, in any shard, is reported.
+    std::string deep;
+    for (int i = 0; i < 100; ++i)
+    {
+        deep += "/a";
+    }
+    rules[rules.size() / 4].rule.file_pattern = pattern{deep};
+    rules[rules.size() * 3 / 4].rule.file_pattern = pattern{deep};
+    const ruleset with_skipped{rules, 4};
+    ASSERT_EQ(with_skipped.skipped_rules().size(), 2);
+    EXPECT_EQ(with_skipped.skipped_rules()[0].id, rules.size() / 4);
+    EXPECT_EQ(with_skipped.skipped_rules()[1].id, rules.size() * 3 / 4);
+};
+
+#if CODEOWNERS_INSTRUMENTATION
+
+TEST(ruleset_test, profile)
+{
+    std::vector<annotated_rule> arules{
+        {rule_source{"CODEOWNERS", 10}, {pattern{"*"}, {owner{"@everyone"}}}},
+        {rule_source{"CODEOWNERS", 20}, {pattern{"*.md"}, {owner{"@writers"}}}},
+        {rule_source{"CODEOWNERS", 5}, {pattern{"/docs/"}, {owner{"@docs"}}}},
+        {rule_source{"CODEOWNERS", 30}, {pattern{"*.md"}, {owner{"@editors"}}}}};
+    ruleset rset{arules};
+    EXPECT_TRUE(rset.profile().empty());
+
+    ASSERT_TRUE(rset.enable_profiling());
+    EXPECT_EQ(rset.find("README.md"), std::optional<ruleset::rule_id>{3});
+    EXPECT_EQ(rset.find("src/a.cpp"), std::optional<ruleset::rule_id>{0});
+    ruleset::cursor cursor{rset};
+    EXPECT_EQ(cursor.find("docs/b.txt"), std::optional<ruleset::rule_id>{2});
+    EXPECT_EQ(cursor.find("c.md"), std::optional<ruleset::rule_id>{3});
+
+    // Rules are in order of source line.  The first rule for `*.md` is shadowed by the
+    // second, so it is never evaluated.
+    const std::vector<ruleset::rule_profile> profile = rset.profile();
+    ASSERT_EQ(profile.size(), 4);
+    EXPECT_EQ(profile[0].id, 2);
+    EXPECT_EQ(profile[1].id, 0);
+    EXPECT_EQ(profile[2].id, 1);
+    EXPECT_EQ(profile[3].id, 3);
+    EXPECT_EQ(profile[0].wins, 1);
+    EXPECT_EQ(profile[1].wins, 1);
+    EXPECT_EQ(profile[2].wins, 0);
+    EXPECT_EQ(profile[3].wins, 2);
+    for (std::size_t i : {0, 1, 3})
+    {
+        EXPECT_GT(profile[i].evaluations, 0) << "rule: " << profile[i].id;
+    }
+    EXPECT_EQ(profile[2].evaluations, 0);
+    EXPECT_EQ(profile[2].time.count(), 0);
+
+    rset.enable_profiling(false);
+    EXPECT_TRUE(rset.profile().empty());
+};
+
+#endif
+
+TEST(ruleset_test, write_rule_profile)
+{
+    rule_source src{"", 0};
+    const ruleset rules{std::vector<annotated_rule>{{src, {pattern{"*.hpp"}, {owner{"@alice"}}}},
+                                                    {src, {pattern{"*.cpp"}, {owner{"@bob"}}}},
+                                                    {src, {pattern{"*.txt"}, {}}}}};
+    const std::vector<ruleset::rule_profile> profile{
+        {2, 3, 0, std::chrono::nanoseconds{500}}, {0, 7, 2, std::chrono::microseconds{12}}};
+
+    std::ostringstream oss;
+    write_rule_profile(oss, rules, profile);
+    EXPECT_EQ(oss.str(), "line\tpattern\tevaluations\twins\ttime_us\n"
+                         "0\t*.txt\t3\t0\t0.500\n"
+                         "0\t*.hpp\t7\t2\t12.000\n");
+};
+
+TEST(ruleset_test, write_shadowed_rules)
+{
+    const ruleset rules{std::vector<annotated_rule>{
+        {rule_source{"CODEOWNERS", 1}, {pattern{"/docs/*.md"}, {owner{"@writers"}}}},
+        {rule_source{"CODEOWNERS", 2}, {pattern{"/docs/"}, {owner{"@docs"}}}}}};
+
+    std::ostringstream oss;
+    write_shadowed_rules(oss, rules);
+    EXPECT_EQ(oss.str(), "line\tpattern\tshadowed_by_line\tshadowed_by_pattern\n"
+                         "1\t/docs/*.md\t2\t/docs/\n");
+};
+
+TEST(ruleset_test, write_overlapping_rules)
+{
+    const ruleset rules{std::vector<annotated_rule>{
+        {rule_source{"CODEOWNERS", 1}, {pattern{"/docs/*.md"}, {owner{"@writers"}}}},
+        {rule_source{"CODEOWNERS", 2}, {pattern{"/src/"}, {owner{"@a"}, owner{"@b"}}}}}};
+
+    std::ostringstream oss;
+    write_overlapping_rules(oss, rules, pattern{"/src/**/*.cpp"});
+    EXPECT_EQ(oss.str(), "line\tpattern\towners\n"
+                         "2\t/src/\t@a @b\n");
+};
+
 } /* end namespace 'co' */
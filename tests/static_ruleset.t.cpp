@@ -0,0 +1,98 @@
+#include <codeowners/static_ruleset.hpp>
+
+#include <src/compiled_pattern.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace co
+{
+
+namespace
+{
+    const std::vector<std::string> sample_paths{
+        "Makefile",
+        "README.md",
+        "docs",
+        "docs/index.md",
+        "docs/api/README.md",
+        "src",
+        "src/main.cpp",
+        "src/main.py",
+        "src/docs/guide.md",
+        "src/api/handler.py",
+        "src/api/v1/handler.py",
+        "lib/src/util.py",
+        "tests/unit/Makefile",
+        "tests/unit/test_main.py",
+    };
+
+    /// Expect `matcher` to match exactly the sample paths that `pat` matches.
+    template <typename Matcher> void expect_same_matches(const Matcher& matcher, const char* pat)
+    {
+        const compiled_pattern compiled{pattern{pat}};
+        for (const auto& p : sample_paths)
+        {
+            EXPECT_EQ(matcher.matches(p, file_name(p)), compiled.matches(p))
+                << "pattern: " << pat << ", path: " << p;
+        }
+    }
+} // end anonymous namespace
+
+TEST(static_ruleset_test, file_name)
+{
+    static_assert(file_name("a/b/c.txt") == "c.txt");
+    static_assert(file_name("c.txt") == "c.txt");
+    EXPECT_EQ(file_name("a/b"), "b");
+};
+
+TEST(static_ruleset_test, matchers_agree_with_compiled_patterns)
+{
+    expect_same_matches(universal_matcher{}, "*");
+    expect_same_matches(suffix_matcher{".md"}, "*.md");
+    expect_same_matches(name_matcher{"*.?pp"}, "*.?pp");
+    expect_same_matches(name_matcher{"README*"}, "README*");
+    expect_same_matches(component_matcher{"Makefile", false}, "Makefile");
+    expect_same_matches(component_matcher{"docs", true}, "docs/");
+    expect_same_matches(prefix_matcher{"docs", true}, "/docs/");
+    expect_same_matches(prefix_matcher{"src/main.cpp", false}, "/src/main.cpp");
+    expect_same_matches(prefix_matcher{"src/api", false}, "src/api");
+    expect_same_matches(child_matcher{"src", "*"}, "/src/*");
+    expect_same_matches(child_matcher{"src", "*.py"}, "/src/*.py");
+    expect_same_matches(descendant_matcher{"src", "*.py"}, "/src/**/*.py");
+    expect_same_matches(
+        segments_matcher<3>{{{{static_segment_kind::ANY_DIRS, "**"},
+                              {static_segment_kind::STAR, "*"},
+                              {static_segment_kind::GLOB, "*.py"}}},
+                            false,
+                            false},
+        "**/*/*.py");
+    expect_same_matches(segments_matcher<3>{{{{static_segment_kind::LITERAL, "tests"},
+                                              {static_segment_kind::STAR, "*"},
+                                              {static_segment_kind::ANY_DIRS, "**"}}},
+                                            false,
+                                            true},
+                        "/tests/*/**");
+};
+
+TEST(static_ruleset_test, constexpr_matching)
+{
+    static_assert(suffix_matcher{".md"}.matches("docs/index.md", "index.md"));
+    static_assert(!suffix_matcher{".md"}.matches("docs/index.txt", "index.txt"));
+    static_assert(component_matcher{"docs", true}.matches("src/docs/a.md", "a.md"));
+    static_assert(!component_matcher{"docs", true}.matches("src/docs", "docs"));
+    static_assert(prefix_matcher{"src", true}.matches("src/a.cpp", "a.cpp"));
+    static_assert(!prefix_matcher{"src", true}.matches("srcs/a.cpp", "a.cpp"));
+    static_assert(descendant_matcher{"src", "*.py"}.matches("src/a/b.py", "b.py"));
+    static_assert(!child_matcher{"src", "*.py"}.matches("src/a/b.py", "b.py"));
+    static_assert(segments_matcher<2>{{{{static_segment_kind::ANY_DIRS, "**"},
+                                        {static_segment_kind::LITERAL, "a"}}},
+                                      false,
+                                      true}
+                      .matches("x/a/y", "y"));
+    SUCCEED();
+};
+
+} // end namespace 'co'
@@ -0,0 +1,91 @@
+#include <codeowners/statistics.hpp>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+namespace co
+{
+
+namespace
+{
+    ruleset sample_ruleset()
+    {
+        rule_source src{"", 0};
+        return ruleset{std::vector<annotated_rule>{
+            {src, {pattern{"*.hpp"}, {owner{"@alice"}, owner{"@bob"}}}},
+            {src, {pattern{"*.cpp"}, {owner{"@bob"}}}},
+            {src, {pattern{"*.txt"}, {}}}}};
+    }
+} // end anonymous namespace
+
+TEST(ownership_statistics_test, add)
+{
+    const ruleset rules = sample_ruleset();
+    ASSERT_EQ(rules.owners().to_vector(), (std::vector<std::string_view>{"@alice", "@bob"}));
+
+    ownership_statistics stats{rules};
+    stats.add(rules.find("a.hpp"), 10);
+    stats.add(rules.find("b.cpp"), 20);
+    stats.add(rules.find("c.txt"), 40);
+    stats.add(rules.find("d.md"), 80);
+
+    EXPECT_EQ(stats.owner_totals(0).files, 1);
+    EXPECT_EQ(stats.owner_totals(0).bytes, 10);
+    EXPECT_EQ(stats.owner_totals(1).files, 2);
+    EXPECT_EQ(stats.owner_totals(1).bytes, 30);
+    EXPECT_EQ(stats.unowned_totals().files, 2);
+    EXPECT_EQ(stats.unowned_totals().bytes, 120);
+    EXPECT_EQ(stats.overall_totals().files, 4);
+    EXPECT_EQ(stats.overall_totals().bytes, 150);
+};
+
+TEST(ownership_statistics_test, merge)
+{
+    const ruleset rules = sample_ruleset();
+    ownership_statistics stats1{rules};
+    ownership_statistics stats2{rules};
+    stats1.add(rules.find("a.hpp"), 1);
+    stats2.add(rules.find("a.hpp"), 2);
+    stats2.add(std::nullopt, 4);
+
+    stats1.merge(stats2);
+    EXPECT_EQ(stats1.owner_totals(0).files, 2);
+    EXPECT_EQ(stats1.owner_totals(0).bytes, 3);
+    EXPECT_EQ(stats1.unowned_totals().files, 1);
+    EXPECT_EQ(stats1.overall_totals().files, 3);
+};
+
+TEST(ownership_statistics_test, output)
+{
+    const ruleset rules = sample_ruleset();
+    ownership_statistics stats{rules};
+    stats.add(rules.find("a.cpp"), 5);
+    stats.add(rules.find("a.md"), 7);
+
+    std::ostringstream oss;
+    oss << stats;
+    EXPECT_EQ(oss.str(), "owner\tfiles\tbytes\n"
+                         "@bob\t1\t5\n"
+                         "@alice\t0\t0\n"
+                         "[NO_OWNER]\t1\t7\n"
+                         "[TOTAL]\t2\t12\n");
+};
+
+TEST(ownership_statistics_test, output_without_bytes)
+{
+    const ruleset rules = sample_ruleset();
+    ownership_statistics stats{rules, false};
+    stats.add(rules.find("a.cpp"));
+    stats.add(rules.find("a.md"));
+
+    std::ostringstream oss;
+    oss << stats;
+    EXPECT_EQ(oss.str(), "owner\tfiles\n"
+                         "@bob\t1\n"
+                         "@alice\t0\n"
+                         "[NO_OWNER]\t1\n"
+                         "[TOTAL]\t2\n");
+};
+
+} // end namespace 'co'
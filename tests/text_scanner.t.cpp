@@ -0,0 +1,91 @@
+#include <src/text_scanner.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cctype>
+#include <random>
+#include <string>
+
+namespace co
+{
+
+namespace
+{
+    const scan_kernel all_kernels[] = {scan_kernel::SCALAR, scan_kernel::SSE2, scan_kernel::AVX2};
+
+    template <typename Pred>
+    std::size_t find_reference(const std::string& s, std::size_t pos, Pred p)
+    {
+        while (pos < s.size() && !p(static_cast<unsigned char>(s[pos])))
+        {
+            ++pos;
+        }
+        return std::min(pos, s.size());
+    }
+} // end anonymous namespace
+
+TEST(text_scanner_test, default_kernel_is_supported)
+{
+    EXPECT_TRUE(is_supported(scan_kernel::SCALAR));
+    EXPECT_TRUE(is_supported(default_scan_kernel()));
+};
+
+TEST(text_scanner_test, short_text)
+{
+    for (auto kernel : all_kernels)
+    {
+        if (!is_supported(kernel))
+        {
+            continue;
+        }
+        SCOPED_TRACE(to_string(kernel));
+
+        text_scanner scanner{"ab c\n\td", kernel};
+        EXPECT_EQ(scanner.find_space(0), 2u);
+        EXPECT_EQ(scanner.find_newline(0), 4u);
+        EXPECT_EQ(scanner.find_non_space(4), 6u);
+        EXPECT_EQ(scanner.find_space(6), 7u);
+        EXPECT_EQ(scanner.find_newline(5), 7u);
+
+        text_scanner empty{"", kernel};
+        EXPECT_EQ(empty.find_non_space(0), 0u);
+    }
+};
+
+TEST(text_scanner_test, agrees_with_isspace)
+{
+    std::mt19937 rng{17};
+    const std::string alphabet = std::string{"ab#/* \t\n\v\f\r\x80\xff"} + '\0';
+    for (int iter = 0; iter < 200; ++iter)
+    {
+        std::string text(rng() % 300, ' ');
+        for (auto& c : text)
+        {
+            c = alphabet[rng() % alphabet.size()];
+        }
+
+        for (auto kernel : all_kernels)
+        {
+            if (!is_supported(kernel))
+            {
+                continue;
+            }
+            SCOPED_TRACE(to_string(kernel));
+
+            // Searches are not necessarily in increasing order of position.
+            text_scanner scanner{text, kernel};
+            for (std::size_t pos = 0; pos <= text.size(); pos += 1 + rng() % 7)
+            {
+                const std::size_t start = rng() % (text.size() + 1);
+                EXPECT_EQ(scanner.find_newline(start),
+                          find_reference(text, start, [](int c) { return c == '\n'; }));
+                EXPECT_EQ(scanner.find_space(pos),
+                          find_reference(text, pos, [](int c) { return std::isspace(c); }));
+                EXPECT_EQ(scanner.find_non_space(pos),
+                          find_reference(text, pos, [](int c) { return !std::isspace(c); }));
+            }
+        }
+    }
+};
+
+} // end namespace 'co'
@@ -0,0 +1,149 @@
+#include <codeowners/instrumentation.hpp>
+#include <codeowners/list_owners.hpp>
+#include <codeowners/output.hpp>
+#include <codeowners/trace.hpp>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <thread>
+
+namespace co
+{
+
+namespace
+{
+    /// Enables tracing, with no recorded events, for its lifetime.
+    struct enabled_tracer
+    {
+        enabled_tracer()
+        {
+            tracer::clear();
+            tracer::enable();
+        }
+        ~enabled_tracer()
+        {
+            tracer::enable(false);
+            tracer::clear();
+        }
+    };
+
+    std::string chrome_json()
+    {
+        std::ostringstream oss;
+        tracer::write_chrome_json(oss);
+        return oss.str();
+    }
+
+    bool contains(const std::string& s, const std::string& part)
+    {
+        return s.find(part) != std::string::npos;
+    }
+} // end anonymous namespace
+
+#if CODEOWNERS_INSTRUMENTATION
+
+TEST(trace_test, disabled_by_default)
+{
+    EXPECT_FALSE(tracer::enabled());
+    {
+        trace_span span{"span", "test"};
+        EXPECT_FALSE(span.active());
+    }
+    EXPECT_FALSE(contains(chrome_json(), "\"span\""));
+};
+
+TEST(trace_test, spans)
+{
+    enabled_tracer enabled;
+    {
+        trace_span span{"outer", "test"};
+        span.set_detail("a \"quoted\"\\path\n");
+        span.add_arg("count", 3);
+        phase_timer parse{phase::PARSE};
+        {
+            phase_timer nested{phase::PARSE};
+            phase_timer match{phase::MATCH};
+        }
+    }
+    std::thread{[] { trace_span span{"worker", "test"}; }}.join();
+
+    const std::string json = chrome_json();
+    EXPECT_EQ(json.rfind("{\"traceEvents\":[", 0), 0u);
+    EXPECT_TRUE(contains(json, "\"name\":\"outer\",\"cat\":\"test\",\"ph\":\"X\""));
+    EXPECT_TRUE(contains(json, "\"args\":{\"detail\":\"a \\\"quoted\\\"\\\\path\\u000a\","
+                               "\"count\":3}"));
+    EXPECT_TRUE(contains(json, "\"name\":\"worker\""));
+
+    // Only the outermost timer of a phase is traced, and matching is not traced.
+    const auto parse_span = json.find("\"name\":\"parse\"");
+    EXPECT_NE(parse_span, std::string::npos);
+    EXPECT_EQ(json.find("\"name\":\"parse\"", parse_span + 1), std::string::npos);
+    EXPECT_FALSE(contains(json, "\"name\":\"match\""));
+
+    // Each thread has its own track.
+    const auto outer_tid = json.find("\"tid\":", json.find("\"name\":\"outer\""));
+    const auto worker_tid = json.find("\"tid\":", json.find("\"name\":\"worker\""));
+    EXPECT_NE(json.substr(outer_tid, 8), json.substr(worker_tid, 8));
+
+    tracer::clear();
+    EXPECT_FALSE(contains(chrome_json(), "\"name\":\"outer\""));
+};
+
+TEST(trace_test, empty_flush)
+{
+    enabled_tracer enabled;
+    {
+        // Flushing with nothing buffered, explicitly or on destruction, writes no span.
+        output_writer writer{-1, output_format::TEXT};
+        writer.flush();
+    }
+    EXPECT_FALSE(contains(chrome_json(), "\"name\":\"flush\""));
+};
+
+TEST(trace_test, invalid_utf8_detail)
+{
+    enabled_tracer enabled;
+    {
+        // Well-formed UTF-8 is copied, and other bytes, as in some paths, are escaped.
+        trace_span span{"directory", "test"};
+        span.set_detail("caf\xc3\xa9/\xff\xc3");
+    }
+    EXPECT_TRUE(contains(chrome_json(), "\"detail\":\"caf\xc3\xa9/\\u00ff\\u00c3\""));
+};
+
+TEST(trace_test, directory_batches)
+{
+    temporary_directory_handle temp_dir;
+    fs::create_directories(temp_dir / "src/a");
+    for (const auto& file : {"README.md", "src/main.cpp", "src/a/b.cpp"})
+    {
+        ensure_exists(temp_dir / file);
+    }
+    rule_source src{"", 0};
+    const ruleset rset{std::vector<annotated_rule>{
+        {src, {pattern{"*.md"}, {owner{"@writers"}}}}}};
+
+    enabled_tracer enabled;
+    ruleset::cursor cursor{rset};
+    for_each_owned_file(cursor, temp_dir, temp_dir, {},
+                        [](const fs::directory_entry&, std::string_view,
+                           std::optional<ruleset::rule_id>) {});
+
+    const std::string json = chrome_json();
+    EXPECT_TRUE(contains(json, "\"name\":\"traversal\",\"cat\":\"phase\""));
+    EXPECT_TRUE(contains(json, "\"name\":\"directory\",\"cat\":\"traversal\""));
+    EXPECT_TRUE(contains(json, (temp_dir / "src/a").string() + "\",\"files\":1,\"matched\":1"));
+};
+
+#else
+
+TEST(trace_test, not_compiled)
+{
+    EXPECT_FALSE(tracer::enable());
+    EXPECT_FALSE(tracer::enabled());
+};
+
+#endif
+
+} // end namespace 'co'